@@ -17,8 +17,10 @@ writer = generator.writer
 toolchain = generator.toolchain
 
 resource_lib = generator.lib(module = 'resource', sources = [
-  'bundle.c', 'change.c', 'compile.c', 'compiled.c', 'event.c', 'import.c', 'local.c', 'platform.c', 'remote.c',
-  'resource.c', 'source.c', 'sourced.c', 'stream.c', 'version.c'])
+  'async.c', 'batch.c', 'bundle.c', 'cache.c', 'change.c', 'compile.c', 'compiled.c', 'digest.c',
+  'event.c', 'failure.c', 'hashcache.c', 'import.c', 'importmap.c', 'local.c', 'metrics.c',
+  'platform.c', 'queue.c', 'remote.c', 'resource.c', 'schedule.c', 'source.c', 'sourced.c',
+  'speculate.c', 'stream.c', 'tool.c', 'version.c', 'worker.c'])
 
 network_libs = []
 if target.is_windows():
@@ -38,7 +40,7 @@ if generator.is_subninja():
 includepaths = generator.test_includepaths()
 
 test_cases = [
-  'source'
+  'source', 'import'
 ]
 if toolchain.is_monolithic() or target.is_ios() or target.is_android() or target.is_tizen():
   #Build one fat binary with all test cases
@@ -0,0 +1,336 @@
+/* async.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+struct resource_async_t {
+	uuid_t uuid;
+	uint64_t platform;
+	bool dynamic;
+	int priority;
+	uint64_t sequence;
+	//! Index in queue heap, or -1 if not queued
+	size_t queue_index;
+	hash_t token;
+	atomic32_t ref;
+	atomic32_t state;
+	atomic32_t cancel;
+	stream_t* stream;
+	resource_async_fn callback;
+	void* userdata;
+};
+
+static mutex_t* _resource_async_lock;
+static resource_async_t** _resource_async_queue;
+static uint64_t _resource_async_sequence;
+static atomic64_t _resource_async_token;
+static semaphore_t _resource_async_work;
+static thread_t* _resource_async_threads;
+static atomic32_t _resource_async_terminate;
+
+int
+resource_async_initialize(void) {
+	_resource_async_lock = mutex_allocate(STRING_CONST("resource-async"));
+	semaphore_initialize(&_resource_async_work, 0);
+	atomic_store32(&_resource_async_terminate, 0, memory_order_release);
+	return 0;
+}
+
+static void
+resource_async_deallocate(resource_async_t* request) {
+	if (atomic_decr32(&request->ref, memory_order_acq_rel) > 0)
+		return;
+	if (request->stream)
+		stream_deallocate(request->stream);
+	memory_deallocate(request);
+}
+
+static void
+resource_async_notify(resource_async_t* request) {
+	if (request->callback)
+		request->callback(request, request->userdata);
+	else
+		resource_event_post(RESOURCEEVENT_OPEN, request->uuid, request->platform, request->token);
+}
+
+void
+resource_async_finalize(void) {
+	size_t ithread, tsize;
+	atomic_store32(&_resource_async_terminate, 1, memory_order_release);
+	for (ithread = 0, tsize = array_size(_resource_async_threads); ithread < tsize; ++ithread)
+		semaphore_post(&_resource_async_work);
+	for (ithread = 0, tsize = array_size(_resource_async_threads); ithread < tsize; ++ithread) {
+		thread_join(_resource_async_threads + ithread);
+		thread_finalize(_resource_async_threads + ithread);
+	}
+	array_deallocate(_resource_async_threads);
+
+	// Requests never processed are completed as cancelled so callers waiting on a
+	// callback or event are not left hanging
+	for (size_t ireq = 0, rsize = array_size(_resource_async_queue); ireq < rsize; ++ireq) {
+		resource_async_t* request = _resource_async_queue[ireq];
+		request->queue_index = (size_t)-1;
+		atomic_store32(&request->state, RESOURCEASYNC_CANCELLED, memory_order_release);
+		resource_async_notify(request);
+		resource_async_deallocate(request);
+	}
+	array_deallocate(_resource_async_queue);
+
+	semaphore_finalize(&_resource_async_work);
+	mutex_deallocate(_resource_async_lock);
+
+	_resource_async_threads = nullptr;
+	_resource_async_queue = nullptr;
+	_resource_async_lock = nullptr;
+}
+
+static bool
+resource_async_before(const resource_async_t* lhs, const resource_async_t* rhs) {
+	if (lhs->priority != rhs->priority)
+		return lhs->priority > rhs->priority;
+	return lhs->sequence < rhs->sequence;
+}
+
+static void
+resource_async_queue_swap(size_t first, size_t second) {
+	resource_async_t* request = _resource_async_queue[first];
+	_resource_async_queue[first] = _resource_async_queue[second];
+	_resource_async_queue[second] = request;
+	_resource_async_queue[first]->queue_index = first;
+	_resource_async_queue[second]->queue_index = second;
+}
+
+static void
+resource_async_queue_up(size_t index) {
+	while (index) {
+		size_t parent = (index - 1) / 2;
+		if (!resource_async_before(_resource_async_queue[index], _resource_async_queue[parent]))
+			break;
+		resource_async_queue_swap(index, parent);
+		index = parent;
+	}
+}
+
+static void
+resource_async_queue_down(size_t index) {
+	size_t size = array_size(_resource_async_queue);
+	while (true) {
+		size_t first = index;
+		size_t left = (index * 2) + 1;
+		size_t right = left + 1;
+		if ((left < size) &&
+		    resource_async_before(_resource_async_queue[left], _resource_async_queue[first]))
+			first = left;
+		if ((right < size) &&
+		    resource_async_before(_resource_async_queue[right], _resource_async_queue[first]))
+			first = right;
+		if (first == index)
+			break;
+		resource_async_queue_swap(index, first);
+		index = first;
+	}
+}
+
+static void
+resource_async_queue_remove(size_t index) {
+	size_t last = array_size(_resource_async_queue) - 1;
+	_resource_async_queue[index]->queue_index = (size_t)-1;
+	if (index != last) {
+		_resource_async_queue[index] = _resource_async_queue[last];
+		_resource_async_queue[index]->queue_index = index;
+		array_pop(_resource_async_queue);
+		resource_async_queue_down(index);
+		resource_async_queue_up(index);
+	} else {
+		array_pop(_resource_async_queue);
+	}
+}
+
+static void*
+resource_async_thread(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	while (true) {
+		semaphore_wait(&_resource_async_work);
+		if (atomic_load32(&_resource_async_terminate, memory_order_acquire))
+			break;
+
+		resource_async_t* request = nullptr;
+		mutex_lock(_resource_async_lock);
+		if (array_size(_resource_async_queue)) {
+			request = _resource_async_queue[0];
+			resource_async_queue_remove(0);
+			atomic_store32(&request->state, RESOURCEASYNC_RUNNING, memory_order_release);
+		}
+		mutex_unlock(_resource_async_lock);
+
+		// Cancelled requests are removed from the queue without consuming the work count
+		if (!request)
+			continue;
+
+		stream_t* stream = request->dynamic ?
+		                       resource_stream_open_dynamic(request->uuid, request->platform) :
+		                       resource_stream_open_static(request->uuid, request->platform);
+
+		resource_async_state state = stream ? RESOURCEASYNC_COMPLETED : RESOURCEASYNC_FAILED;
+		mutex_lock(_resource_async_lock);
+		if (atomic_load32(&request->cancel, memory_order_acquire))
+			state = RESOURCEASYNC_CANCELLED;
+		else
+			request->stream = stream;
+		atomic_store32(&request->state, state, memory_order_release);
+		mutex_unlock(_resource_async_lock);
+
+		if ((state == RESOURCEASYNC_CANCELLED) && stream)
+			stream_deallocate(stream);
+
+		resource_async_notify(request);
+		resource_async_deallocate(request);
+	}
+	return nullptr;
+}
+
+static resource_async_t*
+resource_async_open(const uuid_t uuid, uint64_t platform, bool dynamic, int priority,
+                    resource_async_fn callback, void* userdata) {
+	resource_async_t* request =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_async_t), 0, MEMORY_PERSISTENT);
+	request->uuid = uuid;
+	request->platform = platform;
+	request->dynamic = dynamic;
+	request->priority = priority;
+	request->token = (hash_t)atomic_incr64(&_resource_async_token, memory_order_acq_rel);
+	request->stream = nullptr;
+	request->callback = callback;
+	request->userdata = userdata;
+	// One reference for the caller handle and one for the queue
+	atomic_store32(&request->ref, 2, memory_order_release);
+	atomic_store32(&request->state, RESOURCEASYNC_PENDING, memory_order_release);
+	atomic_store32(&request->cancel, 0, memory_order_release);
+
+	mutex_lock(_resource_async_lock);
+	if (!_resource_async_threads) {
+		// Threads are started on first use
+		size_t num_threads = resource_module_config().async_thread_count;
+		if (!num_threads)
+			num_threads = system_hardware_threads() / 2;
+		if (!num_threads)
+			num_threads = 1;
+		array_resize(_resource_async_threads, num_threads);
+		for (size_t ithread = 0; ithread < num_threads; ++ithread) {
+			thread_initialize(_resource_async_threads + ithread, resource_async_thread, nullptr,
+			                  STRING_CONST("resource-async"), THREAD_PRIORITY_NORMAL, 0);
+			thread_start(_resource_async_threads + ithread);
+		}
+	}
+	request->sequence = _resource_async_sequence++;
+	request->queue_index = array_size(_resource_async_queue);
+	array_push(_resource_async_queue, request);
+	resource_async_queue_up(request->queue_index);
+	mutex_unlock(_resource_async_lock);
+
+	semaphore_post(&_resource_async_work);
+
+	return request;
+}
+
+resource_async_t*
+resource_async_open_static(const uuid_t uuid, uint64_t platform, int priority,
+                           resource_async_fn callback, void* userdata) {
+	return resource_async_open(uuid, platform, false, priority, callback, userdata);
+}
+
+resource_async_t*
+resource_async_open_dynamic(const uuid_t uuid, uint64_t platform, int priority,
+                            resource_async_fn callback, void* userdata) {
+	return resource_async_open(uuid, platform, true, priority, callback, userdata);
+}
+
+void
+resource_async_set_priority(resource_async_t* request, int priority) {
+	mutex_lock(_resource_async_lock);
+	int previous = request->priority;
+	request->priority = priority;
+	bool running = false;
+	if (request->queue_index != (size_t)-1) {
+		if (priority > previous)
+			resource_async_queue_up(request->queue_index);
+		else
+			resource_async_queue_down(request->queue_index);
+	} else {
+		running = (atomic_load32(&request->state, memory_order_acquire) == RESOURCEASYNC_RUNNING);
+	}
+	mutex_unlock(_resource_async_lock);
+
+	// A running request waits on the compile queue, a raise means the caller needs the
+	// resource ahead of other stream opens
+	if (running && (priority > previous))
+		resource_compile_queue_raise(request->uuid, request->platform,
+		                             RESOURCECOMPILE_PRIORITY_URGENT);
+}
+
+bool
+resource_async_cancel(resource_async_t* request) {
+	bool cancelled = false;
+	bool dequeued = false;
+	mutex_lock(_resource_async_lock);
+	if (request->queue_index != (size_t)-1) {
+		resource_async_queue_remove(request->queue_index);
+		atomic_store32(&request->state, RESOURCEASYNC_CANCELLED, memory_order_release);
+		cancelled = dequeued = true;
+	} else if (atomic_load32(&request->state, memory_order_acquire) == RESOURCEASYNC_RUNNING) {
+		atomic_store32(&request->cancel, 1, memory_order_release);
+		cancelled = true;
+	}
+	mutex_unlock(_resource_async_lock);
+	if (dequeued) {
+		resource_async_deallocate(request);
+	} else if (cancelled) {
+		// Stop any tool compiling the resource for the running open
+		resource_compile_cancel(request->uuid, request->platform);
+	}
+	return cancelled;
+}
+
+resource_async_state
+resource_async_state_get(resource_async_t* request) {
+	return (resource_async_state)atomic_load32(&request->state, memory_order_acquire);
+}
+
+hash_t
+resource_async_token(resource_async_t* request) {
+	return request->token;
+}
+
+stream_t*
+resource_async_stream(resource_async_t* request) {
+	if (atomic_load32(&request->state, memory_order_acquire) != RESOURCEASYNC_COMPLETED)
+		return nullptr;
+	stream_t* stream = request->stream;
+	request->stream = nullptr;
+	return stream;
+}
+
+void
+resource_async_release(resource_async_t* request) {
+	if (request)
+		resource_async_deallocate(request);
+}
@@ -0,0 +1,92 @@
+/* async.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Queue an asynchronous open of the static stream of a resource. Autoimport,
+compilation of the resource and its dependencies and the stream open are done on
+a background thread. On completion the callback is called on the background thread,
+or if no callback is given a RESOURCEEVENT_OPEN event is posted with the request
+token. The returned handle must be released with resource_async_release.
+\param uuid Resource UUID
+\param platform Resource platform
+\param priority Request priority, higher priority requests are processed first
+\param callback Completion callback, can be null
+\param userdata Data passed to completion callback
+\return Request handle */
+RESOURCE_API resource_async_t*
+resource_async_open_static(const uuid_t uuid, uint64_t platform, int priority,
+                           resource_async_fn callback, void* userdata);
+
+/*! Queue an asynchronous open of the dynamic stream of a resource, see
+resource_async_open_static
+\param uuid Resource UUID
+\param platform Resource platform
+\param priority Request priority, higher priority requests are processed first
+\param callback Completion callback, can be null
+\param userdata Data passed to completion callback
+\return Request handle */
+RESOURCE_API resource_async_t*
+resource_async_open_dynamic(const uuid_t uuid, uint64_t platform, int priority,
+                            resource_async_fn callback, void* userdata);
+
+/*! Change priority of a request, for example raising it when the resource becomes
+urgent. Raising a running request raises the compile of the resource in the compile
+queue to urgent priority.
+\param request Request handle
+\param priority New priority */
+RESOURCE_API void
+resource_async_set_priority(resource_async_t* request, int priority);
+
+/*! Cancel a request. A queued request is removed from the queue, a running
+request cancels any tool compiling the resource and has its result discarded once
+the current step finishes. Requests still queued when the module is finalized are
+completed as cancelled through the callback or open event.
+\param request Request handle
+\return true if request was cancelled, false if already completed */
+RESOURCE_API bool
+resource_async_cancel(resource_async_t* request);
+
+/*! Get current request state
+\param request Request handle
+\return Request state */
+RESOURCE_API resource_async_state
+resource_async_state_get(resource_async_t* request);
+
+/*! Get request token, matching the token of the completion event
+\param request Request handle
+\return Token */
+RESOURCE_API hash_t
+resource_async_token(resource_async_t* request);
+
+/*! Take ownership of the opened stream of a completed request. The stream must be
+deallocated by the caller, later calls return null.
+\param request Request handle
+\return Stream, null if request did not complete or stream was already taken */
+RESOURCE_API stream_t*
+resource_async_stream(resource_async_t* request);
+
+/*! Release a request handle. A stream not taken from the request is deallocated.
+Releasing a queued or running request does not cancel it.
+\param request Request handle */
+RESOURCE_API void
+resource_async_release(resource_async_t* request);
@@ -0,0 +1,153 @@
+/* batch.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE && RESOURCE_ENABLE_LOCAL_CACHE
+
+static uuid_t*
+resource_build_enumerate(void) {
+	uuid_t* uuids = nullptr;
+	string_const_t source_path = resource_source_path();
+	if (!source_path.length)
+		return uuids;
+
+	// Source files are named by UUID, other files share the UUID as prefix with an extension
+	string_t* files = fs_matching_files(STRING_ARGS(source_path), STRING_CONST("^.*$"), true);
+	for (size_t ifile = 0, fsize = array_size(files); ifile < fsize; ++ifile) {
+		string_const_t name = path_file_name(STRING_ARGS(files[ifile]));
+		if ((name.length != 36) || (string_find(STRING_ARGS(name), '.', 0) != STRING_NPOS))
+			continue;
+		uuid_t uuid = string_to_uuid(STRING_ARGS(name));
+		if (!uuid_is_null(uuid))
+			array_push(uuids, uuid);
+	}
+	string_array_deallocate(files);
+	return uuids;
+}
+
+static void
+resource_build_slowest(resource_build_result_t* result, const resource_schedule_node_t* node,
+                       bool success) {
+	// Keep slowest compiles sorted by insertion, slowest first
+	deltatime_t time = time_ticks_to_seconds(time_diff(node->checked, node->end));
+	size_t islow = result->num_slowest;
+	while (islow && (result->slowest[islow - 1].time < time))
+		--islow;
+	if (islow >= RESOURCE_BUILD_SLOWEST)
+		return;
+	size_t ilast = (result->num_slowest < RESOURCE_BUILD_SLOWEST) ? result->num_slowest++ :
+	                                                                RESOURCE_BUILD_SLOWEST - 1;
+	for (; ilast > islow; --ilast)
+		result->slowest[ilast] = result->slowest[ilast - 1];
+	result->slowest[islow].uuid = node->uuid;
+	result->slowest[islow].platform = node->platform;
+	result->slowest[islow].time = time;
+	result->slowest[islow].success = success;
+}
+
+resource_build_result_t
+resource_build(const uint64_t* platforms, size_t num_platforms, size_t num_threads) {
+	resource_build_result_t result;
+	memset(&result, 0, sizeof(result));
+
+	const uint64_t default_platform = 0;
+	if (!num_platforms) {
+		platforms = &default_platform;
+		num_platforms = 1;
+	}
+
+	tick_t start = time_current();
+	uuid_t* uuids = resource_build_enumerate();
+	result.enumerate_time = time_elapsed(start);
+	result.resources = array_size(uuids);
+
+	// Resources are checked and compiled by the dependency graph scheduler, a resource is
+	// only processed once all its dependencies are, so shared dependencies are checked and
+	// compiled exactly once and never concurrently
+	resource_schedule_t* schedule = resource_schedule_allocate(num_threads);
+	for (size_t iuuid = 0; iuuid < result.resources; ++iuuid) {
+		for (size_t iplat = 0; iplat < num_platforms; ++iplat)
+			resource_schedule_add(schedule, uuids[iuuid], platforms[iplat]);
+	}
+	array_deallocate(uuids);
+
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Build: checking %" PRIsize " resources for %" PRIsize " platforms"),
+	          result.resources, num_platforms);
+
+	resource_schedule_run(schedule);
+
+	size_t num_nodes = 0;
+	const resource_schedule_node_t* nodes = resource_schedule_nodes(schedule, &num_nodes);
+	result.targets = num_nodes;
+	tick_t check_ticks = 0;
+	tick_t compile_ticks = 0;
+	for (size_t inode = 0; inode < num_nodes; ++inode) {
+		const resource_schedule_node_t* node = nodes + inode;
+		check_ticks += time_diff(node->start, node->checked);
+		if (node->state == RESOURCESCHEDULE_UPTODATE) {
+			++result.up_to_date;
+			continue;
+		}
+		if (node->state == RESOURCESCHEDULE_COMPILED) {
+			++result.compiled;
+		} else {
+			++result.failed;
+			string_const_t uuidstr = string_from_uuid_static(node->uuid);
+			if (node->state == RESOURCESCHEDULE_FAILED)
+				log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+				          STRING_CONST("Build: failed to compile %.*s (platform 0x%" PRIx64 ")"),
+				          STRING_FORMAT(uuidstr), node->platform);
+			else if (node->state == RESOURCESCHEDULE_SKIPPED)
+				log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+				          STRING_CONST("Build: skipped %.*s (platform 0x%" PRIx64
+				                       "), dependency failed"),
+				          STRING_FORMAT(uuidstr), node->platform);
+		}
+		if ((node->state == RESOURCESCHEDULE_COMPILED) ||
+		    (node->state == RESOURCESCHEDULE_FAILED)) {
+			compile_ticks += time_diff(node->checked, node->end);
+			resource_build_slowest(&result, node, node->state == RESOURCESCHEDULE_COMPILED);
+		}
+	}
+	result.check_time = time_ticks_to_seconds(check_ticks);
+	result.compile_time = time_ticks_to_seconds(compile_ticks);
+
+	resource_schedule_deallocate(schedule);
+
+	return result;
+}
+
+#else
+
+resource_build_result_t
+resource_build(const uint64_t* platforms, size_t num_platforms, size_t num_threads) {
+	FOUNDATION_UNUSED(platforms);
+	FOUNDATION_UNUSED(num_platforms);
+	FOUNDATION_UNUSED(num_threads);
+	resource_build_result_t result;
+	memset(&result, 0, sizeof(result));
+	return result;
+}
+
+#endif
@@ -0,0 +1,34 @@
+/* batch.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Build all resources in the local source path for the given platforms. Resources are
+checked and compiled in dependency order by a compile schedule, independent resources
+in parallel on the build threads. Resources depending on a failed resource are skipped.
+Failed and skipped compiles are logged as warnings and counted as failed.
+\param platforms Platforms to build, null or empty for the default platform (0)
+\param num_platforms Number of platforms
+\param num_threads Number of build threads, 0 for number of hardware threads
+\return Build result */
+RESOURCE_API resource_build_result_t
+resource_build(const uint64_t* platforms, size_t num_platforms, size_t num_threads);
@@ -0,0 +1,487 @@
+/* cache.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+#if FOUNDATION_PLATFORM_WINDOWS
+#include <foundation/windows.h>
+#elif FOUNDATION_PLATFORM_POSIX
+#include <foundation/posix.h>
+#endif
+#if FOUNDATION_PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
+
+#include <stdlib.h>
+
+#define RESOURCE_CACHE_DEFAULT_LIMIT (4ULL * 1024ULL * 1024ULL * 1024ULL)
+//! Temporary files older than this in milliseconds are left from interrupted stores
+#define RESOURCE_CACHE_TEMPORARY_EXPIRY (60ULL * 60ULL * 1000ULL)
+
+static string_t _resource_cache_path;
+static mutex_t* _resource_cache_lock;
+static bool _resource_cache_size_valid;
+static atomic64_t _resource_cache_hits;
+static atomic64_t _resource_cache_misses;
+static atomic64_t _resource_cache_stores;
+static atomic64_t _resource_cache_evictions;
+static atomic64_t _resource_cache_size;
+
+int
+resource_cache_initialize(void) {
+	_resource_cache_lock = mutex_allocate(STRING_CONST("resource-cache"));
+	return 0;
+}
+
+void
+resource_cache_finalize(void) {
+	uint64_t hits = (uint64_t)atomic_load64(&_resource_cache_hits, memory_order_acquire);
+	uint64_t misses = (uint64_t)atomic_load64(&_resource_cache_misses, memory_order_acquire);
+	if (hits + misses) {
+		log_infof(HASH_RESOURCE,
+		          STRING_CONST("Compile cache: %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate)"),
+		          hits, misses, (double)(hits * 100) / (double)(hits + misses));
+	}
+
+	string_deallocate(_resource_cache_path.str);
+	mutex_deallocate(_resource_cache_lock);
+
+	_resource_cache_path = string(nullptr, 0);
+	_resource_cache_lock = nullptr;
+	_resource_cache_size_valid = false;
+}
+
+void
+resource_cache_set_path(const char* path, size_t length) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
+	if (pathstr.length)
+		pathstr = path_absolute(STRING_ARGS(pathstr), sizeof(buffer));
+
+	mutex_lock(_resource_cache_lock);
+	string_deallocate(_resource_cache_path.str);
+	_resource_cache_path = pathstr.length ? string_clone(STRING_ARGS(pathstr)) : string(nullptr, 0);
+	_resource_cache_size_valid = false;
+	mutex_unlock(_resource_cache_lock);
+
+	if (pathstr.length)
+		fs_make_directory(STRING_ARGS(pathstr));
+}
+
+string_const_t
+resource_cache_path(void) {
+	return string_to_const(_resource_cache_path);
+}
+
+resource_cache_statistics_t
+resource_cache_statistics(void) {
+	resource_cache_statistics_t statistics;
+	statistics.hits = (uint64_t)atomic_load64(&_resource_cache_hits, memory_order_acquire);
+	statistics.misses = (uint64_t)atomic_load64(&_resource_cache_misses, memory_order_acquire);
+	statistics.stores = (uint64_t)atomic_load64(&_resource_cache_stores, memory_order_acquire);
+	statistics.evictions = (uint64_t)atomic_load64(&_resource_cache_evictions, memory_order_acquire);
+	statistics.size = (uint64_t)atomic_load64(&_resource_cache_size, memory_order_acquire);
+	return statistics;
+}
+
+#if (RESOURCE_ENABLE_LOCAL_SOURCE || RESOURCE_ENABLE_REMOTE_SOURCED) && RESOURCE_ENABLE_LOCAL_CACHE
+
+typedef struct resource_cache_key_t resource_cache_key_t;
+typedef struct resource_cache_entry_t resource_cache_entry_t;
+
+struct resource_cache_key_t {
+	hash_t fingerprint;
+	uint64_t platform;
+	uint256_t source_hash;
+};
+
+/* Each entry is the static part named by a hash of the key, an optional dynamic part with
+   suffix .blob and the full key with suffix .key. The key part is compared on fetch to catch
+   collisions of the key hash, and its modification time is the last use of the entry since
+   the static and dynamic parts may be hard linked with local outputs */
+
+struct resource_cache_entry_t {
+	tick_t last_used;
+	uint64_t size;
+	size_t file;
+};
+
+static uint64_t
+resource_cache_limit(void) {
+	uint64_t limit = resource_module_config().compile_cache_limit;
+	return limit ? limit : RESOURCE_CACHE_DEFAULT_LIMIT;
+}
+
+static resource_cache_key_t
+resource_cache_make_key(hash_t fingerprint, uint64_t platform, const uint256_t source_hash) {
+	resource_cache_key_t key;
+	memset(&key, 0, sizeof(key));
+	key.fingerprint = fingerprint;
+	key.platform = platform;
+	key.source_hash = source_hash;
+	return key;
+}
+
+//! Copy cache path under lock, empty if no cache is configured
+static string_t
+resource_cache_base_path(char* buffer, size_t capacity) {
+	mutex_lock(_resource_cache_lock);
+	string_t path = string_copy(buffer, capacity, STRING_ARGS(_resource_cache_path));
+	mutex_unlock(_resource_cache_lock);
+	return path;
+}
+
+static string_t
+resource_cache_make_path(char* buffer, size_t capacity, const string_t basepath,
+                         const resource_cache_key_t* key, const char* suffix,
+                         size_t suffix_length) {
+	//Spread entries over subdirectories by first byte of key
+	string_const_t keystr = string_from_uint_static(hash(key, sizeof(*key)), true, 16, '0');
+	return string_format(buffer, capacity, STRING_CONST("%.*s/%.2s/%.*s%.*s"),
+	                     STRING_FORMAT(basepath), keystr.str, STRING_FORMAT(keystr),
+	                     (int)suffix_length, suffix);
+}
+
+static bool
+resource_cache_link(const string_t source, const string_t target) {
+	string_const_t dir = path_directory_name(STRING_ARGS(target));
+	fs_make_directory(STRING_ARGS(dir));
+	if (fs_is_file(STRING_ARGS(target)))
+		fs_remove_file(STRING_ARGS(target));
+
+	//Prefer a hard link, then a copy-on-write clone, then a plain copy
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (CreateHardLinkA(target.str, source.str, nullptr))
+		return true;
+#elif FOUNDATION_PLATFORM_POSIX
+	if (link(source.str, target.str) == 0)
+		return true;
+#endif
+#if FOUNDATION_PLATFORM_LINUX
+	int fdsource = open(source.str, O_RDONLY);
+	if (fdsource >= 0) {
+		int fdtarget = open(target.str, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		int result = -1;
+		if (fdtarget >= 0) {
+			result = ioctl(fdtarget, FICLONE, fdsource);
+			close(fdtarget);
+		}
+		close(fdsource);
+		if (result == 0)
+			return true;
+		if (fdtarget >= 0)
+			fs_remove_file(STRING_ARGS(target));
+	}
+#endif
+	return fs_copy_file(STRING_ARGS(source), STRING_ARGS(target));
+}
+
+static bool
+resource_cache_insert(const string_t source, const string_t target) {
+	char tempbuf[BUILD_MAX_PATHLEN];
+	string_t temppath = string_format(tempbuf, sizeof(tempbuf), STRING_CONST("%.*s.%" PRIx64 ".tmp"),
+	                                  STRING_FORMAT(target), random64());
+	//Link into place atomically so concurrent readers never see partial entries
+	if (!resource_cache_link(source, temppath))
+		return false;
+	if (fs_is_file(STRING_ARGS(target)))
+		fs_remove_file(STRING_ARGS(target));
+	if (!fs_move_file(STRING_ARGS(temppath), STRING_ARGS(target))) {
+		fs_remove_file(STRING_ARGS(temppath));
+		return false;
+	}
+	return true;
+}
+
+static bool
+resource_cache_key_matches(const char* path, size_t length, const resource_cache_key_t* key) {
+	resource_cache_key_t stored;
+	stream_t* stream = stream_open(path, length, STREAM_IN | STREAM_BINARY);
+	if (!stream)
+		return false;
+	bool read = (stream_read(stream, &stored, sizeof(stored)) == sizeof(stored));
+	stream_deallocate(stream);
+	return read && (stored.fingerprint == key->fingerprint) &&
+	       (stored.platform == key->platform) &&
+	       uint256_equal(stored.source_hash, key->source_hash);
+}
+
+static bool
+resource_cache_write_key(const string_t target, const resource_cache_key_t* key) {
+	char tempbuf[BUILD_MAX_PATHLEN];
+	string_t temppath = string_format(tempbuf, sizeof(tempbuf), STRING_CONST("%.*s.%" PRIx64 ".tmp"),
+	                                  STRING_FORMAT(target), random64());
+	string_const_t dir = path_directory_name(STRING_ARGS(target));
+	fs_make_directory(STRING_ARGS(dir));
+	stream_t* stream =
+	    stream_open(STRING_ARGS(temppath), STREAM_OUT | STREAM_BINARY | STREAM_CREATE);
+	if (!stream)
+		return false;
+	bool written = (stream_write(stream, key, sizeof(*key)) == sizeof(*key));
+	stream_deallocate(stream);
+	if (fs_is_file(STRING_ARGS(target)))
+		fs_remove_file(STRING_ARGS(target));
+	if (!written || !fs_move_file(STRING_ARGS(temppath), STRING_ARGS(target))) {
+		fs_remove_file(STRING_ARGS(temppath));
+		return false;
+	}
+	return true;
+}
+
+static bool
+resource_cache_header_matches(const char* path, size_t length, const uint256_t source_hash) {
+	stream_t* stream = stream_open(path, length, STREAM_IN | STREAM_BINARY);
+	if (!stream)
+		return false;
+	resource_header_t header = resource_stream_read_header(stream);
+	stream_deallocate(stream);
+	return uint256_equal(header.source_hash, source_hash);
+}
+
+bool
+resource_cache_fetch(hash_t fingerprint, const uuid_t uuid, uint64_t platform,
+                     const uint256_t source_hash) {
+	char basebuf[BUILD_MAX_PATHLEN];
+	char cachebuf[BUILD_MAX_PATHLEN];
+	char keybuf[BUILD_MAX_PATHLEN];
+	char localbuf[BUILD_MAX_PATHLEN];
+
+	string_t basepath = resource_cache_base_path(basebuf, sizeof(basebuf));
+	if (!basepath.length || uint256_is_null(source_hash))
+		return false;
+
+	resource_cache_key_t key = resource_cache_make_key(fingerprint, platform, source_hash);
+	string_t keypath =
+	    resource_cache_make_path(keybuf, sizeof(keybuf), basepath, &key, STRING_CONST(".key"));
+	string_t cachepath = resource_cache_make_path(cachebuf, sizeof(cachebuf), basepath, &key, 0, 0);
+	string_t localpath =
+	    resource_local_make_path(localbuf, sizeof(localbuf), uuid, platform, 0, 0);
+	if (!localpath.length || !resource_cache_key_matches(STRING_ARGS(keypath), &key) ||
+	    !resource_cache_header_matches(STRING_ARGS(cachepath), source_hash)) {
+		atomic_incr64(&_resource_cache_misses, memory_order_relaxed);
+		return false;
+	}
+
+	//Use time is tracked on the key part, touching a part would also touch linked outputs
+	bool success = resource_cache_link(cachepath, localpath);
+	if (success)
+		fs_touch(STRING_ARGS(keypath));
+
+	cachepath = resource_cache_make_path(cachebuf, sizeof(cachebuf), basepath, &key,
+	                                     STRING_CONST(".blob"));
+	localpath =
+	    resource_local_make_path(localbuf, sizeof(localbuf), uuid, platform, STRING_CONST(".blob"));
+	if (fs_is_file(STRING_ARGS(cachepath)))
+		success = success && resource_cache_link(cachepath, localpath);
+	else if (fs_is_file(STRING_ARGS(localpath)))
+		fs_remove_file(STRING_ARGS(localpath));
+
+	string_const_t uuidstr = string_from_uuid_static(uuid);
+	if (success) {
+		atomic_incr64(&_resource_cache_hits, memory_order_relaxed);
+		log_debugf(HASH_RESOURCE, STRING_CONST("Compile cache hit: %.*s (platform 0x%" PRIx64 ")"),
+		           STRING_FORMAT(uuidstr), platform);
+	} else {
+		atomic_incr64(&_resource_cache_misses, memory_order_relaxed);
+		log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+		          STRING_CONST("Unable to materialize cached resource: %.*s (platform 0x%" PRIx64 ")"),
+		          STRING_FORMAT(uuidstr), platform);
+	}
+
+	return success;
+}
+
+bool
+resource_cache_store(hash_t fingerprint, const uuid_t uuid, uint64_t platform,
+                     const uint256_t source_hash) {
+	char basebuf[BUILD_MAX_PATHLEN];
+	char cachebuf[BUILD_MAX_PATHLEN];
+	char localbuf[BUILD_MAX_PATHLEN];
+
+	string_t basepath = resource_cache_base_path(basebuf, sizeof(basebuf));
+	if (!basepath.length || uint256_is_null(source_hash))
+		return false;
+
+	string_t localpath =
+	    resource_local_find_path(localbuf, sizeof(localbuf), uuid, platform, 0, 0);
+	if (!localpath.length || !resource_cache_header_matches(STRING_ARGS(localpath), source_hash))
+		return false;
+
+	uint64_t size = fs_size(STRING_ARGS(localpath));
+
+	//Store key and dynamic part first, entry is valid once static part is in place
+	resource_cache_key_t key = resource_cache_make_key(fingerprint, platform, source_hash);
+	string_t cachepath = resource_cache_make_path(cachebuf, sizeof(cachebuf), basepath, &key,
+	                                              STRING_CONST(".key"));
+	if (!resource_cache_write_key(cachepath, &key))
+		return false;
+	size += sizeof(key);
+
+	string_t blobpath = resource_local_find_path(localbuf, sizeof(localbuf), uuid, platform,
+	                                             STRING_CONST(".blob"));
+	cachepath = resource_cache_make_path(cachebuf, sizeof(cachebuf), basepath, &key,
+	                                     STRING_CONST(".blob"));
+	if (blobpath.length) {
+		if (!resource_cache_insert(blobpath, cachepath))
+			return false;
+		size += fs_size(STRING_ARGS(blobpath));
+	} else if (fs_is_file(STRING_ARGS(cachepath))) {
+		fs_remove_file(STRING_ARGS(cachepath));
+	}
+
+	localpath = resource_local_find_path(localbuf, sizeof(localbuf), uuid, platform, 0, 0);
+	cachepath = resource_cache_make_path(cachebuf, sizeof(cachebuf), basepath, &key, 0, 0);
+	if (!resource_cache_insert(localpath, cachepath))
+		return false;
+
+	atomic_incr64(&_resource_cache_stores, memory_order_relaxed);
+	uint64_t limit = resource_cache_limit();
+	uint64_t total = (uint64_t)atomic_add64(&_resource_cache_size, (int64_t)size,
+	                                        memory_order_acq_rel);
+	if (!_resource_cache_size_valid || (total > limit))
+		resource_cache_evict(limit);
+
+	return true;
+}
+
+static int
+resource_cache_entry_compare(const void* first, const void* second) {
+	const resource_cache_entry_t* lhs = first;
+	const resource_cache_entry_t* rhs = second;
+	if (lhs->last_used < rhs->last_used)
+		return -1;
+	return (lhs->last_used > rhs->last_used) ? 1 : 0;
+}
+
+void
+resource_cache_evict(uint64_t limit) {
+	char buffer[BUILD_MAX_PATHLEN];
+	resource_cache_entry_t* entries = nullptr;
+	uint64_t total = 0;
+	uint64_t evicted = 0;
+
+	mutex_lock(_resource_cache_lock);
+	if (!_resource_cache_path.length) {
+		mutex_unlock(_resource_cache_lock);
+		return;
+	}
+
+	tick_t now = time_system();
+	string_t* files = fs_matching_files(STRING_ARGS(_resource_cache_path), STRING_CONST("^.*$"), true);
+	for (size_t ifile = 0, fsize = array_size(files); ifile < fsize; ++ifile) {
+		//Dynamic and key parts are accounted with their static part, skip them and reap
+		//temporary files left by interrupted stores
+		string_const_t filename = path_file_name(STRING_ARGS(files[ifile]));
+		string_t path = path_concat(buffer, sizeof(buffer), STRING_ARGS(_resource_cache_path),
+		                            STRING_ARGS(files[ifile]));
+		if (string_ends_with(STRING_ARGS(filename), STRING_CONST(".tmp"))) {
+			tick_t modified = fs_last_modified(STRING_ARGS(path));
+			if ((now > modified) && ((uint64_t)(now - modified) > RESOURCE_CACHE_TEMPORARY_EXPIRY))
+				fs_remove_file(STRING_ARGS(path));
+			continue;
+		}
+		if (string_find(STRING_ARGS(filename), '.', 0) != STRING_NPOS)
+			continue;
+		resource_cache_entry_t entry;
+		entry.last_used = fs_last_modified(STRING_ARGS(path));
+		entry.size = fs_size(STRING_ARGS(path));
+		entry.file = ifile;
+		size_t baselength = path.length;
+		path = string_append(STRING_ARGS(path), sizeof(buffer), STRING_CONST(".blob"));
+		entry.size += fs_size(STRING_ARGS(path));
+		path.length = baselength;
+		path = string_append(STRING_ARGS(path), sizeof(buffer), STRING_CONST(".key"));
+		if (fs_is_file(STRING_ARGS(path))) {
+			entry.last_used = fs_last_modified(STRING_ARGS(path));
+			entry.size += fs_size(STRING_ARGS(path));
+		}
+		total += entry.size;
+		array_push(entries, entry);
+	}
+
+	if (total > limit) {
+		//Evict least recently used down to a low watermark to avoid evicting on every store
+		uint64_t target = limit - (limit / 8);
+		qsort(entries, array_size(entries), sizeof(resource_cache_entry_t),
+		      resource_cache_entry_compare);
+		for (size_t ientry = 0, esize = array_size(entries); (total > target) && (ientry < esize);
+		     ++ientry) {
+			string_t path = path_concat(buffer, sizeof(buffer), STRING_ARGS(_resource_cache_path),
+			                            STRING_ARGS(files[entries[ientry].file]));
+			fs_remove_file(STRING_ARGS(path));
+			size_t baselength = path.length;
+			path = string_append(STRING_ARGS(path), sizeof(buffer), STRING_CONST(".blob"));
+			fs_remove_file(STRING_ARGS(path));
+			path.length = baselength;
+			path = string_append(STRING_ARGS(path), sizeof(buffer), STRING_CONST(".key"));
+			fs_remove_file(STRING_ARGS(path));
+			total -= entries[ientry].size;
+			++evicted;
+		}
+	}
+
+	atomic_store64(&_resource_cache_size, (int64_t)total, memory_order_release);
+	atomic_add64(&_resource_cache_evictions, (int64_t)evicted, memory_order_release);
+	_resource_cache_size_valid = true;
+	mutex_unlock(_resource_cache_lock);
+
+	if (evicted)
+		log_debugf(HASH_RESOURCE, STRING_CONST("Compile cache evicted %" PRIu64 " entries, %" PRIu64 " bytes in use"),
+		           evicted, total);
+
+	array_deallocate(entries);
+	string_array_deallocate(files);
+}
+
+#else
+
+bool
+resource_cache_fetch(hash_t fingerprint, const uuid_t uuid, uint64_t platform,
+                     const uint256_t source_hash) {
+	FOUNDATION_UNUSED(fingerprint);
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(source_hash);
+	return false;
+}
+
+bool
+resource_cache_store(hash_t fingerprint, const uuid_t uuid, uint64_t platform,
+                     const uint256_t source_hash) {
+	FOUNDATION_UNUSED(fingerprint);
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(source_hash);
+	return false;
+}
+
+void
+resource_cache_evict(uint64_t limit) {
+	FOUNDATION_UNUSED(limit);
+}
+
+#endif
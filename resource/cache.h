@@ -0,0 +1,69 @@
+/* cache.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Set the compile cache directory. The compile cache stores compiled static and
+dynamic resource streams keyed by a fingerprint of the compiler identity and the source
+hashes of the resource and its dependencies, platform and source hash, and
+can be shared between multiple workspaces. An empty path disables the cache.
+\param path Cache directory path
+\param length Length of path */
+RESOURCE_API void
+resource_cache_set_path(const char* path, size_t length);
+
+/*! Get the compile cache directory
+\return Cache directory path, empty if cache is disabled */
+RESOURCE_API string_const_t
+resource_cache_path(void);
+
+/*! Look up compiled output in the cache and if found, materialize it into the
+first local path by hard link, reflink or copy
+\param fingerprint Fingerprint of compiler identity, source and dependency source hashes
+\param uuid Resource UUID
+\param platform Resource platform
+\param source_hash Resource source hash
+\return true if the compiled resource was materialized from the cache */
+RESOURCE_API bool
+resource_cache_fetch(hash_t fingerprint, const uuid_t uuid, uint64_t platform,
+                     const uint256_t source_hash);
+
+/*! Store compiled output found in the local paths in the cache. Output is only
+stored if the compiled resource header matches the given source hash
+\param fingerprint Fingerprint of compiler identity, source and dependency source hashes
+\param uuid Resource UUID
+\param platform Resource platform
+\param source_hash Resource source hash
+\return true if stored, false if not */
+RESOURCE_API bool
+resource_cache_store(hash_t fingerprint, const uuid_t uuid, uint64_t platform,
+                     const uint256_t source_hash);
+
+/*! Evict least recently used entries until cache size is within the given limit
+\param limit Maximum size in bytes */
+RESOURCE_API void
+resource_cache_evict(uint64_t limit);
+
+/*! Get compile cache statistics
+\return Cache statistics */
+RESOURCE_API resource_cache_statistics_t
+resource_cache_statistics(void);
@@ -22,9 +22,60 @@
 
 #include <foundation/foundation.h>
 
+typedef struct resource_compile_type_t resource_compile_type_t;
+
+struct resource_compile_type_t {
+	hash_t type;
+	resource_compile_fn* compilers;
+};
+
 static resource_compile_fn* _resource_compilers;
-static string_t* _resource_compile_tool_path;
+static resource_compile_type_t* _resource_compile_types;
+static hashmap_t* _resource_compile_type_map;
 static atomic64_t _resource_compile_token;
+static mutex_t* _resource_compile_identity_lock;
+static hash_t _resource_compile_identity;
+static unsigned int _resource_compile_identity_generation;
+
+typedef struct resource_compile_record_t resource_compile_record_t;
+
+struct resource_compile_record_t {
+	uuid_t uuid;
+	uint64_t platform;
+	//! Thread currently checking or compiling the resource, 0 if none
+	uint64_t owner;
+	//! Threads waiting for the owner to finish
+	semaphore_t** waiters;
+	bool checked;
+	bool need_update;
+	bool compiled;
+	bool success;
+	//! Next record with the same key hash
+	resource_compile_record_t* next;
+};
+
+typedef struct resource_compile_wait_t resource_compile_wait_t;
+
+//! Thread blocked on a resource owned by another thread, used to detect cycles across threads
+struct resource_compile_wait_t {
+	uint64_t thread;
+	resource_compile_record_t* record;
+};
+
+struct resource_compile_session_t {
+	mutex_t* lock;
+	hashmap_t* map;
+	resource_compile_record_t** records;
+	resource_compile_wait_t* waits;
+};
+
+//! Resources read by compilers while compiling a resource on the current thread
+struct resource_compile_recorder_t {
+	uuid_t uuid;
+	resource_dependency_t* deps;
+};
+
+FOUNDATION_DECLARE_THREAD_LOCAL(resource_compile_recorder_t*, resource_compile_recorder, nullptr)
 
 static hash_t
 resource_compile_token(void) {
@@ -33,64 +84,572 @@ resource_compile_token(void) {
 
 int
 resource_compile_initialize(void) {
+	_resource_compile_type_map = hashmap_allocate(67, 8);
+	_resource_compile_identity_lock = mutex_allocate(STRING_CONST("resource-compile-identity"));
 	return 0;
 }
 
 void
 resource_compile_finalize(void) {
 	array_deallocate(_resource_compilers);
-	string_array_deallocate(_resource_compile_tool_path);
+	for (size_t itype = 0, tsize = array_size(_resource_compile_types); itype != tsize; ++itype)
+		array_deallocate(_resource_compile_types[itype].compilers);
+	array_deallocate(_resource_compile_types);
+	hashmap_deallocate(_resource_compile_type_map);
+	mutex_deallocate(_resource_compile_identity_lock);
 
 	_resource_compilers = 0;
+	_resource_compile_types = 0;
+	_resource_compile_type_map = 0;
+	_resource_compile_identity_lock = 0;
+	_resource_compile_identity = 0;
 }
 
-#if (RESOURCE_ENABLE_LOCAL_SOURCE || RESOURCE_ENABLE_REMOTE_SOURCED) && RESOURCE_ENABLE_LOCAL_CACHE
+resource_compile_session_t*
+resource_compile_session_allocate(void) {
+	resource_compile_session_t* session =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_compile_session_t), 0, MEMORY_PERSISTENT);
+	session->lock = mutex_allocate(STRING_CONST("resource-compile-session"));
+	session->map = hashmap_allocate(257, 8);
+	session->records = nullptr;
+	session->waits = nullptr;
+	return session;
+}
 
-#if FOUNDATION_PLATFORM_WINDOWS
-#define RESOURCE_COMPILER_PATTERN "^.*compile\\.exe$"
-#else
-#define RESOURCE_COMPILER_PATTERN "^.*compile$"
-#endif
+void
+resource_compile_session_deallocate(resource_compile_session_t* session) {
+	if (!session)
+		return;
+	for (size_t irec = 0, rsize = array_size(session->records); irec < rsize; ++irec) {
+		array_deallocate(session->records[irec]->waiters);
+		memory_deallocate(session->records[irec]);
+	}
+	array_deallocate(session->records);
+	array_deallocate(session->waits);
+	hashmap_deallocate(session->map);
+	mutex_deallocate(session->lock);
+	memory_deallocate(session);
+}
+
+void
+resource_compile_record_dependency(const uuid_t uuid, uint64_t platform) {
+	resource_compile_recorder_t* recorder = get_thread_resource_compile_recorder();
+	if (!recorder || uuid_equal(recorder->uuid, uuid))
+		return;
+	for (size_t idep = 0, dsize = array_size(recorder->deps); idep < dsize; ++idep) {
+		if (uuid_equal(recorder->deps[idep].uuid, uuid) &&
+		    (recorder->deps[idep].platform == platform))
+			return;
+	}
+	resource_dependency_t dep;
+	dep.uuid = uuid;
+	dep.platform = platform;
+	array_push(recorder->deps, dep);
+}
+
+resource_compile_recorder_t*
+resource_compile_record_suspend(void) {
+	resource_compile_recorder_t* recorder = get_thread_resource_compile_recorder();
+	set_thread_resource_compile_recorder(nullptr);
+	return recorder;
+}
+
+void
+resource_compile_record_resume(resource_compile_recorder_t* recorder) {
+	set_thread_resource_compile_recorder(recorder);
+}
 
 bool
-resource_compile_need_update(const uuid_t uuid, uint64_t platform) {
-	uint256_t source_hash;
-	stream_t* stream;
-	resource_header_t header;
+resource_compile_cancel(const uuid_t uuid, uint64_t platform) {
+	bool cancelled = resource_tool_cancel(resource_dependency_hash(uuid, platform));
+	if (platform != RESOURCE_PLATFORM_ALL)
+		cancelled |= resource_tool_cancel(resource_dependency_hash(uuid, RESOURCE_PLATFORM_ALL));
+	return cancelled;
+}
 
-	if (!resource_module_config().enable_local_source &&
-	    !resource_module_config().enable_remote_sourced)
-		return false;
+#if (RESOURCE_ENABLE_LOCAL_SOURCE || RESOURCE_ENABLE_REMOTE_SOURCED) && RESOURCE_ENABLE_LOCAL_CACHE
 
-	string_const_t uuidstr = string_from_uuid_static(uuid);
-	log_debugf(HASH_RESOURCE, STRING_CONST("Compile check: %.*s (platform 0x%" PRIx64 ")"),
-	           STRING_FORMAT(uuidstr), platform);
+static hash_t
+resource_compile_identity(void);
 
+/*! Identify an in-process compiler by its offset from a function in this library, which is
+stable across runs of the same executable despite address randomization. Compilers in other
+modules may get a new identity each run, which only costs cache hits */
+static hash_t
+resource_compile_function_identity(resource_compile_fn compiler) {
+	return (hash_t)((uintptr_t)compiler - (uintptr_t)resource_compile_identity);
+}
+
+static hash_t
+resource_compile_identity(void) {
+	resource_tool_list_t* tools = resource_tool_acquire(RESOURCETOOL_COMPILE);
+	unsigned int generation = resource_tool_generation(RESOURCETOOL_COMPILE);
+	mutex_lock(_resource_compile_identity_lock);
+	hash_t identity = _resource_compile_identity;
+	if (identity && (generation == _resource_compile_identity_generation)) {
+		mutex_unlock(_resource_compile_identity_lock);
+		resource_tool_release(tools);
+		return identity;
+	}
+
+	//Identify the set of compilers by library and application version, the executable
+	//holding the in-process compilers, each in-process compiler and the external compiler
+	//tool binaries
+	hash_t* parts = nullptr;
+	version_t version = resource_module_version();
+	array_push(parts, hash(&version, sizeof(version)));
+	const application_t* application = environment_application();
+	array_push(parts, hash(STRING_ARGS(application->name)));
+	array_push(parts, hash(&application->version, sizeof(application->version)));
+	string_const_t executable = environment_executable_path();
+	array_push(parts, hash(STRING_ARGS(executable)));
+	array_push(parts, (hash_t)fs_last_modified(STRING_ARGS(executable)));
+	array_push(parts, (hash_t)fs_size(STRING_ARGS(executable)));
+	for (size_t icmp = 0, isize = array_size(_resource_compilers); icmp != isize; ++icmp)
+		array_push(parts, resource_compile_function_identity(_resource_compilers[icmp]));
+	for (size_t itype = 0, typesize = array_size(_resource_compile_types); itype != typesize;
+	     ++itype) {
+		const resource_compile_type_t* entry = _resource_compile_types + itype;
+		array_push(parts, entry->type);
+		for (size_t icmp = 0, isize = array_size(entry->compilers); icmp != isize; ++icmp)
+			array_push(parts, resource_compile_function_identity(entry->compilers[icmp]));
+	}
+	for (size_t itool = 0, tsize = array_size(tools->tools); itool != tsize; ++itool) {
+		const string_t fullpath = tools->tools[itool].path;
+		array_push(parts, hash(STRING_ARGS(fullpath)));
+		array_push(parts, (hash_t)fs_last_modified(STRING_ARGS(fullpath)));
+		array_push(parts, (hash_t)fs_size(STRING_ARGS(fullpath)));
+	}
+	identity = hash(parts, sizeof(hash_t) * array_size(parts));
+	array_deallocate(parts);
+	resource_tool_release(tools);
+
+	identity = identity ? identity : 1;
+	_resource_compile_identity_generation = generation;
+	_resource_compile_identity = identity;
+	mutex_unlock(_resource_compile_identity_lock);
+	return identity;
+}
+
+static void
+resource_compile_identity_invalidate(void) {
+	mutex_lock(_resource_compile_identity_lock);
+	_resource_compile_identity = 0;
+	mutex_unlock(_resource_compile_identity_lock);
+}
+
+static hash_t
+resource_compile_fingerprint(hash_t identity, const uuid_t uuid, uint64_t platform,
+                             const uint256_t source_hash) {
+	//Compilers read dependency data, a changed dependency source can fix a failed compile
+	hash_t* parts = nullptr;
+	array_push(parts, identity);
+	array_push(parts, hash(&source_hash, sizeof(source_hash)));
 	resource_dependency_t localdeps[8];
 	size_t depscapacity = sizeof(localdeps) / sizeof(localdeps[0]);
 	size_t numdeps = resource_source_num_dependencies(uuid, platform);
-	if (numdeps) {
-		bool depsuccess = true;
-		resource_dependency_t* deps = localdeps;
-		if (numdeps > depscapacity)
-			deps = memory_allocate(HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16,
-			                       MEMORY_PERSISTENT);
-		resource_source_dependencies(uuid, platform, deps, numdeps);
-		for (size_t idep = 0; idep < numdeps; ++idep) {
-			log_debug(HASH_RESOURCE, STRING_CONST("Dependent resource compile check:"));
-			if (resource_compile_need_update(deps[idep].uuid, platform)) {
-				if (!resource_compile(deps[idep].uuid, platform))
-					depsuccess = false;
-			}
+	resource_dependency_t* deps = localdeps;
+	if (numdeps > depscapacity)
+		deps = memory_allocate(HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16,
+		                       MEMORY_PERSISTENT);
+	if (numdeps)
+		numdeps = resource_source_dependencies(uuid, platform, deps, numdeps);
+	for (size_t idep = 0; idep < numdeps; ++idep) {
+		uint256_t dephash = resource_source_hash(deps[idep].uuid, platform);
+		array_push(parts, hash(&dephash, sizeof(dephash)));
+	}
+	if (deps != localdeps)
+		memory_deallocate(deps);
+	hash_t fingerprint = hash(parts, sizeof(hash_t) * array_size(parts));
+	array_deallocate(parts);
+	return fingerprint;
+}
+
+static resource_dependency_t*
+resource_compile_stored_dependencies(const uuid_t uuid, uint64_t platform,
+                                     resource_dependency_t* localdeps, size_t capacity,
+                                     size_t* count) {
+	resource_dependency_t* deps = localdeps;
+	size_t numdeps = resource_source_num_dependencies(uuid, platform);
+	if (numdeps > capacity)
+		deps = memory_allocate(HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16,
+		                       MEMORY_PERSISTENT);
+	if (numdeps)
+		numdeps = resource_source_dependencies(uuid, platform, deps, numdeps);
+	*count = numdeps;
+	return deps;
+}
+
+static bool
+resource_compile_dependency_reaches(const uuid_t from, const uuid_t to, uint64_t platform) {
+	// Depth first walk of stored dependencies, each resource visited once
+	resource_dependency_t localdeps[8];
+	uuid_t* pending = nullptr;
+	uuid_t* visited = nullptr;
+	bool reached = false;
+	array_push(pending, from);
+	while (!reached && array_size(pending)) {
+		uuid_t current = pending[array_size(pending) - 1];
+		array_pop(pending);
+		if (uuid_equal(current, to)) {
+			reached = true;
+			break;
 		}
+		size_t ivisit = 0, vsize = array_size(visited);
+		while ((ivisit < vsize) && !uuid_equal(visited[ivisit], current))
+			++ivisit;
+		if (ivisit < vsize)
+			continue;
+		array_push(visited, current);
+
+		size_t numdeps = 0;
+		resource_dependency_t* deps = resource_compile_stored_dependencies(
+		    current, platform, localdeps, sizeof(localdeps) / sizeof(localdeps[0]), &numdeps);
+		for (size_t idep = 0; idep < numdeps; ++idep)
+			array_push(pending, deps[idep].uuid);
 		if (deps != localdeps)
 			memory_deallocate(deps);
+	}
+	array_deallocate(pending);
+	array_deallocate(visited);
+	return reached;
+}
+
+static void
+resource_compile_commit_dependencies(const uuid_t uuid, uint64_t platform,
+                                     const resource_dependency_t* recorded) {
+	if (!resource_module_config().enable_local_source)
+		return;
+
+	// Recorded dependencies replace the set of the platform so resources the compilers no
+	// longer read are dropped, dependencies of less specific platforms are kept where they are
+	resource_dependency_t localdeps[8];
+	size_t numdeps = 0;
+	resource_dependency_t* deps = resource_compile_stored_dependencies(
+	    uuid, platform, localdeps, sizeof(localdeps) / sizeof(localdeps[0]), &numdeps);
+	resource_dependency_t* current = nullptr;
+	for (size_t idep = 0; idep < numdeps; ++idep) {
+		if (deps[idep].platform == platform)
+			array_push(current, deps[idep]);
+	}
+
+	string_const_t uuidstr;
+	resource_dependency_t* replaced = nullptr;
+	for (size_t irec = 0, rsize = array_size(recorded); irec < rsize; ++irec) {
+		// Dependency file keeps a single set of resources per platform, so reads of
+		// several platforms of the same resource make a single edge. Edges kept for a less
+		// specific platform are not repeated.
+		size_t idep = 0;
+		while ((idep < numdeps) && ((deps[idep].platform == platform) ||
+		                            !uuid_equal(deps[idep].uuid, recorded[irec].uuid)))
+			++idep;
+		if (idep < numdeps)
+			continue;
+		size_t irepl = 0, replsize = array_size(replaced);
+		while ((irepl < replsize) && !uuid_equal(replaced[irepl].uuid, recorded[irec].uuid))
+			++irepl;
+		if (irepl < replsize)
+			continue;
+
+		if (resource_compile_dependency_reaches(recorded[irec].uuid, uuid, platform)) {
+			uuidstr = string_from_uuid_static(uuid);
+			log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+			          STRING_CONST("Compile: %.*s (platform 0x%" PRIx64
+			                       ") read a resource depending on itself, dependency not "
+			                       "recorded to avoid a cycle"),
+			          STRING_FORMAT(uuidstr), platform);
+			continue;
+		}
+
+		resource_dependency_t dep;
+		dep.uuid = recorded[irec].uuid;
+		dep.platform = platform;
+		array_push(replaced, dep);
+	}
+
+	// Only rewrite the dependency file if the set changed
+	bool changed = (array_size(replaced) != array_size(current));
+	for (size_t irepl = 0, replsize = array_size(replaced); !changed && (irepl < replsize);
+	     ++irepl) {
+		size_t icur = 0, cursize = array_size(current);
+		while ((icur < cursize) && !uuid_equal(current[icur].uuid, replaced[irepl].uuid))
+			++icur;
+		changed = (icur == cursize);
+	}
+	if (changed) {
+		uuidstr = string_from_uuid_static(uuid);
+		log_debugf(HASH_RESOURCE,
+		           STRING_CONST("Compile: %.*s (platform 0x%" PRIx64 ") recorded %" PRIsize
+		                        " dependencies, replacing %" PRIsize),
+		           STRING_FORMAT(uuidstr), platform, array_size(replaced), array_size(current));
+		resource_source_set_dependencies(uuid, platform, replaced, array_size(replaced));
+	}
+
+	array_deallocate(replaced);
+	array_deallocate(current);
+	if (deps != localdeps)
+		memory_deallocate(deps);
+}
+
+static resource_compile_record_t*
+resource_compile_session_record(resource_compile_session_t* session, const uuid_t uuid,
+                                uint64_t platform) {
+	if (!session)
+		return nullptr;
+	hash_t key = resource_dependency_hash(uuid, platform);
+	mutex_lock(session->lock);
+	// Records colliding on the key hash are chained from the record in the map
+	resource_compile_record_t* head = hashmap_lookup(session->map, key);
+	resource_compile_record_t* record = head;
+	while (record && (!uuid_equal(record->uuid, uuid) || (record->platform != platform)))
+		record = record->next;
+	if (!record) {
+		record = memory_allocate(HASH_RESOURCE, sizeof(resource_compile_record_t), 0,
+		                         MEMORY_PERSISTENT);
+		memset(record, 0, sizeof(resource_compile_record_t));
+		record->uuid = uuid;
+		record->platform = platform;
+		array_push(session->records, record);
+		if (head) {
+			record->next = head->next;
+			head->next = record;
+		} else {
+			hashmap_insert(session->map, key, record);
+		}
+	}
+	mutex_unlock(session->lock);
+	return record;
+}
 
-		if (!depsuccess) {
-			error_context_pop();
+static bool
+resource_compile_session_cycle(resource_compile_session_t* session,
+                               const resource_compile_record_t* record, uint64_t self) {
+	// Follow the chain of owners waiting on other resources, reaching the calling
+	// thread means waiting would never finish
+	uint64_t owner = record->owner;
+	for (size_t ichain = 0, wsize = array_size(session->waits); ichain <= wsize; ++ichain) {
+		if (owner == self)
+			return true;
+		size_t iwait = 0;
+		while ((iwait < wsize) && (session->waits[iwait].thread != owner))
+			++iwait;
+		if (iwait == wsize)
 			return false;
+		owner = session->waits[iwait].record->owner;
+	}
+	return false;
+}
+
+static void
+resource_compile_session_wait(resource_compile_session_t* session,
+                              resource_compile_record_t* record, uint64_t self) {
+	// Called with session lock held, returns with it held
+	semaphore_t signal;
+	semaphore_initialize(&signal, 0);
+	resource_compile_wait_t wait = {self, record};
+	array_push(session->waits, wait);
+	array_push(record->waiters, &signal);
+	mutex_unlock(session->lock);
+	semaphore_wait(&signal);
+	mutex_lock(session->lock);
+	semaphore_finalize(&signal);
+	for (size_t iwait = 0, wsize = array_size(session->waits); iwait < wsize; ++iwait) {
+		if (session->waits[iwait].thread == self) {
+			array_erase(session->waits, iwait);
+			break;
+		}
+	}
+}
+
+static void
+resource_compile_session_release(resource_compile_record_t* record) {
+	// Called with session lock held
+	record->owner = 0;
+	for (size_t iwait = 0, wsize = array_size(record->waiters); iwait < wsize; ++iwait)
+		semaphore_post(record->waiters[iwait]);
+	array_clear(record->waiters);
+}
+
+static bool
+resource_compile_session_lookup(resource_compile_session_t* session,
+                                resource_compile_record_t* record, bool compile, bool* result) {
+	bool found = false;
+	if (!record)
+		return false;
+	uint64_t self = thread_id();
+	mutex_lock(session->lock);
+	while (!found) {
+		if (record->compiled) {
+			// Already compiled in this pass, never recompile
+			*result = compile ? record->success : false;
+			found = true;
+		} else if (record->checked && !compile) {
+			*result = record->need_update;
+			found = true;
+		} else if (record->owner && resource_compile_session_cycle(session, record, self)) {
+			// Reached again while checking or compiling the resource itself, fail the
+			// compile instead of recursing without bound
+			string_const_t uuidstr = string_from_uuid_static(record->uuid);
+			log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+			          STRING_CONST("Dependency cycle, unable to compile: %.*s (platform 0x%" PRIx64
+			                       ")"),
+			          STRING_FORMAT(uuidstr), record->platform);
+			*result = !compile;
+			found = true;
+		} else if (record->owner) {
+			// Another thread is checking or compiling the resource, wait for the result
+			resource_compile_session_wait(session, record, self);
+		} else {
+			// Claim the resource, released once the check or compile is done
+			record->owner = self;
+			break;
+		}
+	}
+	mutex_unlock(session->lock);
+	return found;
+}
+
+static bool
+resource_compile_session_need_update_internal(resource_compile_session_t* session,
+                                              const uuid_t uuid, uint64_t platform);
+
+static bool
+resource_compile_session_internal(resource_compile_session_t* session, const uuid_t uuid,
+                                  uint64_t platform);
+
+static bool
+resource_compile_dependencies(resource_compile_session_t* session, const uuid_t uuid,
+                              uint64_t platform, const string_t uuidstr) {
+	bool success = true;
+	resource_dependency_t localdeps[8];
+	size_t depscapacity = sizeof(localdeps) / sizeof(localdeps[0]);
+	size_t numdeps = resource_source_num_dependencies(uuid, platform);
+	if (!numdeps)
+		return true;
+
+	// Without a caller supplied session, memoize within this dependency walk
+	resource_compile_session_t* localsession = nullptr;
+	if (!session)
+		session = localsession = resource_compile_session_allocate();
+
+	resource_dependency_t* deps = localdeps;
+	if (numdeps > depscapacity)
+		deps = memory_allocate(HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16,
+		                       MEMORY_PERSISTENT);
+	numdeps = resource_source_dependencies(uuid, platform, deps, numdeps);
+	for (size_t idep = 0; idep < numdeps; ++idep) {
+		char depuuidbuf[40];
+		const string_t depuuidstr =
+		    string_from_uuid(depuuidbuf, sizeof(depuuidbuf), deps[idep].uuid);
+		log_debugf(HASH_RESOURCE, STRING_CONST("Compile: %.*s dependency: %.*s"),
+		           STRING_FORMAT(uuidstr), STRING_FORMAT(depuuidstr));
+		error_context_push(STRING_CONST("compiling dependent resource"), STRING_ARGS(depuuidstr));
+		if (resource_compile_session_need_update_internal(session, deps[idep].uuid, platform)) {
+			if (!resource_compile_session_internal(session, deps[idep].uuid, platform))
+				success = false;
 		}
+		error_context_pop();
 	}
+	if (deps != localdeps)
+		memory_deallocate(deps);
+
+	resource_compile_session_deallocate(localsession);
+
+	return success;
+}
+
+static bool
+resource_compile_session_need_update_internal(resource_compile_session_t* session,
+                                              const uuid_t uuid, uint64_t platform) {
+	bool need_update = false;
+	resource_compile_record_t* record = resource_compile_session_record(session, uuid, platform);
+	if (resource_compile_session_lookup(session, record, false, &need_update))
+		return need_update;
+
+	char uuidbuf[40];
+	const string_t uuidstr = string_from_uuid(uuidbuf, sizeof(uuidbuf), uuid);
+	log_debugf(HASH_RESOURCE, STRING_CONST("Compile check: %.*s (platform 0x%" PRIx64 ")"),
+	           STRING_FORMAT(uuidstr), platform);
+
+	// Reads while checking are not reads of a compiler running on this thread
+	resource_compile_recorder_t* recorder = resource_compile_record_suspend();
+	if (resource_compile_dependencies(session, uuid, platform, uuidstr))
+		need_update = resource_compile_need_update_node(uuid, platform);
+	resource_compile_record_resume(recorder);
+
+	if (record) {
+		mutex_lock(session->lock);
+		record->checked = true;
+		record->need_update = need_update;
+		resource_compile_session_release(record);
+		mutex_unlock(session->lock);
+	}
+
+	return need_update;
+}
+
+static bool
+resource_compile_session_internal(resource_compile_session_t* session, const uuid_t uuid,
+                                  uint64_t platform) {
+	bool success = false;
+	resource_compile_record_t* record = resource_compile_session_record(session, uuid, platform);
+	if (resource_compile_session_lookup(session, record, true, &success))
+		return success;
+
+	char uuidbuf[40];
+	const string_t uuidstr = string_from_uuid(uuidbuf, sizeof(uuidbuf), uuid);
+	error_context_push(STRING_CONST("compiling resource"), STRING_ARGS(uuidstr));
+
+	log_debugf(HASH_RESOURCE, STRING_CONST("Compile: %.*s (platform 0x%" PRIx64 ")"),
+	           STRING_FORMAT(uuidstr), platform);
+
+	// Nested compiles record the reads of their own compilers
+	resource_compile_recorder_t* recorder = resource_compile_record_suspend();
+	bool depsuccess = resource_compile_dependencies(session, uuid, platform, uuidstr);
+
+	error_context_pop();
+
+	if (depsuccess)
+		success = resource_compile_node(uuid, platform);
+	resource_compile_record_resume(recorder);
+
+	if (record) {
+		mutex_lock(session->lock);
+		record->checked = true;
+		record->need_update = false;
+		record->compiled = true;
+		record->success = success;
+		resource_compile_session_release(record);
+		mutex_unlock(session->lock);
+	}
+
+	return success;
+}
+
+bool
+resource_compile_need_update(const uuid_t uuid, uint64_t platform) {
+	return resource_compile_session_need_update(nullptr, uuid, platform);
+}
+
+bool
+resource_compile_session_need_update(resource_compile_session_t* session, const uuid_t uuid,
+                                     uint64_t platform) {
+	if (!resource_module_config().enable_local_source &&
+	    !resource_module_config().enable_remote_sourced)
+		return false;
+
+	return resource_compile_session_need_update_internal(session, uuid, platform);
+}
+
+static bool
+resource_compile_need_update_source(const uuid_t uuid, uint64_t platform) {
+	uint256_t source_hash;
+	stream_t* stream;
+	resource_header_t header;
+
+	if (!resource_module_config().enable_local_source &&
+	    !resource_module_config().enable_remote_sourced)
+		return false;
 
 	if (resource_autoimport_need_update(uuid, platform))
 		resource_autoimport(uuid);
@@ -120,62 +679,301 @@ resource_compile_need_update(const uuid_t uuid, uint64_t platform) {
 	return !uint256_equal(source_hash, header.source_hash);
 }
 
+//! Read type of resource from source for per type metrics, outside of the timed check
+static string_t
+resource_compile_source_type(const uuid_t uuid, uint64_t platform, char* buffer,
+                             size_t capacity) {
+	string_t type = string_copy(buffer, capacity, STRING_CONST("unknown"));
+	resource_compile_recorder_t* recorder = resource_compile_record_suspend();
+	resource_source_t source;
+	resource_source_initialize(&source);
+	if (resource_source_read(&source, uuid)) {
+		resource_change_t* change = resource_source_get(
+		    &source, HASH_RESOURCE_TYPE, platform != RESOURCE_PLATFORM_ALL ? platform : 0);
+		if (change && resource_change_is_value(change))
+			type = string_copy(buffer, capacity, STRING_ARGS(change->value.value));
+	}
+	resource_source_finalize(&source);
+	resource_compile_record_resume(recorder);
+	return type;
+}
+
+bool
+resource_compile_need_update_node(const uuid_t uuid, uint64_t platform) {
+	if (!resource_metrics_is_enabled())
+		return resource_compile_need_update_source(uuid, platform);
+
+	tick_t start = time_current();
+	bool need_update = resource_compile_need_update_source(uuid, platform);
+	tick_t elapsed = time_diff(start, time_current());
+
+	char typebuf[64];
+	string_t type = resource_compile_source_type(uuid, platform, typebuf, sizeof(typebuf));
+	resource_metrics_time(STRING_ARGS(type), platform, RESOURCEMETRIC_NEED_UPDATE, elapsed);
+	resource_metrics_count(STRING_ARGS(type), platform,
+	                       need_update ? RESOURCEMETRIC_OUT_OF_DATE : RESOURCEMETRIC_UP_TO_DATE);
+	return need_update;
+}
+
 bool
 resource_compile(const uuid_t uuid, uint64_t platform) {
-	size_t icmp, isize;
-	size_t internal = 0;
-	size_t external = 0;
-	resource_source_t source;
-	string_const_t type = string_null();
-	bool success = false;
+	return resource_compile_session(nullptr, uuid, platform);
+}
+
+bool
+resource_compile_session(resource_compile_session_t* session, const uuid_t uuid,
+                         uint64_t platform) {
 	if (!resource_module_config().enable_local_source &&
 	    !resource_module_config().enable_remote_sourced)
 		return false;
 
+	return resource_compile_session_internal(session, uuid, platform);
+}
+
+typedef struct resource_compile_target_t resource_compile_target_t;
+
+struct resource_compile_target_t {
+	uint64_t platform;
+	uint256_t source_hash;
+	//! Key for failure records and tool job cancellation
+	hash_t failkey;
+	//! Compiler identity combined with source and dependency source hashes
+	hash_t fingerprint;
+	hash_t typehash;
+	size_t internal;
+	size_t external;
+	//! Still to be compiled, not fetched from cache or skipped after failure
+	bool pending;
+	bool success;
+	bool cancelled;
+	//! Handled by external tools as part of a group of targets
+	bool grouped;
+	char typebuf[64];
+	string_t type;
+	char toolbuf[256];
+	string_t tools;
+	//! Time spent in each phase, only measured when metrics are enabled
+	tick_t phase[RESOURCEMETRIC_PHASE_COUNT];
+};
+
+static void
+resource_compile_target_tool_failed(resource_compile_target_t* target, string_const_t toolname,
+                                    int exit_code) {
+	log_debugf(HASH_RESOURCE, STRING_CONST("Failed compiling with external tool: %.*s (%d)"),
+	           STRING_FORMAT(toolname), exit_code);
+	if (exit_code == RESOURCE_TOOL_EXIT_CANCELLED)
+		target->cancelled = true;
+	char exitbuf[128];
+	string_t exitstr;
+	if (exit_code == RESOURCE_TOOL_EXIT_TIMEOUT)
+		exitstr = string_format(exitbuf, sizeof(exitbuf), STRING_CONST("%s%.*s timed out"),
+		                        target->tools.length ? ", " : "", STRING_FORMAT(toolname));
+	else
+		exitstr = string_format(exitbuf, sizeof(exitbuf), STRING_CONST("%s%.*s exited with %d"),
+		                        target->tools.length ? ", " : "", STRING_FORMAT(toolname),
+		                        exit_code);
+	target->tools = string_append(STRING_ARGS(target->tools), sizeof(target->toolbuf),
+	                              STRING_ARGS(exitstr));
+}
+
+static void
+resource_compile_external(const uuid_t uuid, const string_t uuidstr,
+                          resource_compile_target_t* targets, size_t num_targets) {
+	resource_tool_list_t* tools = resource_tool_acquire(RESOURCETOOL_COMPILE);
+	if (!array_size(tools->tools)) {
+		resource_tool_release(tools);
+		return;
+	}
+
+	string_const_t* common = nullptr;
+	const string_const_t* local_paths = resource_local_paths();
+	for (size_t ilocal = 0, lsize = array_size(local_paths); ilocal < lsize; ++ilocal) {
+		array_push(common, string_const(STRING_CONST("--resource-local-path")));
+		array_push(common, local_paths[ilocal]);
+	}
+
+	string_const_t local_source = resource_source_path();
+	if (local_source.length) {
+		array_push(common, string_const(STRING_CONST("--resource-source-path")));
+		array_push(common, local_source);
+	}
+
+	string_const_t remote_sourced = resource_remote_sourced();
+	if (remote_sourced.length) {
+		array_push(common, string_const(STRING_CONST("--resource-remote-sourced")));
+		array_push(common, remote_sourced);
+	}
+
+	bool metrics = resource_metrics_is_enabled();
+	char platformbuf[16][34];
+	string_const_t* args = nullptr;
+	resource_compile_target_t** group = nullptr;
+	resource_compile_target_t** remain = nullptr;
+	for (size_t itarget = 0; itarget < num_targets; ++itarget) {
+		// Targets resolving to the same type select the same tools, group them so tools
+		// accepting a platform list are invoked once for the group
+		resource_compile_target_t* first = targets + itarget;
+		if (!first->pending || first->success || first->grouped)
+			continue;
+		array_clear(group);
+		for (size_t inext = itarget; inext < num_targets; ++inext) {
+			resource_compile_target_t* target = targets + inext;
+			if (target->pending && !target->success && !target->grouped &&
+			    (target->typehash == first->typehash)) {
+				target->grouped = true;
+				array_push(group, target);
+			}
+		}
+
+		// Tools declaring the type in their manifest first, then tools handling any type
+		size_t* selected = resource_tool_select(tools, first->typehash);
+		for (size_t isel = 0, ssize = array_size(selected); isel != ssize; ++isel) {
+			const resource_tool_t* tool = tools->tools + selected[isel];
+			const string_const_t toolname = path_file_name(STRING_ARGS(tool->path));
+
+			array_clear(remain);
+			for (size_t igroup = 0, gsize = array_size(group); igroup < gsize; ++igroup) {
+				if (!group[igroup]->success && !group[igroup]->cancelled)
+					array_push(remain, group[igroup]);
+			}
+			size_t num_remain = array_size(remain);
+			if (!num_remain)
+				break;
+
+			size_t batch = 1;
+			if (tool->multiplatform)
+				batch = (num_remain < 16) ? num_remain : 16;
+			for (size_t iremain = 0; iremain < num_remain; iremain += batch) {
+				size_t count = ((num_remain - iremain) < batch) ? (num_remain - iremain) : batch;
+				array_clear(args);
+				array_push(args, string_to_const(uuidstr));
+				for (size_t ibatch = 0; ibatch < count; ++ibatch) {
+					uint64_t platform = remain[iremain + ibatch]->platform;
+					if (!platform && (count == 1))
+						continue;
+					string_t platformstr = string_from_uint(
+					    platformbuf[ibatch], sizeof(platformbuf[0]), platform, true, 0, 0);
+					array_push(args, string_const(STRING_CONST("--platform")));
+					array_push(args, string_to_const(platformstr));
+				}
+
+				// A platform list is cancelled through any of its platforms or all platforms
+				hash_t job = (count == 1) ? remain[iremain]->failkey :
+				                            resource_dependency_hash(uuid, RESOURCE_PLATFORM_ALL);
+				tick_t start = metrics ? time_current() : 0;
+				int exit_code = resource_tool_execute(tool, job, args, array_size(args), common,
+				                                      array_size(common));
+				// Time of a batch is split evenly across its platforms
+				tick_t elapsed = metrics ? time_diff(start, time_current()) / (tick_t)count : 0;
+				for (size_t ibatch = 0; ibatch < count; ++ibatch) {
+					resource_compile_target_t* target = remain[iremain + ibatch];
+					target->phase[RESOURCEMETRIC_EXTERNAL] += elapsed;
+					++target->external;
+					if (exit_code == 0)
+						target->success = true;
+					else
+						resource_compile_target_tool_failed(target, toolname, exit_code);
+				}
+				if (exit_code == 0)
+					log_debugf(HASH_RESOURCE,
+					           STRING_CONST("Compiled with external tool: %.*s (%" PRIsize
+					                        " platforms)"),
+					           STRING_FORMAT(toolname), count);
+			}
+		}
+		array_deallocate(selected);
+	}
+
+	array_deallocate(remain);
+	array_deallocate(group);
+	array_deallocate(args);
+	array_deallocate(common);
+	resource_tool_release(tools);
+}
+
+static size_t
+resource_compile_targets(const uuid_t uuid, resource_compile_target_t* targets,
+                         size_t num_targets) {
+	size_t icmp, isize;
+	size_t num_success = 0;
+	size_t num_pending = 0;
+	resource_source_t source;
+	bool metrics = resource_metrics_is_enabled();
+	tick_t start = 0;
+
 	char uuidbuf[40];
 	const string_t uuidstr = string_from_uuid(uuidbuf, sizeof(uuidbuf), uuid);
 	error_context_push(STRING_CONST("compiling resource"), STRING_ARGS(uuidstr));
 
-	size_t numdeps = resource_source_num_dependencies(uuid, platform);
-	log_debugf(HASH_RESOURCE,
-	           STRING_CONST("Compile: %.*s (platform 0x%" PRIx64 ") %" PRIsize " dependencies"),
-	           STRING_FORMAT(uuidstr), platform, numdeps);
+	if (resource_autoimport_need_update(uuid, targets[0].platform))
+		resource_autoimport(uuid);
 
-	resource_dependency_t localdeps[8];
-	size_t depscapacity = sizeof(localdeps) / sizeof(localdeps[0]);
-	if (numdeps) {
-		bool depsuccess = true;
-		resource_dependency_t* deps = localdeps;
-		if (numdeps > depscapacity)
-			deps = memory_allocate(HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16,
-			                       MEMORY_PERSISTENT);
-		resource_source_dependencies(uuid, platform, deps, numdeps);
-		for (size_t idep = 0; idep < numdeps; ++idep) {
-			char depuuidbuf[40];
-			const string_t depuuidstr =
-			    string_from_uuid(depuuidbuf, sizeof(depuuidbuf), deps[idep].uuid);
-			log_debugf(HASH_RESOURCE, STRING_CONST("Compile: %.*s dependency: %.*s"),
-			           STRING_FORMAT(uuidstr), STRING_FORMAT(depuuidstr));
-			error_context_push(STRING_CONST("compiling dependent resource"),
-			                   STRING_ARGS(depuuidstr));
-			if (resource_compile_need_update(deps[idep].uuid, platform)) {
-				if (!resource_compile(deps[idep].uuid, platform))
-					depsuccess = false;
-			}
-			error_context_pop();
+	hash_t identity = resource_compile_identity();
+	for (size_t itarget = 0; itarget < num_targets; ++itarget) {
+		resource_compile_target_t* target = targets + itarget;
+		uint64_t platform = target->platform;
+		target->source_hash = resource_source_hash(uuid, platform);
+		target->failkey = resource_dependency_hash(uuid, platform);
+		target->typehash = 0;
+		target->internal = target->external = 0;
+		target->pending = target->success = target->cancelled = target->grouped = false;
+		target->type =
+		    string_copy(target->typebuf, sizeof(target->typebuf), STRING_CONST("unknown"));
+		target->tools = string_copy(target->toolbuf, sizeof(target->toolbuf), STRING_CONST(""));
+		memset(target->phase, 0, sizeof(target->phase));
+
+		// Cache entries are keyed on dependency sources as well, compilers read them
+		if (metrics)
+			start = time_current();
+		target->fingerprint =
+		    resource_compile_fingerprint(identity, uuid, platform, target->source_hash);
+		bool cached =
+		    resource_cache_fetch(target->fingerprint, uuid, platform, target->source_hash);
+		if (metrics) {
+			target->phase[RESOURCEMETRIC_CACHE] = time_diff(start, time_current());
+			resource_metrics_time(STRING_CONST(""), platform, RESOURCEMETRIC_CACHE,
+			                      target->phase[RESOURCEMETRIC_CACHE]);
+			resource_metrics_count(STRING_CONST(""), platform,
+			                       cached ? RESOURCEMETRIC_CACHE_HIT : RESOURCEMETRIC_CACHE_MISS);
+		}
+		if (cached) {
+			log_infof(HASH_RESOURCE,
+			          STRING_CONST("Compiled from cache: %.*s (platform 0x%" PRIx64 ")"),
+			          STRING_FORMAT(uuidstr), platform);
+			target->success = true;
+			++num_success;
+			hash_t token = resource_compile_token();
+			resource_event_post(RESOURCEEVENT_COMPILE, uuid, platform, token);
+			continue;
 		}
-		if (deps != localdeps)
-			memory_deallocate(deps);
 
-		if (!depsuccess) {
-			error_context_pop();
-			return false;
+		// Skip compilers known to fail with unchanged inputs
+		if (resource_failure_recorded(RESOURCEFAILURE_COMPILE, target->failkey)) {
+			if (resource_failure_check(RESOURCEFAILURE_COMPILE, target->failkey,
+			                           target->fingerprint)) {
+				log_debugf(HASH_RESOURCE,
+				           STRING_CONST("Skipped compile with unchanged inputs after failure: "
+				                        "%.*s (platform 0x%" PRIx64 ")"),
+				           STRING_FORMAT(uuidstr), platform);
+				if (metrics)
+					resource_metrics_count(STRING_CONST(""), platform,
+					                       RESOURCEMETRIC_FAILURE_SKIPPED);
+				continue;
+			}
 		}
+
+		target->pending = true;
+		++num_pending;
 	}
 
-	if (resource_autoimport_need_update(uuid, platform))
-		resource_autoimport(uuid);
+	if (!num_pending) {
+		error_context_pop();
+		return num_success;
+	}
 
+	// Source is read and collapsed once and shared read-only by compilers for all platforms
+	if (metrics)
+		start = time_current();
 	resource_source_initialize(&source);
 	bool was_read = resource_source_read(&source, uuid);
 	if (!was_read) {
@@ -187,133 +985,199 @@ resource_compile(const uuid_t uuid, uint64_t platform) {
 		resource_source_initialize(&source);
 		was_read = resource_source_read(&source, uuid);
 	}
+	if (metrics) {
+		tick_t elapsed = time_diff(start, time_current()) / (tick_t)num_pending;
+		for (size_t itarget = 0; itarget < num_targets; ++itarget)
+			targets[itarget].phase[RESOURCEMETRIC_SOURCE_READ] = elapsed;
+	}
 	if (was_read) {
-		uint256_t source_hash;
-		resource_change_t* change;
-
-		source_hash = resource_source_hash(uuid, platform);
-		if (uint256_is_null(source_hash) && resource_module_config().enable_local_source) {
+		bool rehash = false;
+		for (size_t itarget = 0; itarget < num_targets; ++itarget)
+			rehash |= targets[itarget].pending && uint256_is_null(targets[itarget].source_hash);
+		if (rehash && resource_module_config().enable_local_source) {
 			// Recreate source hash data
 			resource_source_write(&source, uuid, source.read_binary);
-			source_hash = resource_source_hash(uuid, platform);
+			for (size_t itarget = 0; itarget < num_targets; ++itarget) {
+				resource_compile_target_t* target = targets + itarget;
+				target->source_hash = resource_source_hash(uuid, target->platform);
+			}
 		}
 
+		if (metrics)
+			start = time_current();
 		resource_source_collapse_history(&source);
-		change = resource_source_get(&source, HASH_RESOURCE_TYPE,
-		                             platform != RESOURCE_PLATFORM_ALL ? platform : 0);
-		if (change && resource_change_is_value(change)) {
-			type = change->value.value;
+		if (metrics) {
+			tick_t elapsed = time_diff(start, time_current()) / (tick_t)num_pending;
+			for (size_t itarget = 0; itarget < num_targets; ++itarget)
+				targets[itarget].phase[RESOURCEMETRIC_COLLAPSE] = elapsed;
 		}
 
-		for (icmp = 0, isize = array_size(_resource_compilers); !success && (icmp != isize);
-		     ++icmp) {
-			success = (_resource_compilers[icmp](uuid, platform, &source, source_hash,
-			                                     STRING_ARGS(type)) == 0);
-			++internal;
+		for (size_t itarget = 0; itarget < num_targets; ++itarget) {
+			resource_compile_target_t* target = targets + itarget;
+			if (!target->pending)
+				continue;
+			uint64_t platform = target->platform;
+			string_const_t type = string_null();
+			resource_change_t* change = resource_source_get(
+			    &source, HASH_RESOURCE_TYPE, platform != RESOURCE_PLATFORM_ALL ? platform : 0);
+			if (change && resource_change_is_value(change)) {
+				type = change->value.value;
+				target->type = string_copy(target->typebuf, sizeof(target->typebuf),
+				                           STRING_ARGS(type));
+			}
+
+			// Dispatch on type to compilers registered for it, then try wildcard compilers
+			target->typehash = type.length ? hash(STRING_ARGS(type)) : 0;
+			size_t itype = target->typehash ? (size_t)(uintptr_t)hashmap_lookup(
+			                                      _resource_compile_type_map, target->typehash) :
+			                                  0;
+			bool success = false;
+			if (metrics)
+				start = time_current();
+
+			// Record resources read by the compilers, checks and nested compiles of those
+			// resources suspend the recorder
+			resource_compile_recorder_t recorder;
+			resource_compile_recorder_t* parent = get_thread_resource_compile_recorder();
+			recorder.uuid = uuid;
+			recorder.deps = nullptr;
+			set_thread_resource_compile_recorder(&recorder);
+			if (itype) {
+				const resource_compile_fn* compilers = _resource_compile_types[itype - 1].compilers;
+				for (icmp = 0, isize = array_size(compilers); !success && (icmp != isize);
+				     ++icmp) {
+					success = (compilers[icmp](uuid, platform, &source, target->source_hash,
+					                           STRING_ARGS(type)) == 0);
+					++target->internal;
+				}
+			}
+
+			for (icmp = 0, isize = array_size(_resource_compilers); !success && (icmp != isize);
+			     ++icmp) {
+				success = (_resource_compilers[icmp](uuid, platform, &source, target->source_hash,
+				                                     STRING_ARGS(type)) == 0);
+				++target->internal;
+			}
+			set_thread_resource_compile_recorder(parent);
+			if (success)
+				resource_compile_commit_dependencies(uuid, platform, recorder.deps);
+			array_deallocate(recorder.deps);
+
+			target->success = success;
+			if (metrics)
+				target->phase[RESOURCEMETRIC_INTERNAL] = time_diff(start, time_current());
 		}
 	}
 	resource_source_finalize(&source);
 
 	// Try external tools
-	for (size_t ipath = 0, psize = array_size(_resource_compile_tool_path);
-	     !success && (ipath != psize); ++ipath) {
-		string_t* tools = fs_matching_files(STRING_ARGS(_resource_compile_tool_path[ipath]),
-		                                    STRING_CONST(RESOURCE_COMPILER_PATTERN), true);
-		for (size_t itool = 0, tsize = array_size(tools); !success && (itool != tsize); ++itool) {
-			char buffer[BUILD_MAX_PATHLEN];
-			string_t fullpath =
-			    path_concat(buffer, sizeof(buffer), STRING_ARGS(_resource_compile_tool_path[ipath]),
-			                STRING_ARGS(tools[itool]));
-
-			process_t proc;
-			process_initialize(&proc);
-
-			string_const_t wd = environment_current_working_directory();
-			process_set_working_directory(&proc, STRING_ARGS(wd));
-			process_set_executable_path(&proc, STRING_ARGS(fullpath));
-
-			string_const_t* args = nullptr;
-			char platformarr[34];
-			array_push(args, string_to_const(uuidstr));
-			if (platform) {
-				string_t platformstr =
-				    string_from_uint(platformarr, sizeof(platformarr), platform, true, 0, 0);
-				array_push(args, string_const(STRING_CONST("--platform")));
-				array_push(args, string_to_const(platformstr));
-			}
-			array_push(args, string_const(STRING_CONST("--")));
+	resource_compile_external(uuid, uuidstr, targets, num_targets);
 
-			const string_const_t* local_paths = resource_local_paths();
-			for (size_t ilocal = 0, lsize = array_size(local_paths); ilocal < lsize; ++ilocal) {
-				array_push(args, string_const(STRING_CONST("--resource-local-path")));
-				array_push(args, local_paths[ilocal]);
-			}
+	error_context_pop();
 
-			string_const_t local_source = resource_source_path();
-			if (local_source.length) {
-				array_push(args, string_const(STRING_CONST("--resource-source-path")));
-				array_push(args, local_source);
+	for (size_t itarget = 0; itarget < num_targets; ++itarget) {
+		resource_compile_target_t* target = targets + itarget;
+		uint64_t platform = target->platform;
+		if (!target->pending)
+			continue;
+		if (metrics) {
+			// Compile phases are kept per resource type, source read and collapse once read
+			for (int iphase = RESOURCEMETRIC_SOURCE_READ; iphase < RESOURCEMETRIC_PHASE_COUNT;
+			     ++iphase) {
+				if ((iphase == RESOURCEMETRIC_SOURCE_READ) ||
+				    ((iphase == RESOURCEMETRIC_COLLAPSE) && was_read) ||
+				    ((iphase == RESOURCEMETRIC_INTERNAL) && target->internal) ||
+				    ((iphase == RESOURCEMETRIC_EXTERNAL) && target->external))
+					resource_metrics_time(STRING_ARGS(target->type), platform,
+					                      (resource_metric_phase)iphase, target->phase[iphase]);
 			}
-
-			string_const_t remote_sourced = resource_remote_sourced();
-			if (remote_sourced.length) {
-				array_push(args, string_const(STRING_CONST("--resource-remote-sourced")));
-				array_push(args, remote_sourced);
+			resource_metrics_count(STRING_ARGS(target->type), platform,
+			                       target->success ? RESOURCEMETRIC_COMPILED :
+			                                         RESOURCEMETRIC_FAILED);
+		}
+		if (!target->success) {
+			log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+			          STRING_CONST("Unable to compile: %.*s (platform 0x%" PRIx64 ") (%" PRIsize
+			                       " internal, %" PRIsize " external)"),
+			          STRING_FORMAT(uuidstr), platform, target->internal, target->external);
+			char diagbuf[512];
+			string_t diag = string_format(
+			    diagbuf, sizeof(diagbuf),
+			    STRING_CONST("%s, type %.*s, %" PRIsize " internal and %" PRIsize
+			                 " external compilers failed%s%.*s"),
+			    was_read ? "Source read" : "Unable to read source", STRING_FORMAT(target->type),
+			    target->internal, target->external, target->tools.length ? ": " : "",
+			    STRING_FORMAT(target->tools));
+			// A cancelled compile says nothing about the inputs
+			if (!target->cancelled) {
+				hash_t fingerprint =
+				    resource_compile_fingerprint(identity, uuid, platform, target->source_hash);
+				resource_failure_record(RESOURCEFAILURE_COMPILE, target->failkey, fingerprint,
+				                        STRING_ARGS(diag));
 			}
+		} else {
+			++num_success;
+			resource_failure_forget(RESOURCEFAILURE_COMPILE, target->failkey);
+			log_infof(HASH_RESOURCE, STRING_CONST("Compiled: %.*s (platform 0x%" PRIx64 ")"),
+			          STRING_FORMAT(uuidstr), platform);
+			if (uint256_is_null(target->source_hash))
+				target->source_hash = resource_source_hash(uuid, platform);
+			// Dependencies recorded during the compile are part of the stored key
+			target->fingerprint =
+			    resource_compile_fingerprint(identity, uuid, platform, target->source_hash);
+			resource_cache_store(target->fingerprint, uuid, platform, target->source_hash);
+			hash_t token = resource_compile_token();
+			resource_event_post(RESOURCEEVENT_COMPILE, uuid, platform, token);
+		}
+	}
 
-			process_set_arguments(&proc, args, array_size(args));
-			process_set_flags(&proc, PROCESS_STDSTREAMS | PROCESS_DETACHED);
-			process_spawn(&proc);
-
-			stream_t* err = process_stderr(&proc);
-			stream_finalize(process_stdout(&proc));
-			while (!stream_eos(err)) {
-				string_t line = stream_read_line_buffer(err, buffer, sizeof(buffer), '\n');
-				if (line.length) {
-					if (line.str[line.length - 1] == '\r')
-						--line.length;
-					log_infof(HASH_RESOURCE, STRING_CONST("%.*s: %.*s"),
-					          STRING_FORMAT(tools[itool]), STRING_FORMAT(line));
-				}
-			}
-			int exit_code = process_wait(&proc);
-			while (exit_code == PROCESS_STILL_ACTIVE) {
-				thread_yield();
-				exit_code = process_wait(&proc);
-			}
-			if (exit_code == 0) {
-				log_debugf(HASH_RESOURCE, STRING_CONST("Compiled with external tool: %.*s"),
-				           STRING_FORMAT(tools[itool]));
-				success = true;
-			} else {
-				log_debugf(HASH_RESOURCE,
-				           STRING_CONST("Failed compiling with external tool: %.*s (%d)"),
-				           STRING_FORMAT(tools[itool]), exit_code);
-			}
+	return num_success;
+}
 
-			process_finalize(&proc);
-			array_deallocate(args);
+bool
+resource_compile_node(const uuid_t uuid, uint64_t platform) {
+	if (!resource_module_config().enable_local_source &&
+	    !resource_module_config().enable_remote_sourced)
+		return false;
 
-			++external;
-		}
-		string_array_deallocate(tools);
-	}
+	resource_compile_target_t target;
+	target.platform = platform;
+	return resource_compile_targets(uuid, &target, 1) == 1;
+}
 
-	error_context_pop();
+bool
+resource_compile_platforms(const uuid_t uuid, const uint64_t* platforms, size_t num_platforms) {
+	if (!resource_module_config().enable_local_source &&
+	    !resource_module_config().enable_remote_sourced)
+		return false;
+	if (!num_platforms)
+		return true;
+
+	char uuidbuf[40];
+	const string_t uuidstr = string_from_uuid(uuidbuf, sizeof(uuidbuf), uuid);
 
-	if (!success) {
-		log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
-		          STRING_CONST("Unable to compile: %.*s (platform 0x%" PRIx64 ") (%" PRIsize
-		                       " internal, %" PRIsize " external)"),
-		          STRING_FORMAT(uuidstr), platform, internal, external);
-	} else {
-		log_infof(HASH_RESOURCE, STRING_CONST("Compiled: %.*s (platform 0x%" PRIx64 ")"),
-		          STRING_FORMAT(uuidstr), platform);
-		hash_t token = resource_compile_token();
-		resource_event_post(RESOURCEEVENT_COMPILE, uuid, platform, token);
+	// Dependencies of all platforms share one session so shared dependencies are
+	// checked and compiled once
+	resource_compile_recorder_t* recorder = resource_compile_record_suspend();
+	resource_compile_session_t* session = resource_compile_session_allocate();
+	resource_compile_target_t* targets =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_compile_target_t) * num_platforms, 0,
+	                    MEMORY_PERSISTENT);
+	size_t num_targets = 0;
+	for (size_t iplat = 0; iplat < num_platforms; ++iplat) {
+		error_context_push(STRING_CONST("compiling resource"), STRING_ARGS(uuidstr));
+		bool depsuccess = resource_compile_dependencies(session, uuid, platforms[iplat], uuidstr);
+		error_context_pop();
+		if (depsuccess)
+			targets[num_targets++].platform = platforms[iplat];
 	}
+	resource_compile_session_deallocate(session);
 
-	return success;
+	size_t num_success = num_targets ? resource_compile_targets(uuid, targets, num_targets) : 0;
+	memory_deallocate(targets);
+	resource_compile_record_resume(recorder);
+
+	return num_success == num_platforms;
 }
 
 void
@@ -324,20 +1188,35 @@ resource_compile_register(resource_compile_fn compiler) {
 			return;
 	}
 	array_push(_resource_compilers, compiler);
+	resource_compile_identity_invalidate();
 }
 
 void
-resource_compile_register_path(const char* path, size_t length) {
-	size_t iimp, isize;
-	char buffer[BUILD_MAX_PATHLEN];
-	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
-	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
-	for (iimp = 0, isize = array_size(_resource_compile_tool_path); iimp != isize; ++iimp) {
-		if (string_equal(STRING_ARGS(_resource_compile_tool_path[iimp]), STRING_ARGS(pathstr)))
-			return;
+resource_compile_register_types(resource_compile_fn compiler, const hash_t* types,
+                               size_t num_types) {
+	for (size_t itype = 0; itype < num_types; ++itype) {
+		size_t index = (size_t)(uintptr_t)hashmap_lookup(_resource_compile_type_map, types[itype]);
+		if (!index) {
+			resource_compile_type_t entry = {types[itype], nullptr};
+			array_push(_resource_compile_types, entry);
+			index = array_size(_resource_compile_types);
+			hashmap_insert(_resource_compile_type_map, types[itype], (void*)(uintptr_t)index);
+		}
+		resource_compile_type_t* entry = _resource_compile_types + (index - 1);
+		size_t icmp, isize;
+		for (icmp = 0, isize = array_size(entry->compilers); icmp != isize; ++icmp) {
+			if (entry->compilers[icmp] == compiler)
+				break;
+		}
+		if (icmp == isize)
+			array_push(entry->compilers, compiler);
 	}
-	pathstr = string_clone(STRING_ARGS(pathstr));
-	array_push(_resource_compile_tool_path, pathstr);
+	resource_compile_identity_invalidate();
+}
+
+void
+resource_compile_register_path(const char* path, size_t length) {
+	resource_tool_register_path(RESOURCETOOL_COMPILE, path, length);
 }
 
 void
@@ -346,35 +1225,37 @@ resource_compile_unregister(resource_compile_fn compiler) {
 	for (icmp = 0, isize = array_size(_resource_compilers); icmp != isize; ++icmp) {
 		if (_resource_compilers[icmp] == compiler) {
 			array_erase(_resource_compilers, icmp);
-			return;
+			break;
 		}
 	}
+	for (size_t itype = 0, tsize = array_size(_resource_compile_types); itype != tsize; ++itype) {
+		resource_compile_type_t* entry = _resource_compile_types + itype;
+		for (icmp = 0, isize = array_size(entry->compilers); icmp != isize; ++icmp) {
+			if (entry->compilers[icmp] == compiler) {
+				array_erase(entry->compilers, icmp);
+				break;
+			}
+		}
+	}
+	resource_compile_identity_invalidate();
 }
 
 void
 resource_compile_unregister_path(const char* path, size_t length) {
-	size_t iimp, isize;
-	char buffer[BUILD_MAX_PATHLEN];
-	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
-	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
-	for (iimp = 0, isize = array_size(_resource_compile_tool_path); iimp != isize; ++iimp) {
-		if (string_equal(STRING_ARGS(_resource_compile_tool_path[iimp]), STRING_ARGS(pathstr))) {
-			string_deallocate(_resource_compile_tool_path[iimp].str);
-			array_erase(_resource_compile_tool_path, iimp);
-			break;
-		}
-	}
+	resource_tool_unregister_path(RESOURCETOOL_COMPILE, path, length);
 }
 
 void
 resource_compile_clear(void) {
 	array_clear(_resource_compilers);
+	for (size_t itype = 0, tsize = array_size(_resource_compile_types); itype != tsize; ++itype)
+		array_clear(_resource_compile_types[itype].compilers);
+	resource_compile_identity_invalidate();
 }
 
 void
 resource_compile_clear_path(void) {
-	string_array_deallocate_elements(_resource_compile_tool_path);
-	array_clear(_resource_compile_tool_path);
+	resource_tool_clear_paths(RESOURCETOOL_COMPILE);
 }
 
 #else
@@ -386,6 +1267,22 @@ resource_compile_need_update(const uuid_t uuid, uint64_t platform) {
 	return false;
 }
 
+bool
+resource_compile_need_update_node(const uuid_t uuid, uint64_t platform) {
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	return false;
+}
+
+bool
+resource_compile_session_need_update(resource_compile_session_t* session, const uuid_t uuid,
+                                     uint64_t platform) {
+	FOUNDATION_UNUSED(session);
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	return false;
+}
+
 bool
 resource_compile(const uuid_t uuid, uint64_t platform) {
 	FOUNDATION_UNUSED(uuid);
@@ -393,11 +1290,43 @@ resource_compile(const uuid_t uuid, uint64_t platform) {
 	return true;
 }
 
+bool
+resource_compile_session(resource_compile_session_t* session, const uuid_t uuid,
+                         uint64_t platform) {
+	FOUNDATION_UNUSED(session);
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	return true;
+}
+
+bool
+resource_compile_node(const uuid_t uuid, uint64_t platform) {
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	return true;
+}
+
+bool
+resource_compile_platforms(const uuid_t uuid, const uint64_t* platforms, size_t num_platforms) {
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platforms);
+	FOUNDATION_UNUSED(num_platforms);
+	return true;
+}
+
 void
 resource_compile_register(resource_compile_fn compiler) {
 	FOUNDATION_UNUSED(compiler);
 }
 
+void
+resource_compile_register_types(resource_compile_fn compiler, const hash_t* types,
+                               size_t num_types) {
+	FOUNDATION_UNUSED(compiler);
+	FOUNDATION_UNUSED(types);
+	FOUNDATION_UNUSED(num_types);
+}
+
 void
 resource_compile_register_path(const char* path, size_t length) {
 	FOUNDATION_UNUSED(path);
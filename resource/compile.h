@@ -31,9 +31,72 @@ resource_compile_hash(const uuid_t uuid, uint64_t platform);
 RESOURCE_API bool
 resource_compile(const uuid_t uuid, uint64_t platform);
 
+/*! Compile resource for multiple platforms. Dependencies are compiled once per
+platform, the resource source is read and collapsed once and shared by compilers
+for all platforms. External tools declaring "platforms multiple" in their manifest
+are invoked once with a --platform argument for each platform.
+\param uuid Resource UUID
+\param platforms Platforms
+\param num_platforms Number of platforms
+\return true if resource compiled successfully for all platforms, false if not */
+RESOURCE_API bool
+resource_compile_platforms(const uuid_t uuid, const uint64_t* platforms, size_t num_platforms);
+
+/*! Cancel an in-flight compile of a resource by killing the external compiler
+tools running for it, including tool invocations given a list of platforms. No further
+external tools are tried for the cancelled compile, which fails without being recorded
+as a failure of the resource.
+\param uuid Resource UUID
+\param platform Resource platform
+\return true if a running tool was cancelled, false if not */
+RESOURCE_API bool
+resource_compile_cancel(const uuid_t uuid, uint64_t platform);
+
+/*! Allocate a compile session. A session memoizes need-update checks and compile
+results per resource and platform, so each resource is checked and compiled at
+most once during a build pass. Sessions are thread safe, a thread reaching a resource
+being processed by another thread waits for the result, and a resource reached again
+through its own dependencies fails to compile as a dependency cycle.
+\return New compile session */
+RESOURCE_API resource_compile_session_t*
+resource_compile_session_allocate(void);
+
+/*! Deallocate a compile session
+\param session Compile session */
+RESOURCE_API void
+resource_compile_session_deallocate(resource_compile_session_t* session);
+
+/*! Check if resource needs update, reusing results already computed in the session
+\param session Compile session
+\param uuid Resource UUID
+\param platform Resource platform
+\return true if resource needs to be compiled, false if not */
+RESOURCE_API bool
+resource_compile_session_need_update(resource_compile_session_t* session, const uuid_t uuid,
+                                     uint64_t platform);
+
+/*! Compile resource unless already compiled in the session
+\param session Compile session
+\param uuid Resource UUID
+\param platform Resource platform
+\return true if resource compiled successfully, false if not */
+RESOURCE_API bool
+resource_compile_session(resource_compile_session_t* session, const uuid_t uuid,
+                         uint64_t platform);
+
 RESOURCE_API void
 resource_compile_register(resource_compile_fn compiler);
 
+/*! Register a compiler for the given resource types. Compilers registered with
+types are dispatched by the type hash of the resource, while compilers registered
+with resource_compile_register are tried for any type.
+\param compiler Compiler function
+\param types Resource type hashes
+\param num_types Number of resource types */
+RESOURCE_API void
+resource_compile_register_types(resource_compile_fn compiler, const hash_t* types,
+                               size_t num_types);
+
 RESOURCE_API void
 resource_compile_register_path(const char* path, size_t length);
 
@@ -123,3 +123,38 @@ compiled_read_notify(socket_t* sock, size_t size, compiled_notify_t* notify) {
 		return 0;
 	return -1;
 }
+
+int
+compiled_write_metrics(socket_t* sock) {
+	compiled_message_t msg = {
+		COMPILED_METRICS,
+		0
+	};
+	if (socket_write(sock, &msg, sizeof(msg)) == sizeof(msg))
+		return 0;
+	return -1;
+}
+
+int
+compiled_write_metrics_reply(socket_t* sock, bool success) {
+	compiled_message_t msg = {
+		COMPILED_METRICS_RESULT,
+		(uint32_t)sizeof(compiled_reply_t)
+	};
+	compiled_reply_t reply = {
+		success ? COMPILED_OK : COMPILED_FAILED,
+		0
+	};
+	if (socket_write(sock, &msg, sizeof(msg)) == sizeof(msg))
+		if (socket_write(sock, &reply, sizeof(reply)) == sizeof(reply))
+			return 0;
+	return -1;
+}
+
+int
+compiled_read_metrics_reply(socket_t* sock, size_t size, compiled_reply_t* result) {
+	if ((size == sizeof(compiled_reply_t)) &&
+	    (socket_read(sock, result, size) == size))
+		return 0;
+	return -1;
+}
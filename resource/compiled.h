@@ -33,7 +33,10 @@ enum compiled_message_id {
 	COMPILED_NOTIFY_CREATE,
 	COMPILED_NOTIFY_MODIFY,
 	COMPILED_NOTIFY_DEPENDS,
-	COMPILED_NOTIFY_DELETE
+	COMPILED_NOTIFY_DELETE,
+
+	COMPILED_METRICS,
+	COMPILED_METRICS_RESULT
 };
 
 enum compiled_result_id {
@@ -45,6 +48,7 @@ typedef enum compiled_message_id compiled_message_id;
 typedef enum compiled_result_id compiled_result_id;
 
 typedef struct compiled_message_t compiled_message_t;
+typedef struct compiled_reply_t compiled_reply_t;
 typedef struct compiled_open_static_t compiled_open_static_t;
 typedef struct compiled_open_dynamic_t compiled_open_dynamic_t;
 typedef struct compiled_open_result_t compiled_open_result_t;
@@ -62,6 +66,10 @@ struct compiled_message_t {
 	COMPILED_DECLARE_MESSAGE;
 };
 
+struct compiled_reply_t {
+	COMPILED_DECLARE_REPLY;
+};
+
 struct compiled_open_static_t {
 	COMPILED_DECLARE_MESSAGE;
 	uuid_t uuid;
@@ -109,3 +117,12 @@ compiled_write_notify(socket_t* sock, compiled_message_id id, uuid_t uuid, uint6
 
 int
 compiled_read_notify(socket_t* sock, size_t size, compiled_notify_t* notify);
+
+int
+compiled_write_metrics(socket_t* sock);
+
+int
+compiled_write_metrics_reply(socket_t* sock, bool success);
+
+int
+compiled_read_metrics_reply(socket_t* sock, size_t size, compiled_reply_t* result);
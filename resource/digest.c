@@ -0,0 +1,430 @@
+/* digest.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+/* Fast hash in the style of XXH3, 256-bit output. Input is processed in stripes of 64
+   bytes into eight 64-bit lane accumulators with a 32x32->64 bit multiply per lane, and
+   the accumulators are scrambled after each block of 16 stripes. The lane loops have no
+   dependencies between lanes within a stripe so compilers vectorize them (SSE2, AVX2,
+   NEON). The final block is zero padded and the total length is mixed into the result.
+   Input words are read in little endian byte order so hashes are stable across platforms. */
+
+#define RESOURCE_DIGEST_LANES 8
+#define RESOURCE_DIGEST_STRIPE_SIZE 64
+#define RESOURCE_DIGEST_STRIPES (RESOURCE_DIGEST_BLOCK_SIZE / RESOURCE_DIGEST_STRIPE_SIZE)
+#define RESOURCE_DIGEST_READ_SIZE (64 * 1024)
+
+static const uint64_t _resource_digest_key[RESOURCE_DIGEST_STRIPES + RESOURCE_DIGEST_LANES] = {
+	0x2cb0f69f4abea221ULL, 0x9417034723148989ULL, 0xdd555950609dfe03ULL,
+	0xdbafb150deb12800ULL, 0x7e789b2e6c442cb6ULL, 0xf41e5636c7e4f8c4ULL,
+	0x0959d150f8fba7e4ULL, 0xa97316f13cdb9eeaULL, 0x74cd8258f9520068ULL,
+	0x55c74a62e116868bULL, 0xd2f4c799a2023cbdULL, 0xdf98cb79a37b51b9ULL,
+	0x396f5885524f3905ULL, 0xaf1d56386ca3b276ULL, 0xa9ffbe6b5104e85aULL,
+	0x6bd0c51b9fd533b3ULL, 0x980ce91c50ab4b56ULL, 0x28ac395780fe62c5ULL,
+	0x768912e3a6bcedc7ULL, 0x50b3e8c9332c7c88ULL, 0xce3bbfe520bd47daULL,
+	0xcba6c8e8e0bb7c4fULL, 0xbf194db8434a346dULL, 0x7d8f2a7b60416d7fULL,
+};
+
+resource_hash_algorithm
+resource_digest_algorithm(void) {
+	return (resource_module_config().content_hash == RESOURCEHASH_FAST) ? RESOURCEHASH_FAST :
+	                                                                      RESOURCEHASH_SHA256;
+}
+
+string_const_t
+resource_digest_algorithm_name(resource_hash_algorithm algorithm) {
+	if (algorithm == RESOURCEHASH_FAST)
+		return string_const(STRING_CONST("fast"));
+	return string_const(STRING_CONST("sha256"));
+}
+
+static uint64_t
+resource_digest_read64(const uint8_t* data) {
+	// Compilers reduce this to a single load on little endian targets
+	return (uint64_t)data[0] | ((uint64_t)data[1] << 8) | ((uint64_t)data[2] << 16) |
+	       ((uint64_t)data[3] << 24) | ((uint64_t)data[4] << 32) | ((uint64_t)data[5] << 40) |
+	       ((uint64_t)data[6] << 48) | ((uint64_t)data[7] << 56);
+}
+
+static void
+resource_digest_accumulate(uint64_t* acc, const uint8_t* stripe, const uint64_t* key) {
+	for (size_t ilane = 0; ilane < RESOURCE_DIGEST_LANES; ++ilane) {
+		uint64_t value = resource_digest_read64(stripe + (ilane * sizeof(uint64_t)));
+		uint64_t keyed = value ^ key[ilane];
+		acc[ilane ^ 1] += value;
+		acc[ilane] += (keyed & 0xFFFFFFFFULL) * (keyed >> 32);
+	}
+}
+
+static void
+resource_digest_scramble(uint64_t* acc) {
+	const uint64_t* key = _resource_digest_key + RESOURCE_DIGEST_STRIPES;
+	for (size_t ilane = 0; ilane < RESOURCE_DIGEST_LANES; ++ilane) {
+		uint64_t value = acc[ilane];
+		value ^= value >> 47;
+		value ^= key[ilane];
+		value *= 0x9E3779B1ULL;
+		acc[ilane] = value;
+	}
+}
+
+static void
+resource_digest_block(uint64_t* acc, const uint8_t* block) {
+	for (size_t istripe = 0; istripe < RESOURCE_DIGEST_STRIPES; ++istripe)
+		resource_digest_accumulate(acc, block + (istripe * RESOURCE_DIGEST_STRIPE_SIZE),
+		                           _resource_digest_key + istripe);
+	resource_digest_scramble(acc);
+}
+
+static uint64_t
+resource_digest_mix(uint64_t value) {
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ULL;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebULL;
+	value ^= value >> 31;
+	return value;
+}
+
+void
+resource_digest_initialize(resource_digest_t* digest, resource_hash_algorithm algorithm) {
+	digest->algorithm = algorithm;
+	digest->total = 0;
+	digest->buffered = 0;
+	if (algorithm == RESOURCEHASH_FAST) {
+		for (size_t ilane = 0; ilane < RESOURCE_DIGEST_LANES; ++ilane)
+			digest->acc[ilane] = _resource_digest_key[RESOURCE_DIGEST_STRIPES + ilane] ^
+			                     _resource_digest_key[ilane];
+	} else {
+		sha256_initialize(&digest->sha);
+	}
+}
+
+void
+resource_digest_update(resource_digest_t* digest, const void* data, size_t size) {
+	if (digest->algorithm != RESOURCEHASH_FAST) {
+		sha256_digest(&digest->sha, data, size);
+		return;
+	}
+
+	const uint8_t* input = data;
+	digest->total += size;
+	if (digest->buffered) {
+		size_t fill = RESOURCE_DIGEST_BLOCK_SIZE - digest->buffered;
+		if (size <= fill) {
+			memcpy(digest->buffer + digest->buffered, input, size);
+			digest->buffered += size;
+			return;
+		}
+		memcpy(digest->buffer + digest->buffered, input, fill);
+		resource_digest_block(digest->acc, digest->buffer);
+		digest->buffered = 0;
+		input += fill;
+		size -= fill;
+	}
+	// Keep a trailing full block buffered, the final block is processed with padding
+	while (size > RESOURCE_DIGEST_BLOCK_SIZE) {
+		resource_digest_block(digest->acc, input);
+		input += RESOURCE_DIGEST_BLOCK_SIZE;
+		size -= RESOURCE_DIGEST_BLOCK_SIZE;
+	}
+	memcpy(digest->buffer, input, size);
+	digest->buffered = size;
+}
+
+uint256_t
+resource_digest_finalize(resource_digest_t* digest) {
+	if (digest->algorithm != RESOURCEHASH_FAST) {
+		sha256_digest_finalize(&digest->sha);
+		return sha256_get_digest_raw(&digest->sha);
+	}
+
+	uint64_t acc[RESOURCE_DIGEST_LANES];
+	memcpy(acc, digest->acc, sizeof(acc));
+	size_t stripes = digest->buffered / RESOURCE_DIGEST_STRIPE_SIZE;
+	size_t remain = digest->buffered % RESOURCE_DIGEST_STRIPE_SIZE;
+	for (size_t istripe = 0; istripe < stripes; ++istripe)
+		resource_digest_accumulate(acc, digest->buffer + (istripe * RESOURCE_DIGEST_STRIPE_SIZE),
+		                           _resource_digest_key + istripe);
+	if (remain) {
+		uint8_t stripe[RESOURCE_DIGEST_STRIPE_SIZE];
+		memset(stripe, 0, sizeof(stripe));
+		memcpy(stripe, digest->buffer + (stripes * RESOURCE_DIGEST_STRIPE_SIZE), remain);
+		resource_digest_accumulate(acc, stripe, _resource_digest_key + stripes);
+	}
+
+	uint256_t result;
+	for (size_t iword = 0; iword < 4; ++iword) {
+		uint64_t value = (digest->total * 0x9E3779B97F4A7C15ULL) + iword;
+		for (size_t ilane = 0; ilane < RESOURCE_DIGEST_LANES; ++ilane)
+			value = resource_digest_mix(value ^ acc[(ilane + (iword * 2)) % RESOURCE_DIGEST_LANES] ^
+			                            _resource_digest_key[ilane + iword]);
+		result.word[iword] = value;
+	}
+	return result;
+}
+
+uint256_t
+resource_digest_buffer(const void* data, size_t size, resource_hash_algorithm algorithm) {
+	resource_digest_t digest;
+	resource_digest_initialize(&digest, algorithm);
+	resource_digest_update(&digest, data, size);
+	return resource_digest_finalize(&digest);
+}
+
+uint256_t
+resource_digest_stream(stream_t* stream, resource_hash_algorithm algorithm) {
+	if (algorithm != RESOURCEHASH_FAST)
+		return stream_sha256(stream);
+
+	if (!stream || stream_is_sequential(stream))
+		return uint256_null();
+
+	size_t cur = stream_tell(stream);
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+
+	resource_digest_t digest;
+	resource_digest_initialize(&digest, algorithm);
+	void* buffer =
+	    memory_allocate(HASH_RESOURCE, RESOURCE_DIGEST_READ_SIZE, 0, MEMORY_TEMPORARY);
+	while (!stream_eos(stream)) {
+		size_t num = stream_read(stream, buffer, RESOURCE_DIGEST_READ_SIZE);
+		if (!num)
+			break;
+		resource_digest_update(&digest, buffer, num);
+	}
+	memory_deallocate(buffer);
+
+	stream_seek(stream, (ssize_t)cur, STREAM_SEEK_BEGIN);
+	return resource_digest_finalize(&digest);
+}
+
+/* Multi-buffer SHA-256, hashing up to RESOURCE_DIGEST_SHA256_LANES messages in lockstep
+   with the state of each message in one lane of structure of arrays words. The lane
+   loops are independent so compilers vectorize them, four lanes per register with the
+   SSE baseline of the x86-64 builds. The block function is also compiled for AVX2, eight
+   lanes in one register, and selected at runtime when the processor supports it.
+   A lane that finishes its message is refilled with the next message in the batch. */
+
+#if FOUNDATION_ARCH_X86_64 && (FOUNDATION_COMPILER_CLANG || FOUNDATION_COMPILER_GCC)
+#define RESOURCE_DIGEST_SHA256_AVX2 1
+#else
+#define RESOURCE_DIGEST_SHA256_AVX2 0
+#endif
+
+static const uint32_t _resource_digest_sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+	0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+	0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+	0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+	0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+	0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+	0xc67178f2};
+
+static const uint32_t _resource_digest_sha256_init[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab,
+	0x5be0cd19};
+
+#define RESOURCE_DIGEST_SHA256_LANES 8
+
+typedef struct resource_digest_sha256_lane_t resource_digest_sha256_lane_t;
+
+struct resource_digest_sha256_lane_t {
+	//! Next full block of message data
+	const uint8_t* data;
+	//! Number of full blocks left in message data
+	size_t blocks;
+	//! Next padded tail block
+	const uint8_t* tailnext;
+	//! Number of padded tail blocks left
+	size_t tailblocks;
+	//! Index of message in batch
+	size_t index;
+	bool active;
+	//! Last partial block of message with padding and length
+	uint8_t tail[128];
+};
+
+static FOUNDATION_FORCEINLINE uint32_t
+resource_digest_rotr(uint32_t value, unsigned int bits) {
+	return (value >> bits) | (value << (32 - bits));
+}
+
+static void
+resource_digest_sha256_lane_start(resource_digest_sha256_lane_t* lane, const void* data,
+                                  size_t size, size_t index) {
+	size_t remain = size % 64;
+	lane->data = data;
+	lane->blocks = size / 64;
+	lane->tailblocks = (remain + 9 > 64) ? 2 : 1;
+	lane->tailnext = lane->tail;
+	lane->index = index;
+	lane->active = true;
+	memset(lane->tail, 0, sizeof(lane->tail));
+	if (remain)
+		memcpy(lane->tail, (const uint8_t*)data + (size - remain), remain);
+	lane->tail[remain] = 0x80;
+	uint64_t bits = (uint64_t)size * 8;
+	uint8_t* length = lane->tail + (lane->tailblocks * 64) - 8;
+	for (int ibyte = 0; ibyte < 8; ++ibyte)
+		length[ibyte] = (uint8_t)(bits >> (56 - (ibyte * 8)));
+}
+
+static FOUNDATION_FORCEINLINE void
+resource_digest_sha256_blocks(uint32_t state[8][RESOURCE_DIGEST_SHA256_LANES],
+                              const uint8_t* const* block) {
+	const size_t lanes = RESOURCE_DIGEST_SHA256_LANES;
+	uint32_t w[64][RESOURCE_DIGEST_SHA256_LANES];
+	uint32_t v[8][RESOURCE_DIGEST_SHA256_LANES];
+	for (size_t ilane = 0; ilane < lanes; ++ilane) {
+		for (size_t iword = 0; iword < 16; ++iword) {
+			const uint8_t* word = block[ilane] + (iword * 4);
+			w[iword][ilane] = ((uint32_t)word[0] << 24) | ((uint32_t)word[1] << 16) |
+			                  ((uint32_t)word[2] << 8) | (uint32_t)word[3];
+		}
+	}
+	for (size_t iword = 16; iword < 64; ++iword) {
+		for (size_t ilane = 0; ilane < lanes; ++ilane) {
+			uint32_t w15 = w[iword - 15][ilane];
+			uint32_t w2 = w[iword - 2][ilane];
+			uint32_t s0 =
+			    resource_digest_rotr(w15, 7) ^ resource_digest_rotr(w15, 18) ^ (w15 >> 3);
+			uint32_t s1 =
+			    resource_digest_rotr(w2, 17) ^ resource_digest_rotr(w2, 19) ^ (w2 >> 10);
+			w[iword][ilane] = w[iword - 16][ilane] + s0 + w[iword - 7][ilane] + s1;
+		}
+	}
+
+	memcpy(v, state, sizeof(v));
+	for (size_t iround = 0; iround < 64; ++iround) {
+		for (size_t ilane = 0; ilane < lanes; ++ilane) {
+			uint32_t a = v[0][ilane], b = v[1][ilane], c = v[2][ilane], d = v[3][ilane];
+			uint32_t e = v[4][ilane], f = v[5][ilane], g = v[6][ilane], h = v[7][ilane];
+			uint32_t s1 = resource_digest_rotr(e, 6) ^ resource_digest_rotr(e, 11) ^
+			              resource_digest_rotr(e, 25);
+			uint32_t ch = (e & f) ^ (~e & g);
+			uint32_t t1 = h + s1 + ch + _resource_digest_sha256_k[iround] + w[iround][ilane];
+			uint32_t s0 = resource_digest_rotr(a, 2) ^ resource_digest_rotr(a, 13) ^
+			              resource_digest_rotr(a, 22);
+			uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+			v[7][ilane] = g;
+			v[6][ilane] = f;
+			v[5][ilane] = e;
+			v[4][ilane] = d + t1;
+			v[3][ilane] = c;
+			v[2][ilane] = b;
+			v[1][ilane] = a;
+			v[0][ilane] = t1 + s0 + maj;
+		}
+	}
+	for (size_t iword = 0; iword < 8; ++iword) {
+		for (size_t ilane = 0; ilane < lanes; ++ilane)
+			state[iword][ilane] += v[iword][ilane];
+	}
+}
+
+static void
+resource_digest_sha256_blocks_generic(uint32_t state[8][RESOURCE_DIGEST_SHA256_LANES],
+                                      const uint8_t* const* block) {
+	resource_digest_sha256_blocks(state, block);
+}
+
+#if RESOURCE_DIGEST_SHA256_AVX2
+
+__attribute__((target("avx2"))) static void
+resource_digest_sha256_blocks_avx2(uint32_t state[8][RESOURCE_DIGEST_SHA256_LANES],
+                                   const uint8_t* const* block) {
+	resource_digest_sha256_blocks(state, block);
+}
+
+#endif
+
+void
+resource_digest_sha256_batch(const void* const* data, const size_t* size, size_t count,
+                             uint256_t* hashes) {
+	const size_t lanes = RESOURCE_DIGEST_SHA256_LANES;
+	resource_digest_sha256_lane_t lane[RESOURCE_DIGEST_SHA256_LANES];
+	uint32_t state[8][RESOURCE_DIGEST_SHA256_LANES];
+	static const uint8_t empty[64];
+
+	size_t next = 0;
+	size_t active = 0;
+	for (size_t ilane = 0; ilane < lanes; ++ilane) {
+		lane[ilane].active = false;
+		if (next < count) {
+			resource_digest_sha256_lane_start(lane + ilane, data[next], size[next], next);
+			++next;
+			++active;
+		}
+		for (size_t iword = 0; iword < 8; ++iword)
+			state[iword][ilane] = _resource_digest_sha256_init[iword];
+	}
+
+	void (*blocks)(uint32_t[8][RESOURCE_DIGEST_SHA256_LANES], const uint8_t* const*) =
+	    resource_digest_sha256_blocks_generic;
+#if RESOURCE_DIGEST_SHA256_AVX2
+	if (__builtin_cpu_supports("avx2"))
+		blocks = resource_digest_sha256_blocks_avx2;
+#endif
+
+	while (active) {
+		const uint8_t* block[RESOURCE_DIGEST_SHA256_LANES];
+		for (size_t ilane = 0; ilane < lanes; ++ilane) {
+			block[ilane] = empty;
+			if (lane[ilane].active)
+				block[ilane] = lane[ilane].blocks ? lane[ilane].data : lane[ilane].tailnext;
+		}
+		blocks(state, block);
+
+		for (size_t ilane = 0; ilane < lanes; ++ilane) {
+			resource_digest_sha256_lane_t* current = lane + ilane;
+			if (!current->active)
+				continue;
+			if (current->blocks) {
+				current->data += 64;
+				--current->blocks;
+				continue;
+			}
+			current->tailnext += 64;
+			if (--current->tailblocks)
+				continue;
+
+			uint256_t* result = hashes + current->index;
+			for (size_t iword = 0; iword < 4; ++iword)
+				result->word[iword] = ((uint64_t)state[iword * 2][ilane] << 32) |
+				                      (uint64_t)state[(iword * 2) + 1][ilane];
+			current->active = false;
+			--active;
+			if (next < count) {
+				resource_digest_sha256_lane_start(current, data[next], size[next], next);
+				++next;
+				++active;
+			}
+			for (size_t iword = 0; iword < 8; ++iword)
+				state[iword][ilane] = _resource_digest_sha256_init[iword];
+		}
+	}
+}
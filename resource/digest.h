@@ -0,0 +1,85 @@
+/* digest.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Get the configured hash algorithm for content change detection
+\return Hash algorithm */
+RESOURCE_API resource_hash_algorithm
+resource_digest_algorithm(void);
+
+/*! Get the name of a hash algorithm, as recorded in resource source hash files
+\param algorithm Hash algorithm
+\return Algorithm name */
+RESOURCE_API string_const_t
+resource_digest_algorithm_name(resource_hash_algorithm algorithm);
+
+/*! Initialize an incremental content digest
+\param digest Digest state
+\param algorithm Hash algorithm */
+RESOURCE_API void
+resource_digest_initialize(resource_digest_t* digest, resource_hash_algorithm algorithm);
+
+/*! Add data to an incremental content digest. The result does not depend on how the
+data is split over calls.
+\param digest Digest state
+\param data Data
+\param size Size of data in bytes */
+RESOURCE_API void
+resource_digest_update(resource_digest_t* digest, const void* data, size_t size);
+
+/*! Finalize an incremental content digest
+\param digest Digest state
+\return Hash of all digested data */
+RESOURCE_API uint256_t
+resource_digest_finalize(resource_digest_t* digest);
+
+/*! Hash a memory buffer
+\param data Data
+\param size Size of data in bytes
+\param algorithm Hash algorithm
+\return Hash of data */
+RESOURCE_API uint256_t
+resource_digest_buffer(const void* data, size_t size, resource_hash_algorithm algorithm);
+
+/*! Hash the content of a stream from the beginning, restoring the stream position
+afterwards. SHA-256 uses stream_sha256 which normalizes line endings in text mode
+streams, the fast hash always hashes the raw bytes.
+\param stream Stream
+\param algorithm Hash algorithm
+\return Hash of stream content, zero for sequential streams */
+RESOURCE_API uint256_t
+resource_digest_stream(stream_t* stream, resource_hash_algorithm algorithm);
+
+/*! Compute SHA-256 hashes of multiple buffers. Up to eight buffers are hashed in
+parallel in vector lanes, each lane picking up the next buffer as soon as its current
+buffer is done, which is several times faster than hashing the buffers one after another
+when there are many small to medium sized buffers. Results are identical to sha256_t
+digests of each buffer.
+\param data Buffers
+\param size Size of each buffer in bytes
+\param count Number of buffers
+\param hashes Array receiving hash of each buffer */
+RESOURCE_API void
+resource_digest_sha256_batch(const void* const* data, const size_t* size, size_t count,
+                             uint256_t* hashes);
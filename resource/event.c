@@ -92,4 +92,5 @@ resource_event_stream(void) {
 void
 resource_event_handle(event_t* event) {
 	resource_autoimport_event_handle(event);
+	resource_tool_event_handle(event);
 }
@@ -0,0 +1,176 @@
+/* failure.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+typedef struct resource_failure_t resource_failure_t;
+
+struct resource_failure_t {
+	//! Hash of the inputs the failed attempt was made with
+	hash_t fingerprint;
+	tick_t timestamp;
+	//! Number of failed attempts with the same inputs
+	unsigned int attempts;
+	//! Number of retries skipped since the last attempt
+	unsigned int skipped;
+	string_t diagnostics;
+	//! Index in list of records of the same type
+	size_t index;
+};
+
+static mutex_t* _resource_failure_lock;
+static hashmap_t* _resource_failure_map[RESOURCEFAILURE_COUNT];
+static resource_failure_t** _resource_failure_list[RESOURCEFAILURE_COUNT];
+
+int
+resource_failure_initialize(void) {
+	_resource_failure_lock = mutex_allocate(STRING_CONST("resource-failure"));
+	for (int itype = 0; itype < RESOURCEFAILURE_COUNT; ++itype)
+		_resource_failure_map[itype] = hashmap_allocate(257, 8);
+	return 0;
+}
+
+static void
+resource_failure_clear_map(resource_failure_type type) {
+	resource_failure_t** list = _resource_failure_list[type];
+	for (size_t ifail = 0, fsize = array_size(list); ifail < fsize; ++ifail) {
+		string_deallocate(list[ifail]->diagnostics.str);
+		memory_deallocate(list[ifail]);
+	}
+	array_clear(_resource_failure_list[type]);
+	hashmap_clear(_resource_failure_map[type]);
+}
+
+void
+resource_failure_finalize(void) {
+	for (int itype = 0; itype < RESOURCEFAILURE_COUNT; ++itype) {
+		resource_failure_clear_map((resource_failure_type)itype);
+		hashmap_deallocate(_resource_failure_map[itype]);
+		array_deallocate(_resource_failure_list[itype]);
+		_resource_failure_map[itype] = nullptr;
+		_resource_failure_list[itype] = nullptr;
+	}
+	mutex_deallocate(_resource_failure_lock);
+	_resource_failure_lock = nullptr;
+}
+
+bool
+resource_failure_recorded(resource_failure_type type, hash_t key) {
+	mutex_lock(_resource_failure_lock);
+	bool recorded = (hashmap_lookup(_resource_failure_map[type], key) != nullptr);
+	mutex_unlock(_resource_failure_lock);
+	return recorded;
+}
+
+bool
+resource_failure_check(resource_failure_type type, hash_t key, hash_t fingerprint) {
+	bool failed = false;
+	mutex_lock(_resource_failure_lock);
+	resource_failure_t* failure = hashmap_lookup(_resource_failure_map[type], key);
+	if (failure && (failure->fingerprint == fingerprint)) {
+		++failure->skipped;
+		failed = true;
+	}
+	mutex_unlock(_resource_failure_lock);
+	return failed;
+}
+
+void
+resource_failure_record(resource_failure_type type, hash_t key, hash_t fingerprint,
+                        const char* diagnostics, size_t length) {
+	mutex_lock(_resource_failure_lock);
+	resource_failure_t* failure = hashmap_lookup(_resource_failure_map[type], key);
+	if (!failure) {
+		failure = memory_allocate(HASH_RESOURCE, sizeof(resource_failure_t), 0,
+		                          MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		failure->index = array_size(_resource_failure_list[type]);
+		array_push(_resource_failure_list[type], failure);
+		hashmap_insert(_resource_failure_map[type], key, failure);
+	}
+	if (failure->fingerprint != fingerprint)
+		failure->attempts = 0;
+	failure->fingerprint = fingerprint;
+	failure->timestamp = time_current();
+	failure->skipped = 0;
+	++failure->attempts;
+	string_deallocate(failure->diagnostics.str);
+	failure->diagnostics = string_clone(diagnostics, length);
+	mutex_unlock(_resource_failure_lock);
+}
+
+void
+resource_failure_forget(resource_failure_type type, hash_t key) {
+	mutex_lock(_resource_failure_lock);
+	resource_failure_t* failure = hashmap_lookup(_resource_failure_map[type], key);
+	if (failure) {
+		hashmap_erase(_resource_failure_map[type], key);
+		resource_failure_t** list = _resource_failure_list[type];
+		size_t last = array_size(list) - 1;
+		if (failure->index != last) {
+			list[failure->index] = list[last];
+			list[failure->index]->index = failure->index;
+		}
+		array_pop(_resource_failure_list[type]);
+		string_deallocate(failure->diagnostics.str);
+		memory_deallocate(failure);
+	}
+	mutex_unlock(_resource_failure_lock);
+}
+
+static string_t
+resource_failure_diagnostics(char* buffer, size_t capacity, resource_failure_type type,
+                             hash_t key) {
+	string_t result = {buffer, 0};
+	if (capacity)
+		buffer[0] = 0;
+	mutex_lock(_resource_failure_lock);
+	resource_failure_t* failure = hashmap_lookup(_resource_failure_map[type], key);
+	if (failure) {
+		result = string_format(buffer, capacity,
+		                       STRING_CONST("%.*s (%u failed attempts, %u retries skipped, "
+		                                    "last attempt %.1f seconds ago)"),
+		                       STRING_FORMAT(failure->diagnostics), failure->attempts,
+		                       failure->skipped, (double)time_elapsed(failure->timestamp));
+	}
+	mutex_unlock(_resource_failure_lock);
+	return result;
+}
+
+string_t
+resource_failure_compile(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform) {
+	return resource_failure_diagnostics(buffer, capacity, RESOURCEFAILURE_COMPILE,
+	                                    resource_dependency_hash(uuid, platform));
+}
+
+string_t
+resource_failure_import(char* buffer, size_t capacity, const char* path, size_t length) {
+	return resource_failure_diagnostics(buffer, capacity, RESOURCEFAILURE_IMPORT,
+	                                    hash(path, length));
+}
+
+void
+resource_failure_clear(void) {
+	mutex_lock(_resource_failure_lock);
+	for (int itype = 0; itype < RESOURCEFAILURE_COUNT; ++itype)
+		resource_failure_clear_map((resource_failure_type)itype);
+	mutex_unlock(_resource_failure_lock);
+}
@@ -0,0 +1,48 @@
+/* failure.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Get diagnostics for the last failed compile of a resource. A failed compile is
+not retried until the source of the resource or its dependencies, or the set of
+compilers, change.
+\param buffer Destination buffer
+\param capacity Capacity of destination buffer
+\param uuid Resource UUID
+\param platform Resource platform
+\return Diagnostics, empty string if no failure is recorded */
+RESOURCE_API string_t
+resource_failure_compile(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform);
+
+/*! Get diagnostics for the last failed import of a source file. A failed import is
+not retried until the file content or the set of importers change.
+\param buffer Destination buffer
+\param capacity Capacity of destination buffer
+\param path Source file path
+\param length Length of path
+\return Diagnostics, empty string if no failure is recorded */
+RESOURCE_API string_t
+resource_failure_import(char* buffer, size_t capacity, const char* path, size_t length);
+
+/*! Forget all recorded failures, allowing failed compiles and imports to be retried */
+RESOURCE_API void
+resource_failure_clear(void);
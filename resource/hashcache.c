@@ -0,0 +1,617 @@
+/* hashcache.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+#if FOUNDATION_PLATFORM_WINDOWS
+#include <foundation/windows.h>
+#elif FOUNDATION_PLATFORM_POSIX
+#include <foundation/posix.h>
+#include <sys/stat.h>
+#include <time.h>
+#endif
+
+//! Modification times closer than this to the time of the stat are not trusted, covering
+//! timestamp granularity of up to two seconds, in the units of the modification time
+#if FOUNDATION_PLATFORM_WINDOWS
+#define RESOURCE_HASHCACHE_RACY_WINDOW 20000000ULL
+#elif FOUNDATION_PLATFORM_POSIX
+#define RESOURCE_HASHCACHE_RACY_WINDOW 2000000000ULL
+#else
+#define RESOURCE_HASHCACHE_RACY_WINDOW 2000ULL
+#endif
+
+#define RESOURCE_HASHCACHE_MAGIC 0x48434846
+#define RESOURCE_HASHCACHE_VERSION 3
+#define RESOURCE_HASHCACHE_FILE "filehash.cache"
+//! Files larger than this are hashed streaming instead of being read for batch hashing,
+//! bounding the buffers held by each import thread to RESOURCE_HASHCACHE_BATCH_MAX of them
+#define RESOURCE_HASHCACHE_BATCH_FILE_LIMIT (1024 * 1024)
+
+typedef struct resource_hashcache_header_t resource_hashcache_header_t;
+typedef struct resource_hashcache_entry_t resource_hashcache_entry_t;
+
+struct resource_hashcache_header_t {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t count;
+	//! Hash algorithm of all entries
+	uint32_t algorithm;
+	uint32_t reserved;
+};
+
+struct resource_hashcache_entry_t {
+	//! Hash of absolute file path
+	hash_t pathhash;
+	//! File metadata when content was hashed, including the time it was read
+	resource_file_stat_t stat;
+	//! Hash of file content
+	uint256_t hash;
+};
+
+FOUNDATION_STATIC_ASSERT(sizeof(resource_hashcache_header_t) == 24, "Invalid hash cache header");
+FOUNDATION_STATIC_ASSERT(sizeof(resource_hashcache_entry_t) == 72, "Invalid hash cache entry");
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+
+static mutex_t* _resource_hashcache_lock;
+static hashmap_t* _resource_hashcache_map;
+static resource_hashcache_entry_t* _resource_hashcache_entries;
+static string_t _resource_hashcache_path;
+static string_t _resource_hashcache_file;
+static bool _resource_hashcache_path_set;
+static bool _resource_hashcache_loaded;
+static bool _resource_hashcache_dirty;
+static atomic64_t _resource_hashcache_hits;
+static atomic64_t _resource_hashcache_misses;
+
+int
+resource_hashcache_initialize(void) {
+	_resource_hashcache_lock = mutex_allocate(STRING_CONST("resource-hashcache"));
+	_resource_hashcache_map = hashmap_allocate(4093, 8);
+	return 0;
+}
+
+static void
+resource_hashcache_clear(void) {
+	hashmap_clear(_resource_hashcache_map);
+	array_clear(_resource_hashcache_entries);
+	string_deallocate(_resource_hashcache_file.str);
+	_resource_hashcache_file = string(nullptr, 0);
+	_resource_hashcache_loaded = false;
+	_resource_hashcache_dirty = false;
+}
+
+static void
+resource_hashcache_write(void) {
+	if (!_resource_hashcache_dirty || !_resource_hashcache_file.length)
+		return;
+
+	string_const_t dir = path_directory_name(STRING_ARGS(_resource_hashcache_file));
+	fs_make_directory(STRING_ARGS(dir));
+
+	char tempbuf[BUILD_MAX_PATHLEN];
+	string_t temppath =
+	    string_format(tempbuf, sizeof(tempbuf), STRING_CONST("%.*s.%" PRIx64 ".tmp"),
+	                  STRING_FORMAT(_resource_hashcache_file), random64());
+	stream_t* stream = stream_open(STRING_ARGS(temppath),
+	                               STREAM_OUT | STREAM_BINARY | STREAM_CREATE | STREAM_TRUNCATE);
+	if (!stream) {
+		log_warnf(HASH_RESOURCE, WARNING_SUSPICIOUS,
+		          STRING_CONST("Unable to write file hash cache: %.*s"),
+		          STRING_FORMAT(_resource_hashcache_file));
+		return;
+	}
+
+	resource_hashcache_header_t header;
+	header.magic = RESOURCE_HASHCACHE_MAGIC;
+	header.version = RESOURCE_HASHCACHE_VERSION;
+	header.count = array_size(_resource_hashcache_entries);
+	header.algorithm = (uint32_t)resource_digest_algorithm();
+	header.reserved = 0;
+	size_t size = sizeof(resource_hashcache_entry_t) * header.count;
+	bool written = (stream_write(stream, &header, sizeof(header)) == sizeof(header)) &&
+	               (stream_write(stream, _resource_hashcache_entries, size) == size);
+	stream_deallocate(stream);
+
+	//Move into place so concurrent readers never see a partial cache
+	if (written) {
+		if (fs_is_file(STRING_ARGS(_resource_hashcache_file)))
+			fs_remove_file(STRING_ARGS(_resource_hashcache_file));
+		written = fs_move_file(STRING_ARGS(temppath), STRING_ARGS(_resource_hashcache_file));
+	}
+	if (!written)
+		fs_remove_file(STRING_ARGS(temppath));
+	else
+		_resource_hashcache_dirty = false;
+}
+
+static void
+resource_hashcache_load(void) {
+	if (_resource_hashcache_loaded)
+		return;
+	_resource_hashcache_loaded = true;
+
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t file = string(nullptr, 0);
+	if (_resource_hashcache_path_set) {
+		file = string_copy(buffer, sizeof(buffer), STRING_ARGS(_resource_hashcache_path));
+	} else {
+		string_const_t cache_path = resource_cache_path();
+		if (cache_path.length)
+			file = path_concat(buffer, sizeof(buffer), STRING_ARGS(cache_path),
+			                   STRING_CONST(RESOURCE_HASHCACHE_FILE));
+	}
+	_resource_hashcache_file = file.length ? string_clone(STRING_ARGS(file)) : string(nullptr, 0);
+	if (!file.length)
+		return;
+
+	stream_t* stream = stream_open(STRING_ARGS(file), STREAM_IN | STREAM_BINARY);
+	if (!stream)
+		return;
+
+	resource_hashcache_header_t header;
+	size_t size = stream_size(stream);
+	bool valid = (stream_read(stream, &header, sizeof(header)) == sizeof(header)) &&
+	             (header.magic == RESOURCE_HASHCACHE_MAGIC) &&
+	             (header.version == RESOURCE_HASHCACHE_VERSION) &&
+	             (size == sizeof(header) + (sizeof(resource_hashcache_entry_t) * header.count));
+	if (valid && (header.algorithm != (uint32_t)resource_digest_algorithm())) {
+		// Hashes from another algorithm never match, start over
+		log_infof(HASH_RESOURCE,
+		          STRING_CONST("Discarding file hash cache with different hash algorithm: %.*s"),
+		          STRING_FORMAT(file));
+		stream_deallocate(stream);
+		return;
+	}
+	if (valid && header.count) {
+		array_resize(_resource_hashcache_entries, header.count);
+		size = sizeof(resource_hashcache_entry_t) * header.count;
+		valid = (stream_read(stream, _resource_hashcache_entries, size) == size);
+	}
+	stream_deallocate(stream);
+
+	if (!valid) {
+		log_infof(HASH_RESOURCE, STRING_CONST("Discarding invalid file hash cache: %.*s"),
+		          STRING_FORMAT(file));
+		array_clear(_resource_hashcache_entries);
+		return;
+	}
+
+	for (size_t ientry = 0, esize = array_size(_resource_hashcache_entries); ientry < esize;
+	     ++ientry)
+		hashmap_insert(_resource_hashcache_map, _resource_hashcache_entries[ientry].pathhash,
+		               (void*)(uintptr_t)(ientry + 1));
+	log_debugf(HASH_RESOURCE, STRING_CONST("Loaded file hash cache: %.*s (%" PRIsize " entries)"),
+	           STRING_FORMAT(file), array_size(_resource_hashcache_entries));
+}
+
+void
+resource_hashcache_finalize(void) {
+	uint64_t hits = (uint64_t)atomic_load64(&_resource_hashcache_hits, memory_order_acquire);
+	uint64_t misses = (uint64_t)atomic_load64(&_resource_hashcache_misses, memory_order_acquire);
+	if (hits + misses) {
+		log_infof(HASH_RESOURCE,
+		          STRING_CONST("File hash cache: %" PRIu64 " hits, %" PRIu64 " misses"), hits,
+		          misses);
+	}
+
+	if (_resource_hashcache_lock) {
+		resource_hashcache_write();
+		resource_hashcache_clear();
+	}
+
+	array_deallocate(_resource_hashcache_entries);
+	hashmap_deallocate(_resource_hashcache_map);
+	mutex_deallocate(_resource_hashcache_lock);
+	string_deallocate(_resource_hashcache_path.str);
+
+	_resource_hashcache_entries = nullptr;
+	_resource_hashcache_map = nullptr;
+	_resource_hashcache_lock = nullptr;
+	_resource_hashcache_path = string(nullptr, 0);
+	_resource_hashcache_path_set = false;
+}
+
+void
+resource_hashcache_set_path(const char* path, size_t length) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
+	if (pathstr.length)
+		pathstr = path_absolute(STRING_ARGS(pathstr), sizeof(buffer));
+
+	mutex_lock(_resource_hashcache_lock);
+	//Persist entries to the previous location before switching
+	resource_hashcache_write();
+	resource_hashcache_clear();
+	string_deallocate(_resource_hashcache_path.str);
+	_resource_hashcache_path =
+	    pathstr.length ? string_clone(STRING_ARGS(pathstr)) : string(nullptr, 0);
+	_resource_hashcache_path_set = true;
+	mutex_unlock(_resource_hashcache_lock);
+}
+
+string_const_t
+resource_hashcache_path(void) {
+	string_const_t path;
+	mutex_lock(_resource_hashcache_lock);
+	resource_hashcache_load();
+	path = string_to_const(_resource_hashcache_file);
+	mutex_unlock(_resource_hashcache_lock);
+	return path;
+}
+
+static hash_t
+resource_hashcache_key(const char* path, size_t length) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+	pathstr = path_absolute(STRING_ARGS(pathstr), sizeof(buffer));
+	return hash(STRING_ARGS(pathstr));
+}
+
+static bool
+resource_hashcache_stat_equal(const resource_file_stat_t* first,
+                              const resource_file_stat_t* second) {
+	return (first->size == second->size) && (first->modified == second->modified) &&
+	       (first->inode == second->inode);
+}
+
+/*! Check if entry is racily clean, like git does for its index. A file modified in the
+same timestamp granule as it was hashed can be rewritten without changing its metadata,
+so the entry is only trusted once the modification is older than the hashing */
+static bool
+resource_hashcache_is_racy(const resource_file_stat_t* filestat) {
+	return (filestat->modified + RESOURCE_HASHCACHE_RACY_WINDOW) >= filestat->sampled;
+}
+
+bool
+resource_hashcache_stat(const char* path, size_t length, resource_file_stat_t* filestat) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+	memset(filestat, 0, sizeof(resource_file_stat_t));
+#if FOUNDATION_PLATFORM_WINDOWS
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	filestat->sampled = ((uint64_t)now.dwHighDateTime << 32ULL) | (uint64_t)now.dwLowDateTime;
+	DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+	HANDLE file = CreateFileA(pathstr.str, 0, share, nullptr, OPEN_EXISTING,
+	                          FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	BY_HANDLE_FILE_INFORMATION info;
+	BOOL got = GetFileInformationByHandle(file, &info);
+	CloseHandle(file);
+	if (!got || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return false;
+	filestat->size = ((uint64_t)info.nFileSizeHigh << 32ULL) | (uint64_t)info.nFileSizeLow;
+	filestat->modified = ((uint64_t)info.ftLastWriteTime.dwHighDateTime << 32ULL) |
+	                     (uint64_t)info.ftLastWriteTime.dwLowDateTime;
+	filestat->inode = ((uint64_t)info.nFileIndexHigh << 32ULL) | (uint64_t)info.nFileIndexLow;
+#elif FOUNDATION_PLATFORM_POSIX
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	filestat->sampled = ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+	struct stat st;
+	if ((stat(pathstr.str, &st) != 0) || !S_ISREG(st.st_mode))
+		return false;
+	filestat->size = (uint64_t)st.st_size;
+#if FOUNDATION_PLATFORM_APPLE
+	filestat->modified = ((uint64_t)st.st_mtimespec.tv_sec * 1000000000ULL) +
+	                     (uint64_t)st.st_mtimespec.tv_nsec;
+#else
+	filestat->modified = ((uint64_t)st.st_mtim.tv_sec * 1000000000ULL) +
+	                     (uint64_t)st.st_mtim.tv_nsec;
+#endif
+	filestat->inode = (uint64_t)st.st_ino;
+#else
+	filestat->sampled = (uint64_t)time_system();
+	if (!fs_is_file(STRING_ARGS(pathstr)))
+		return false;
+	filestat->size = fs_size(STRING_ARGS(pathstr));
+	filestat->modified = (uint64_t)fs_last_modified(STRING_ARGS(pathstr));
+#endif
+	return true;
+}
+
+bool
+resource_hashcache_lookup(const char* path, size_t length, const resource_file_stat_t* filestat,
+                          uint256_t* hash) {
+	hash_t key = resource_hashcache_key(path, length);
+	bool found = false;
+
+	mutex_lock(_resource_hashcache_lock);
+	resource_hashcache_load();
+	size_t index = (size_t)(uintptr_t)hashmap_lookup(_resource_hashcache_map, key);
+	if (index) {
+		const resource_hashcache_entry_t* entry = _resource_hashcache_entries + (index - 1);
+		if (resource_hashcache_stat_equal(&entry->stat, filestat) &&
+		    !resource_hashcache_is_racy(&entry->stat)) {
+			*hash = entry->hash;
+			found = true;
+		}
+	}
+	mutex_unlock(_resource_hashcache_lock);
+
+	if (found)
+		atomic_incr64(&_resource_hashcache_hits, memory_order_relaxed);
+	else
+		atomic_incr64(&_resource_hashcache_misses, memory_order_relaxed);
+	return found;
+}
+
+void
+resource_hashcache_store(const char* path, size_t length, const resource_file_stat_t* filestat,
+                         const uint256_t hash) {
+	//Only store if file is unchanged since the content was hashed, otherwise the
+	//hash could be associated with metadata of newer content
+	resource_file_stat_t current;
+	if (!resource_hashcache_stat(path, length, &current) ||
+	    !resource_hashcache_stat_equal(&current, filestat))
+		return;
+
+	hash_t key = resource_hashcache_key(path, length);
+	mutex_lock(_resource_hashcache_lock);
+	resource_hashcache_load();
+	size_t index = (size_t)(uintptr_t)hashmap_lookup(_resource_hashcache_map, key);
+	if (!index) {
+		resource_hashcache_entry_t entry;
+		memset(&entry, 0, sizeof(entry));
+		entry.pathhash = key;
+		array_push(_resource_hashcache_entries, entry);
+		index = array_size(_resource_hashcache_entries);
+		hashmap_insert(_resource_hashcache_map, key, (void*)(uintptr_t)index);
+	}
+	resource_hashcache_entry_t* entry = _resource_hashcache_entries + (index - 1);
+	// Racy entries are refreshed so they become trusted once hashed late enough
+	if (!resource_hashcache_stat_equal(&entry->stat, filestat) ||
+	    !uint256_equal(entry->hash, hash) || resource_hashcache_is_racy(&entry->stat)) {
+		entry->stat = *filestat;
+		entry->hash = hash;
+		_resource_hashcache_dirty = true;
+	}
+	mutex_unlock(_resource_hashcache_lock);
+}
+
+uint256_t
+resource_hashcache_hash(const char* path, size_t length) {
+	resource_file_stat_t filestat;
+	uint256_t hash = uint256_null();
+	if (!resource_hashcache_stat(path, length, &filestat))
+		return hash;
+	if (resource_hashcache_lookup(path, length, &filestat, &hash))
+		return hash;
+
+	stream_t* stream = stream_open(path, length, STREAM_IN);
+	if (!stream)
+		return hash;
+	hash = resource_digest_stream(stream, resource_digest_algorithm());
+	stream_deallocate(stream);
+
+	resource_hashcache_store(path, length, &filestat, hash);
+	return hash;
+}
+
+/*! Normalize line endings to LF in place like stream_sha256 does for text mode streams,
+so batch hashes match the hashes of streamed files
+\return Normalized size */
+static size_t
+resource_hashcache_normalize(uint8_t* data, size_t size) {
+	size_t out = 0;
+	for (size_t in = 0; in < size; ++in) {
+		uint8_t c = data[in];
+		if (c == '\r') {
+			c = '\n';
+			if ((in + 1 < size) && (data[in + 1] == '\n'))
+				++in;
+		}
+		data[out++] = c;
+	}
+	return out;
+}
+
+static void
+resource_hashcache_hash_chunk(const string_const_t* paths, size_t count, uint256_t* hashes) {
+	const void* data[RESOURCE_HASHCACHE_BATCH_MAX];
+	size_t size[RESOURCE_HASHCACHE_BATCH_MAX];
+	size_t pathindex[RESOURCE_HASHCACHE_BATCH_MAX];
+	resource_file_stat_t filestat[RESOURCE_HASHCACHE_BATCH_MAX];
+	size_t num_read = 0;
+	resource_hash_algorithm algorithm = resource_digest_algorithm();
+
+	for (size_t ipath = 0; ipath < count; ++ipath) {
+		const string_const_t path = paths[ipath];
+		hashes[ipath] = uint256_null();
+		resource_file_stat_t* current = filestat + num_read;
+		if (!resource_hashcache_stat(STRING_ARGS(path), current) ||
+		    resource_hashcache_lookup(STRING_ARGS(path), current, hashes + ipath))
+			continue;
+
+		stream_t* stream = stream_open(STRING_ARGS(path), STREAM_IN);
+		if (!stream)
+			continue;
+		if ((algorithm != RESOURCEHASH_SHA256) ||
+		    (current->size > RESOURCE_HASHCACHE_BATCH_FILE_LIMIT)) {
+			hashes[ipath] = resource_digest_stream(stream, algorithm);
+			stream_deallocate(stream);
+			resource_hashcache_store(STRING_ARGS(path), current, hashes[ipath]);
+			continue;
+		}
+
+		size_t filesize = stream_size(stream);
+		uint8_t* buffer = memory_allocate(HASH_RESOURCE, filesize ? filesize : 1, 0,
+		                                  MEMORY_TEMPORARY);
+		filesize = stream_read(stream, buffer, filesize);
+		if (!stream_is_binary(stream))
+			filesize = resource_hashcache_normalize(buffer, filesize);
+		stream_deallocate(stream);
+
+		data[num_read] = buffer;
+		size[num_read] = filesize;
+		pathindex[num_read] = ipath;
+		++num_read;
+	}
+
+	if (!num_read)
+		return;
+
+	uint256_t batchhash[RESOURCE_HASHCACHE_BATCH_MAX];
+	resource_digest_sha256_batch(data, size, num_read, batchhash);
+	for (size_t iread = 0; iread < num_read; ++iread) {
+		const string_const_t path = paths[pathindex[iread]];
+		hashes[pathindex[iread]] = batchhash[iread];
+		resource_hashcache_store(STRING_ARGS(path), filestat + iread, batchhash[iread]);
+		memory_deallocate((void*)data[iread]);
+	}
+}
+
+void
+resource_hashcache_hash_batch(const string_const_t* paths, size_t count, uint256_t* hashes) {
+	// Hash in chunks bounded by the number of lanes in the multi-buffer engine
+	for (size_t first = 0; first < count; first += RESOURCE_HASHCACHE_BATCH_MAX) {
+		size_t chunk = count - first;
+		if (chunk > RESOURCE_HASHCACHE_BATCH_MAX)
+			chunk = RESOURCE_HASHCACHE_BATCH_MAX;
+		resource_hashcache_hash_chunk(paths + first, chunk, hashes + first);
+	}
+}
+
+void
+resource_hashcache_forget(const char* path, size_t length) {
+	hash_t key = resource_hashcache_key(path, length);
+	mutex_lock(_resource_hashcache_lock);
+	resource_hashcache_load();
+	size_t index = (size_t)(uintptr_t)hashmap_lookup(_resource_hashcache_map, key);
+	if (index) {
+		//Swap last entry into the erased slot
+		size_t last = array_size(_resource_hashcache_entries);
+		hashmap_erase(_resource_hashcache_map, key);
+		if (index != last) {
+			_resource_hashcache_entries[index - 1] = _resource_hashcache_entries[last - 1];
+			hashmap_insert(_resource_hashcache_map, _resource_hashcache_entries[index - 1].pathhash,
+			               (void*)(uintptr_t)index);
+		}
+		array_pop(_resource_hashcache_entries);
+		_resource_hashcache_dirty = true;
+	}
+	mutex_unlock(_resource_hashcache_lock);
+}
+
+void
+resource_hashcache_flush(void) {
+	mutex_lock(_resource_hashcache_lock);
+	resource_hashcache_write();
+	mutex_unlock(_resource_hashcache_lock);
+}
+
+resource_hashcache_statistics_t
+resource_hashcache_statistics(void) {
+	resource_hashcache_statistics_t statistics;
+	statistics.hits = (uint64_t)atomic_load64(&_resource_hashcache_hits, memory_order_acquire);
+	statistics.misses = (uint64_t)atomic_load64(&_resource_hashcache_misses, memory_order_acquire);
+	mutex_lock(_resource_hashcache_lock);
+	statistics.entries = array_size(_resource_hashcache_entries);
+	mutex_unlock(_resource_hashcache_lock);
+	return statistics;
+}
+
+#else
+
+int
+resource_hashcache_initialize(void) {
+	return 0;
+}
+
+void
+resource_hashcache_finalize(void) {
+}
+
+void
+resource_hashcache_set_path(const char* path, size_t length) {
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+}
+
+string_const_t
+resource_hashcache_path(void) {
+	return string_const(nullptr, 0);
+}
+
+bool
+resource_hashcache_stat(const char* path, size_t length, resource_file_stat_t* filestat) {
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+	memset(filestat, 0, sizeof(resource_file_stat_t));
+	return false;
+}
+
+bool
+resource_hashcache_lookup(const char* path, size_t length, const resource_file_stat_t* filestat,
+                          uint256_t* hash) {
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+	FOUNDATION_UNUSED(filestat);
+	FOUNDATION_UNUSED(hash);
+	return false;
+}
+
+void
+resource_hashcache_store(const char* path, size_t length, const resource_file_stat_t* filestat,
+                         const uint256_t hash) {
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+	FOUNDATION_UNUSED(filestat);
+	FOUNDATION_UNUSED(hash);
+}
+
+uint256_t
+resource_hashcache_hash(const char* path, size_t length) {
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+	return uint256_null();
+}
+
+void
+resource_hashcache_hash_batch(const string_const_t* paths, size_t count, uint256_t* hashes) {
+	FOUNDATION_UNUSED(paths);
+	for (size_t ipath = 0; ipath < count; ++ipath)
+		hashes[ipath] = uint256_null();
+}
+
+void
+resource_hashcache_forget(const char* path, size_t length) {
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+}
+
+void
+resource_hashcache_flush(void) {
+}
+
+resource_hashcache_statistics_t
+resource_hashcache_statistics(void) {
+	resource_hashcache_statistics_t statistics;
+	memset(&statistics, 0, sizeof(statistics));
+	return statistics;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/* hashcache.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Set the file hash cache path. The file hash cache maps asset file paths to the
+content hash of the file, keyed by file size, modification time and inode, so
+the content is only hashed again when the file metadata changes. The cache is discarded
+if the configured content hash algorithm has changed. An empty path keeps the cache in
+memory only. If no path is set the cache is stored in the compile cache
+directory, if any.
+\param path Cache file path
+\param length Length of path */
+RESOURCE_API void
+resource_hashcache_set_path(const char* path, size_t length);
+
+/*! Get the file hash cache path
+\return Cache file path, empty if the cache is not persisted */
+RESOURCE_API string_const_t
+resource_hashcache_path(void);
+
+/*! Get the content hash of a file using the configured algorithm, reusing the cached
+hash if the file metadata is unchanged since it was last hashed
+\param path File path
+\param length Length of path
+\return Hash of file content, zero if file could not be read */
+RESOURCE_API uint256_t
+resource_hashcache_hash(const char* path, size_t length);
+
+/*! Get the content hashes of multiple files. Files not in the cache are read and
+hashed together with the multi-buffer SHA-256 engine if the configured algorithm is
+SHA-256, large files and other algorithms are hashed one file at a time. Files are
+read and hashed in chunks of at most RESOURCE_HASHCACHE_BATCH_MAX files.
+\param paths File paths
+\param count Number of paths
+\param hashes Array receiving hash of content of each file, zero if file could not be read */
+RESOURCE_API void
+resource_hashcache_hash_batch(const string_const_t* paths, size_t count, uint256_t* hashes);
+
+/*! Forget the cached hash of a file, forcing the content to be hashed on next use
+\param path File path
+\param length Length of path */
+RESOURCE_API void
+resource_hashcache_forget(const char* path, size_t length);
+
+/*! Write the file hash cache to the cache path if it has been modified */
+RESOURCE_API void
+resource_hashcache_flush(void);
+
+/*! Get file hash cache statistics
+\return Statistics */
+RESOURCE_API resource_hashcache_statistics_t
+resource_hashcache_statistics(void);
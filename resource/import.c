@@ -22,23 +22,49 @@
 
 #include <foundation/foundation.h>
 
+#include <stdlib.h>
+
+typedef struct resource_import_format_t resource_import_format_t;
+
+//! Asset file format declared by an importer
+struct resource_import_format_t {
+	resource_import_fn importer;
+	//! Hashes of lower case file extensions
+	hash_t* extensions;
+	//! Leading magic bytes, array of zero or one entry
+	resource_import_magic_t* magic;
+};
+
 static resource_import_fn* _resource_importers;
+static resource_import_format_t* _resource_import_formats;
 static string_t _resource_import_base_path;
-static string_t* _resource_import_tool_path;
+static mutex_t* _resource_import_identity_lock;
+static hash_t _resource_import_identity;
+static unsigned int _resource_import_identity_generation;
 
 int
 resource_import_initialize(void) {
+	_resource_import_identity_lock = mutex_allocate(STRING_CONST("resource-import-identity"));
 	return 0;
 }
 
 void
 resource_import_finalize(void) {
+	for (size_t iformat = 0, fsize = array_size(_resource_import_formats); iformat < fsize;
+	     ++iformat) {
+		array_deallocate(_resource_import_formats[iformat].extensions);
+		array_deallocate(_resource_import_formats[iformat].magic);
+	}
+	array_deallocate(_resource_import_formats);
 	array_deallocate(_resource_importers);
 	string_deallocate(_resource_import_base_path.str);
-	string_array_deallocate(_resource_import_tool_path);
+	mutex_deallocate(_resource_import_identity_lock);
 
+	_resource_import_formats = 0;
 	_resource_importers = 0;
 	_resource_import_base_path = string(0, 0);
+	_resource_import_identity_lock = 0;
+	_resource_import_identity = 0;
 }
 
 string_const_t
@@ -53,20 +79,119 @@ resource_import_set_base_path(const char* path, size_t length) {
 	_resource_import_base_path = length ? string_clone(path, length) : string(0, 0);
 }
 
+bool
+resource_import_cancel(const char* path, size_t length) {
+	return resource_tool_cancel(hash(path, length));
+}
+
 #if RESOURCE_ENABLE_LOCAL_SOURCE
 
-#if FOUNDATION_PLATFORM_WINDOWS
-#define RESOURCE_IMPORTER_PATTERN "^.*import\\.exe$"
-#else
-#define RESOURCE_IMPORTER_PATTERN "^.*import$"
-#endif
+static hash_t
+resource_import_identity(void) {
+	resource_tool_list_t* tools = resource_tool_acquire(RESOURCETOOL_IMPORT);
+	unsigned int generation = resource_tool_generation(RESOURCETOOL_IMPORT);
+	mutex_lock(_resource_import_identity_lock);
+	hash_t identity = _resource_import_identity;
+	if (identity && (generation == _resource_import_identity_generation)) {
+		mutex_unlock(_resource_import_identity_lock);
+		resource_tool_release(tools);
+		return identity;
+	}
 
-bool
-resource_import(const char* path, size_t length, const uuid_t uuid) {
+	//Identify the set of importers by the in-process importer functions and their
+	//declared formats, and the external import tool binaries
+	hash_t* parts = nullptr;
+	for (size_t iimp = 0, isize = array_size(_resource_importers); iimp < isize; ++iimp)
+		array_push(parts, (hash_t)(uintptr_t)_resource_importers[iimp]);
+	for (size_t iformat = 0, fsize = array_size(_resource_import_formats); iformat < fsize;
+	     ++iformat) {
+		const resource_import_format_t* format = _resource_import_formats + iformat;
+		array_push(parts, (hash_t)(uintptr_t)format->importer);
+		for (size_t iext = 0, esize = array_size(format->extensions); iext < esize; ++iext)
+			array_push(parts, format->extensions[iext]);
+		for (size_t imagic = 0, msize = array_size(format->magic); imagic < msize; ++imagic)
+			array_push(parts, hash(format->magic[imagic].bytes, format->magic[imagic].size));
+	}
+	for (size_t itool = 0, tsize = array_size(tools->tools); itool != tsize; ++itool) {
+		const string_t fullpath = tools->tools[itool].path;
+		array_push(parts, hash(STRING_ARGS(fullpath)));
+		array_push(parts, (hash_t)fs_last_modified(STRING_ARGS(fullpath)));
+		array_push(parts, (hash_t)fs_size(STRING_ARGS(fullpath)));
+	}
+	identity = parts ? hash(parts, sizeof(hash_t) * array_size(parts)) : 0;
+	array_deallocate(parts);
+	resource_tool_release(tools);
+
+	identity = identity ? identity : 1;
+	_resource_import_identity_generation = generation;
+	_resource_import_identity = identity;
+	mutex_unlock(_resource_import_identity_lock);
+	return identity;
+}
+
+static hash_t
+resource_import_fingerprint(const uint256_t import_hash) {
+	hash_t parts[2];
+	parts[0] = hash(&import_hash, sizeof(import_hash));
+	parts[1] = resource_import_identity();
+	return hash(parts, sizeof(parts));
+}
+
+static bool
+resource_import_is_declared(resource_import_fn importer) {
+	for (size_t iformat = 0, fsize = array_size(_resource_import_formats); iformat < fsize;
+	     ++iformat) {
+		if (_resource_import_formats[iformat].importer == importer)
+			return true;
+	}
+	return false;
+}
+
+static void
+resource_import_push_unique(resource_import_fn** importers, resource_import_fn importer) {
+	for (size_t iimp = 0, isize = array_size(*importers); iimp < isize; ++iimp) {
+		if ((*importers)[iimp] == importer)
+			return;
+	}
+	array_push(*importers, importer);
+}
+
+static resource_import_fn*
+resource_import_select(hash_t extension, const void* header, size_t size) {
+	// Importers with matching magic first, then matching extension, then importers without
+	// any format declaration as a probing fallback. Importers declaring other formats are
+	// not tried.
+	resource_import_fn* selected = nullptr;
+	int match[] = {2, 1};
+	for (size_t imatch = 0; imatch < sizeof(match) / sizeof(match[0]); ++imatch) {
+		for (size_t iformat = 0, fsize = array_size(_resource_import_formats); iformat < fsize;
+		     ++iformat) {
+			const resource_import_format_t* format = _resource_import_formats + iformat;
+			if (resource_tool_match_format(format->extensions, format->magic, extension, header,
+			                               size) == match[imatch])
+				resource_import_push_unique(&selected, format->importer);
+		}
+	}
+	for (size_t iimp = 0, isize = array_size(_resource_importers); iimp < isize; ++iimp) {
+		if (!resource_import_is_declared(_resource_importers[iimp]))
+			resource_import_push_unique(&selected, _resource_importers[iimp]);
+	}
+	return selected;
+}
+
+static resource_signature_t
+resource_import_map_lookup(const char* path, size_t length);
+
+static bool
+resource_import_hashed(const char* path, size_t length, const uuid_t uuid, uint256_t import_hash) {
 	size_t iimp, isize;
 	size_t internal = 0;
 	size_t external = 0;
 	bool was_imported = false;
+	resource_file_stat_t filestat;
+	bool has_stat = false;
+	if (uint256_is_null(import_hash))
+		has_stat = resource_hashcache_stat(path, length, &filestat);
 	stream_t* stream = stream_open(path, length, STREAM_IN);
 	if (!stream) {
 		log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
@@ -75,102 +200,339 @@ resource_import(const char* path, size_t length, const uuid_t uuid) {
 		return false;
 	}
 
-	size_t streampos = stream_tell(stream);
-	uint256_t import_hash = stream_sha256(stream);
-	stream_seek(stream, streampos, STREAM_SEEK_BEGIN);
+	// Only hash the file content if not already hashed by the caller and metadata changed
+	// since last hashed
+	if (uint256_is_null(import_hash) &&
+	    (!has_stat || !resource_hashcache_lookup(path, length, &filestat, &import_hash))) {
+		size_t streampos = stream_tell(stream);
+		import_hash = resource_digest_stream(stream, resource_digest_algorithm());
+		stream_seek(stream, streampos, STREAM_SEEK_BEGIN);
+	}
 
-	for (iimp = 0, isize = array_size(_resource_importers); !was_imported && (iimp != isize);
-	     ++iimp) {
+	// Skip importers known to fail on unchanged file content
+	hash_t failkey = hash(path, length);
+	hash_t fingerprint = resource_import_fingerprint(import_hash);
+	if (resource_failure_check(RESOURCEFAILURE_IMPORT, failkey, fingerprint)) {
+		stream_deallocate(stream);
+		log_debugf(HASH_RESOURCE,
+		           STRING_CONST("Skipped import of unchanged file after failure: %.*s"),
+		           (int)length, path);
+		return false;
+	}
+	char toolbuf[256];
+	string_t toolstr = string_copy(toolbuf, sizeof(toolbuf), STRING_CONST(""));
+	bool cancelled = false;
+
+	// Route by file extension and leading bytes to the importers declaring the format
+	uint8_t header[RESOURCE_IMPORT_MAGIC_MAX];
+	stream_seek(stream, 0, STREAM_SEEK_BEGIN);
+	size_t header_size = stream_read(stream, header, sizeof(header));
+	string_const_t extstr = path_file_extension(path, length);
+	hash_t extension = resource_tool_extension_hash(STRING_ARGS(extstr));
+
+	resource_import_fn* importers = resource_import_select(extension, header, header_size);
+	for (iimp = 0, isize = array_size(importers); !was_imported && (iimp != isize); ++iimp) {
 		stream_seek(stream, 0, STREAM_SEEK_BEGIN);
-		was_imported |= (_resource_importers[iimp](stream, uuid) == 0);
+		was_imported |= (importers[iimp](stream, uuid) == 0);
 		++internal;
 	}
+	array_deallocate(importers);
 	stream_deallocate(stream);
 
 	// Try external tools until imported successfully
-	for (size_t ipath = 0, psize = array_size(_resource_import_tool_path);
-	     !was_imported && (ipath != psize); ++ipath) {
-		string_t* tools = fs_matching_files(STRING_ARGS(_resource_import_tool_path[ipath]),
-		                                    STRING_CONST(RESOURCE_IMPORTER_PATTERN), true);
-		for (size_t itool = 0, tsize = array_size(tools); !was_imported && (itool != tsize);
-		     ++itool) {
-			char buffer[BUILD_MAX_PATHLEN];
-			string_t fullpath =
-			    path_concat(buffer, sizeof(buffer), STRING_ARGS(_resource_import_tool_path[ipath]),
-			                STRING_ARGS(tools[itool]));
-
-			process_t proc;
-			process_initialize(&proc);
-
-			string_const_t wd = environment_current_working_directory();
-			process_set_working_directory(&proc, STRING_ARGS(wd));
-			process_set_executable_path(&proc, STRING_ARGS(fullpath));
-
-			string_const_t* args = nullptr;
-			array_push(args, string_const(path, length));
-			array_push(args, string_const(STRING_CONST("--")));
-
-			string_const_t local_source = resource_source_path();
-			if (local_source.length) {
-				array_push(args, string_const(STRING_CONST("--resource-source-path")));
-				array_push(args, local_source);
-			}
-			string_const_t base_path = resource_import_base_path();
-			if (base_path.length) {
-				array_push(args, string_const(STRING_CONST("--resource-base-path")));
-				array_push(args, base_path);
-			}
+	resource_tool_list_t* tools = resource_tool_acquire(RESOURCETOOL_IMPORT);
+	size_t* selected = nullptr;
+	if (!was_imported)
+		selected = resource_tool_select_format(tools, extension, header, header_size);
+	if (!was_imported && array_size(selected)) {
+		string_const_t* args = nullptr;
+		array_push(args, string_const(path, length));
+
+		string_const_t* common = nullptr;
+		string_const_t local_source = resource_source_path();
+		if (local_source.length) {
+			array_push(common, string_const(STRING_CONST("--resource-source-path")));
+			array_push(common, local_source);
+		}
+		string_const_t base_path = resource_import_base_path();
+		if (base_path.length) {
+			array_push(common, string_const(STRING_CONST("--resource-base-path")));
+			array_push(common, base_path);
+		}
 
-			process_set_arguments(&proc, args, array_size(args));
-			process_set_flags(&proc, PROCESS_STDSTREAMS | PROCESS_DETACHED);
-			process_spawn(&proc);
-
-			stream_t* err = process_stderr(&proc);
-			stream_finalize(process_stdout(&proc));
-			while (!stream_eos(err)) {
-				string_t line = stream_read_line_buffer(err, buffer, sizeof(buffer), '\n');
-				if (line.length) {
-					if (line.str[line.length - 1] == '\r')
-						--line.length;
-					log_infof(HASH_RESOURCE, STRING_CONST("%.*s: %.*s"),
-					          STRING_FORMAT(tools[itool]), STRING_FORMAT(line));
-				}
-			}
-			int exit_code = process_wait(&proc);
-			while (exit_code == PROCESS_STILL_ACTIVE) {
-				thread_yield();
-				exit_code = process_wait(&proc);
-			}
+		for (size_t isel = 0, ssize = array_size(selected);
+		     !was_imported && !cancelled && (isel != ssize); ++isel) {
+			const resource_tool_t* tool = tools->tools + selected[isel];
+			const string_const_t toolname = path_file_name(STRING_ARGS(tool->path));
+			int exit_code = resource_tool_execute(tool, failkey, args, array_size(args), common,
+			                                      array_size(common));
 			if (exit_code == 0) {
 				log_debugf(HASH_RESOURCE, STRING_CONST("Imported with external tool: %.*s"),
-				           STRING_FORMAT(tools[itool]));
+				           STRING_FORMAT(toolname));
 				was_imported = true;
 			} else {
 				log_debugf(HASH_RESOURCE,
 				           STRING_CONST("Failed importing with external tool: %.*s (%d)"),
-				           STRING_FORMAT(tools[itool]), exit_code);
+				           STRING_FORMAT(toolname), exit_code);
+				if (exit_code == RESOURCE_TOOL_EXIT_CANCELLED)
+					cancelled = true;
+				char exitbuf[128];
+				string_t exitstr;
+				if (exit_code == RESOURCE_TOOL_EXIT_TIMEOUT)
+					exitstr = string_format(exitbuf, sizeof(exitbuf),
+					                        STRING_CONST("%s%.*s timed out"),
+					                        toolstr.length ? ", " : "", STRING_FORMAT(toolname));
+				else
+					exitstr = string_format(exitbuf, sizeof(exitbuf),
+					                        STRING_CONST("%s%.*s exited with %d"),
+					                        toolstr.length ? ", " : "", STRING_FORMAT(toolname),
+					                        exit_code);
+				toolstr =
+				    string_append(STRING_ARGS(toolstr), sizeof(toolbuf), STRING_ARGS(exitstr));
 			}
 
-			process_finalize(&proc);
-			array_deallocate(args);
-
 			++external;
 		}
-		string_array_deallocate(tools);
+
+		array_deallocate(common);
+		array_deallocate(args);
 	}
+	array_deallocate(selected);
+	resource_tool_release(tools);
 
 	if (!was_imported) {
 		log_warnf(
 		    HASH_RESOURCE, WARNING_RESOURCE,
 		    STRING_CONST("Unable to import: %.*s (%" PRIsize " internal, %" PRIsize " external)"),
 		    (int)length, path, internal, external);
+		char diagbuf[512];
+		string_t diag = string_format(
+		    diagbuf, sizeof(diagbuf),
+		    STRING_CONST("%" PRIsize " internal and %" PRIsize " external importers failed%s%.*s"),
+		    internal, external, toolstr.length ? ": " : "", STRING_FORMAT(toolstr));
+		if (!cancelled)
+			resource_failure_record(RESOURCEFAILURE_IMPORT, failkey, fingerprint,
+			                        STRING_ARGS(diag));
 	} else {
-		resource_source_set_import_hash(uuid, import_hash);
+		resource_failure_forget(RESOURCEFAILURE_IMPORT, failkey);
+		// Importers store a signature of their own choosing, replace it with the content hash
+		// of the configured algorithm which change detection compares against
+		resource_signature_t sig = resource_import_map_lookup(path, length);
+		if (!uuid_is_null(sig.uuid) && !uint256_equal(sig.hash, import_hash))
+			resource_import_map_store(path, length, sig.uuid, import_hash);
+		resource_source_set_import_hash(uuid_is_null(uuid) ? sig.uuid : uuid, import_hash);
+		if (has_stat)
+			resource_hashcache_store(path, length, &filestat, import_hash);
 		log_infof(HASH_RESOURCE, STRING_CONST("Imported: %.*s"), (int)length, path);
 	}
 	return was_imported;
 }
 
+bool
+resource_import(const char* path, size_t length, const uuid_t uuid) {
+	return resource_import_hashed(path, length, uuid, uint256_null());
+}
+
+typedef struct resource_import_job_t resource_import_job_t;
+typedef struct resource_import_pass_t resource_import_pass_t;
+
+struct resource_import_job_t {
+	string_t path;
+	uint64_t size;
+};
+
+struct resource_import_pass_t {
+	resource_import_job_t* jobs;
+	size_t num_jobs;
+	//! Number of jobs claimed and hashed together by an import thread
+	size_t group;
+	//! Index of next job to process, shared by all import threads
+	atomic32_t next;
+	atomic32_t done;
+	//! Posted once per finished job
+	semaphore_t finished;
+	atomic32_t up_to_date;
+	atomic32_t imported;
+	atomic32_t failed;
+	atomic64_t bytes;
+};
+
+static bool
+resource_import_is_up_to_date(const resource_signature_t sig, uint256_t filehash) {
+	// Same check as autoimport, asset file must match both import map and source
+	if (uuid_is_null(sig.uuid))
+		return false;
+	return !uint256_is_null(filehash) && uint256_equal(sig.hash, filehash) &&
+	       uint256_equal(resource_source_import_hash(sig.uuid), filehash);
+}
+
+static void*
+resource_import_directory_thread(void* arg) {
+	resource_import_pass_t* pass = arg;
+	string_const_t paths[RESOURCE_HASHCACHE_BATCH_MAX];
+	uint256_t hashes[RESOURCE_HASHCACHE_BATCH_MAX];
+	while (true) {
+		// Claim a group of jobs and hash the files together, jobs are sorted by size so
+		// files in a group are of similar size and hash in lockstep
+		size_t first =
+		    (size_t)atomic_add32(&pass->next, (int32_t)pass->group, memory_order_relaxed) -
+		    pass->group;
+		if (first >= pass->num_jobs)
+			break;
+		size_t count = pass->num_jobs - first;
+		if (count > pass->group)
+			count = pass->group;
+		for (size_t ijob = 0; ijob < count; ++ijob)
+			paths[ijob] = string_to_const(pass->jobs[first + ijob].path);
+		resource_hashcache_hash_batch(paths, count, hashes);
+
+		for (size_t ijob = first; ijob < first + count; ++ijob) {
+			const resource_import_job_t* job = pass->jobs + ijob;
+			resource_signature_t sig = resource_import_lookup(STRING_ARGS(job->path));
+			uint256_t filehash = hashes[ijob - first];
+			if (resource_import_is_up_to_date(sig, filehash)) {
+				atomic_incr32(&pass->up_to_date, memory_order_relaxed);
+			} else if (resource_import_hashed(STRING_ARGS(job->path), sig.uuid, filehash)) {
+				atomic_incr32(&pass->imported, memory_order_relaxed);
+				atomic_add64(&pass->bytes, (int64_t)job->size, memory_order_relaxed);
+			} else {
+				atomic_incr32(&pass->failed, memory_order_relaxed);
+			}
+			atomic_incr32(&pass->done, memory_order_release);
+			semaphore_post(&pass->finished);
+		}
+	}
+	return nullptr;
+}
+
+static int
+resource_import_job_compare(const void* first, const void* second) {
+	const resource_import_job_t* lhs = first;
+	const resource_import_job_t* rhs = second;
+	if (lhs->size > rhs->size)
+		return -1;
+	return (lhs->size < rhs->size) ? 1 : 0;
+}
+
+static void
+resource_import_directory_progress(resource_import_pass_t* pass, tick_t start) {
+	size_t done = (size_t)atomic_load32(&pass->done, memory_order_acquire);
+	uint64_t bytes = (uint64_t)atomic_load64(&pass->bytes, memory_order_relaxed);
+	deltatime_t elapsed = time_elapsed(start);
+	if (elapsed <= 0)
+		return;
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Import: %" PRIsize "/%" PRIsize " files, %.1f files/s, %.1f MiB/s"),
+	          done, pass->num_jobs, (double)done / (double)elapsed,
+	          ((double)bytes / (1024.0 * 1024.0)) / (double)elapsed);
+}
+
+resource_import_result_t
+resource_import_directory(const char* path, size_t length, bool recursive, size_t num_threads) {
+	resource_import_result_t result;
+	memset(&result, 0, sizeof(result));
+	if (!num_threads)
+		num_threads = system_hardware_threads();
+
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t dirpath = string_copy(buffer, sizeof(buffer), path, length);
+	dirpath = path_absolute(STRING_ARGS(dirpath), sizeof(buffer));
+
+	tick_t start = time_current();
+	resource_import_pass_t pass;
+	memset(&pass, 0, sizeof(pass));
+	string_t* files = fs_matching_files(STRING_ARGS(dirpath), STRING_CONST("^.*$"), recursive);
+	for (size_t ifile = 0, fsize = array_size(files); ifile < fsize; ++ifile) {
+		// Skip import maps, hidden and temporary files
+		string_const_t name = path_file_name(STRING_ARGS(files[ifile]));
+		if (!name.length || (name.str[0] == '.') ||
+		    string_equal(STRING_ARGS(name), STRING_CONST(RESOURCE_IMPORT_MAP)) ||
+		    string_ends_with(STRING_ARGS(name), STRING_CONST(".tmp")))
+			continue;
+		char filebuffer[BUILD_MAX_PATHLEN];
+		string_t filepath = path_concat(filebuffer, sizeof(filebuffer), STRING_ARGS(dirpath),
+		                                STRING_ARGS(files[ifile]));
+		resource_import_job_t job;
+		job.path = string_clone(STRING_ARGS(filepath));
+		job.size = fs_size(STRING_ARGS(filepath));
+		array_push(pass.jobs, job);
+	}
+	string_array_deallocate(files);
+	pass.num_jobs = array_size(pass.jobs);
+	result.files = pass.num_jobs;
+	result.enumerate_time = time_elapsed(start);
+
+	// Start largest files first to avoid a long tail on a single thread
+	if (pass.num_jobs)
+		qsort(pass.jobs, pass.num_jobs, sizeof(resource_import_job_t), resource_import_job_compare);
+
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Import: %" PRIsize " files in %.*s on %" PRIsize " threads"),
+	          pass.num_jobs, STRING_FORMAT(dirpath), num_threads);
+
+	start = time_current();
+	if (num_threads > pass.num_jobs)
+		num_threads = pass.num_jobs;
+	// Hash batches must not starve threads when there are few files
+	pass.group = num_threads ? (pass.num_jobs / num_threads) : 1;
+	if (pass.group > RESOURCE_HASHCACHE_BATCH_MAX)
+		pass.group = RESOURCE_HASHCACHE_BATCH_MAX;
+	else if (!pass.group)
+		pass.group = 1;
+	semaphore_initialize(&pass.finished, 0);
+	thread_t* threads = nullptr;
+	array_resize(threads, num_threads);
+	for (size_t ithread = 0; ithread < num_threads; ++ithread) {
+		thread_initialize(threads + ithread, resource_import_directory_thread, &pass,
+		                  STRING_CONST("resource-import"), THREAD_PRIORITY_NORMAL, 0);
+		thread_start(threads + ithread);
+	}
+
+	// Wait for each job, waking up without a finished job only to log progress
+	tick_t last_progress = start;
+	for (size_t idone = 0; idone < pass.num_jobs;) {
+		deltatime_t since = time_elapsed(last_progress);
+		unsigned int timeout = (since < 2.0f) ? (unsigned int)((2.0f - since) * 1000.0f) + 1 : 0;
+		if (semaphore_try_wait(&pass.finished, timeout))
+			++idone;
+		if (time_elapsed(last_progress) >= 2.0f) {
+			resource_import_directory_progress(&pass, start);
+			last_progress = time_current();
+		}
+	}
+
+	for (size_t ithread = 0; ithread < num_threads; ++ithread) {
+		thread_join(threads + ithread);
+		thread_finalize(threads + ithread);
+	}
+	array_deallocate(threads);
+	semaphore_finalize(&pass.finished);
+	result.import_time = time_elapsed(start);
+	if (pass.num_jobs)
+		resource_import_directory_progress(&pass, start);
+
+	result.up_to_date = (size_t)atomic_load32(&pass.up_to_date, memory_order_acquire);
+	result.imported = (size_t)atomic_load32(&pass.imported, memory_order_acquire);
+	result.failed = (size_t)atomic_load32(&pass.failed, memory_order_acquire);
+	result.bytes = (uint64_t)atomic_load64(&pass.bytes, memory_order_acquire);
+
+	for (size_t ijob = 0; ijob < pass.num_jobs; ++ijob)
+		string_deallocate(pass.jobs[ijob].path.str);
+	array_deallocate(pass.jobs);
+
+	// Persist hashes of all checked files for the next run
+	resource_hashcache_flush();
+
+	return result;
+}
+
+static void
+resource_import_identity_invalidate(void) {
+	mutex_lock(_resource_import_identity_lock);
+	_resource_import_identity = 0;
+	mutex_unlock(_resource_import_identity_lock);
+}
+
 void
 resource_import_register(resource_import_fn importer) {
 	size_t iimp, isize;
@@ -179,81 +541,101 @@ resource_import_register(resource_import_fn importer) {
 			return;
 	}
 	array_push(_resource_importers, importer);
+	resource_import_identity_invalidate();
 }
 
 void
 resource_import_register_path(const char* path, size_t length) {
-	size_t iimp, isize;
-	char buffer[BUILD_MAX_PATHLEN];
-	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
-	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
-	for (iimp = 0, isize = array_size(_resource_import_tool_path); iimp != isize; ++iimp) {
-		if (string_equal(STRING_ARGS(_resource_import_tool_path[iimp]), STRING_ARGS(pathstr)))
-			return;
+	resource_tool_register_path(RESOURCETOOL_IMPORT, path, length);
+}
+
+void
+resource_import_register_format(resource_import_fn importer, const char* extensions,
+                                size_t length, const void* magic, size_t magic_size) {
+	resource_import_register(importer);
+
+	resource_import_format_t format;
+	memset(&format, 0, sizeof(format));
+	format.importer = importer;
+	string_const_t tokens[32];
+	size_t numtokens = string_explode(extensions, length, STRING_CONST(" ,;"), tokens,
+	                                  sizeof(tokens) / sizeof(tokens[0]), false);
+	for (size_t itoken = 0; itoken < numtokens; ++itoken) {
+		hash_t extension = resource_tool_extension_hash(STRING_ARGS(tokens[itoken]));
+		if (extension)
+			array_push(format.extensions, extension);
+	}
+	if (magic_size) {
+		resource_import_magic_t leading;
+		memset(&leading, 0, sizeof(leading));
+		leading.size = (magic_size < RESOURCE_IMPORT_MAGIC_MAX) ? magic_size :
+		                                                          RESOURCE_IMPORT_MAGIC_MAX;
+		memcpy(leading.bytes, magic, leading.size);
+		array_push(format.magic, leading);
 	}
-	pathstr = string_clone(STRING_ARGS(pathstr));
-	array_push(_resource_import_tool_path, pathstr);
+	array_push(_resource_import_formats, format);
+	resource_import_identity_invalidate();
 }
 
 void
 resource_import_unregister(resource_import_fn importer) {
 	size_t iimp, isize;
+	for (size_t iformat = 0; iformat < array_size(_resource_import_formats);) {
+		resource_import_format_t* format = _resource_import_formats + iformat;
+		if (format->importer == importer) {
+			array_deallocate(format->extensions);
+			array_deallocate(format->magic);
+			array_erase(_resource_import_formats, iformat);
+			continue;
+		}
+		++iformat;
+	}
 	for (iimp = 0, isize = array_size(_resource_importers); iimp != isize; ++iimp) {
 		if (_resource_importers[iimp] == importer) {
 			array_erase(_resource_importers, iimp);
-			return;
+			break;
 		}
 	}
+	resource_import_identity_invalidate();
 }
 
 void
 resource_import_unregister_path(const char* path, size_t length) {
-	size_t iimp, isize;
-	char buffer[BUILD_MAX_PATHLEN];
-	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
-	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
-	for (iimp = 0, isize = array_size(_resource_import_tool_path); iimp != isize; ++iimp) {
-		if (string_equal(STRING_ARGS(_resource_import_tool_path[iimp]), STRING_ARGS(pathstr))) {
-			string_deallocate(_resource_import_tool_path[iimp].str);
-			array_erase(_resource_import_tool_path, iimp);
-			break;
-		}
-	}
+	resource_tool_unregister_path(RESOURCETOOL_IMPORT, path, length);
 }
 
-static stream_t*
-resource_import_open_map(const char* cpath, size_t length, bool write) {
+static resource_import_map_t*
+resource_import_open_map(const char* cpath, size_t length, bool write, bool create) {
 	char buffer[BUILD_MAX_PATHLEN];
 	string_const_t last_path;
 	string_const_t path = path_directory_name(cpath, length);
 	while (path.length > 1) {
 		string_t map_path = path_concat(buffer, sizeof(buffer), STRING_ARGS(path),
 		                                STRING_CONST(RESOURCE_IMPORT_MAP));
-		stream_t* stream = stream_open(STRING_ARGS(map_path), STREAM_IN | (write ? STREAM_OUT : 0));
-		if (stream)
-			return stream;
+		if (fs_is_file(STRING_ARGS(map_path))) {
+			resource_import_map_t* map = resource_import_map_open(STRING_ARGS(map_path), write);
+			if (map)
+				return map;
+		}
 		last_path = path;
 		path = path_directory_name(STRING_ARGS(path));
 		if (path.length >= last_path.length)
 			break;
 	}
-	if (write) {
+	if (create) {
 		path = path_directory_name(cpath, length);
 		string_t map_path = path_concat(buffer, sizeof(buffer), STRING_ARGS(path),
 		                                STRING_CONST(RESOURCE_IMPORT_MAP));
-		stream_t* stream =
-		    stream_open(STRING_ARGS(map_path), STREAM_IN | STREAM_OUT | STREAM_CREATE);
-		if (stream)
-			return stream;
+		return resource_import_map_open(STRING_ARGS(map_path), true);
 	}
 	return nullptr;
 }
 
 static FOUNDATION_NOINLINE string_const_t
-resource_import_map_subpath(stream_t* map, const char* path, size_t length) {
+resource_import_map_subpath(resource_import_map_t* map, const char* path, size_t length) {
 	string_const_t subpath;
 	string_const_t mappath;
-	mappath = stream_path(map);
+	mappath = resource_import_map_path(map);
 	mappath = path_directory_name(STRING_ARGS(mappath));
 	subpath = path_subpath(path, length, STRING_ARGS(mappath));
 	if (!subpath.length)
@@ -261,98 +643,201 @@ resource_import_map_subpath(stream_t* map, const char* path, size_t length) {
 	return subpath;
 }
 
-static FOUNDATION_NOINLINE resource_signature_t
-resource_import_map_read_and_update(stream_t* map, hash_t pathhash, const char* path, size_t length,
-                                    uint256_t update_hash) {
-	char buffer[BUILD_MAX_PATHLEN + 64];
-	string_t line;
-	resource_signature_t sig = {uuid_null(), uint256_null()};
-	// TODO: This needs to be a DB as number of imported files grow
-	while (!stream_eos(map) && uuid_is_null(sig.uuid)) {
-		hash_t linehash;
-		string_const_t linepath;
-		size_t streampos = stream_tell(map);
-
-		line = stream_read_line_buffer(map, buffer, sizeof(buffer), '\n');
-		if (line.length < 120)
-			continue;
-		if (line.str[line.length - 1] == '\r')
-			--line.length;
-
-		linehash = string_to_uint64(STRING_ARGS(line), true);
-		if (linehash != pathhash)
-			continue;
-
-		linepath = string_substr(STRING_ARGS(line), 119, line.length);
-		if (!string_equal(STRING_ARGS(linepath), path, length))
-			continue;
-
-		sig.uuid = string_to_uuid(line.str + 17, 37);
-		sig.hash = string_to_uint256(line.str + 54, 64);
+static void
+resource_autoimport_index_store(const uuid_t uuid, const char* path, size_t length,
+                                string_const_t mappath);
 
-		if (!uint256_is_null(update_hash) && !uint256_equal(sig.hash, update_hash)) {
-			if (map->mode & STREAM_OUT) {
-				string_const_t token = string_from_uint256_static(update_hash);
-				stream_seek(map, (ssize_t)streampos + 54, STREAM_SEEK_BEGIN);
-				stream_write(map, STRING_ARGS(token));
-				sig.hash = update_hash;
-			}
-		}
-	}
-	return sig;
-}
+static void
+resource_autoimport_index_purge(const uuid_t* uuids, size_t count, string_const_t mappath);
 
 uuid_t
 resource_import_map_store(const char* path, size_t length, uuid_t uuid, uint256_t sighash) {
-	string_const_t subpath;
-	hash_t pathhash;
-	resource_signature_t sig;
-
-	stream_t* map = resource_import_open_map(path, length, true);
+	resource_import_map_t* map = resource_import_open_map(path, length, true, true);
 	if (!map) {
 		log_warn(HASH_RESOURCE, WARNING_SUSPICIOUS, STRING_CONST("No map to store in"));
 		return uuid_null();
 	}
 
-	subpath = resource_import_map_subpath(map, path, length);
-	pathhash = hash(STRING_ARGS(subpath));
-	sig = resource_import_map_read_and_update(map, pathhash, STRING_ARGS(subpath), sighash);
+	string_const_t subpath = resource_import_map_subpath(map, path, length);
+	resource_signature_t sig = resource_import_map_set(map, STRING_ARGS(subpath), uuid, sighash);
+
+	// Map lock must be released before updating index, index holds autoimport lock while
+	// reading maps
+	char buffer[BUILD_MAX_PATHLEN];
+	string_const_t mappath = resource_import_map_path(map);
+	mappath = string_to_const(string_copy(buffer, sizeof(buffer), STRING_ARGS(mappath)));
+	resource_import_map_close(map);
+
+	if (!uuid_is_null(sig.uuid))
+		resource_autoimport_index_store(sig.uuid, path, length, mappath);
+
+	return sig.uuid;
+}
+
+bool
+resource_import_map_purge(const char* path, size_t length) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+	pathstr = path_absolute(STRING_ARGS(pathstr), sizeof(buffer));
 
-	if (uuid_is_null(sig.uuid)) {
-		string_const_t token;
-		char separator = ' ';
+	resource_import_map_t* map = resource_import_open_map(STRING_ARGS(pathstr), true, false);
+	if (!map)
+		return false;
 
-		stream_seek(map, 0, STREAM_SEEK_END);
+	string_const_t subpath = resource_import_map_subpath(map, STRING_ARGS(pathstr));
+	resource_signature_t sig = resource_import_map_remove(map, STRING_ARGS(subpath));
 
-		token = string_from_uint_static(pathhash, true, 16, '0');
-		stream_write(map, STRING_ARGS(token));
-		stream_write(map, &separator, 1);
+	char mapbuffer[BUILD_MAX_PATHLEN];
+	string_const_t mappath = resource_import_map_path(map);
+	mappath = string_to_const(string_copy(mapbuffer, sizeof(mapbuffer), STRING_ARGS(mappath)));
+	resource_import_map_close(map);
 
-		token = string_from_uuid_static(uuid);
-		stream_write(map, STRING_ARGS(token));
-		stream_write(map, &separator, 1);
+	if (uuid_is_null(sig.uuid))
+		return false;
 
-		token = string_from_uint256_static(sighash);
-		stream_write(map, STRING_ARGS(token));
-		stream_write(map, &separator, 1);
+	log_debugf(HASH_RESOURCE, STRING_CONST("Purged import map entry: %.*s"),
+	           STRING_FORMAT(pathstr));
+	resource_autoimport_index_purge(&sig.uuid, 1, mappath);
+	return true;
+}
 
-		stream_write(map, STRING_ARGS(subpath));
-		stream_write_endl(map);
+typedef struct resource_import_prune_pass_t resource_import_prune_pass_t;
 
-		sig.uuid = uuid;
+struct resource_import_prune_pass_t {
+	string_t* maps;
+	size_t num_maps;
+	//! Index of next map to process, shared by all prune threads
+	atomic32_t next;
+	atomic32_t entries;
+	atomic32_t pruned;
+	atomic32_t compacted;
+};
+
+static void
+resource_import_map_prune_map(resource_import_prune_pass_t* pass, const char* mappath,
+                              size_t length) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char filebuffer[BUILD_MAX_PATHLEN];
+	string_t* paths = nullptr;
+	string_t* missing = nullptr;
+	uuid_t* uuids = nullptr;
+
+	// Collect entries, then check asset files with the map closed so the map can be
+	// updated concurrently
+	resource_import_map_t* map = resource_import_map_open(mappath, length, false);
+	if (!map)
+		return;
+	size_t tombstones = resource_import_map_tombstones(map);
+	for (size_t islot = 0, capacity = resource_import_map_capacity(map); islot < capacity;
+	     ++islot) {
+		string_t path = resource_import_map_entry(map, islot, nullptr, buffer, sizeof(buffer));
+		if (path.length)
+			array_push(paths, string_clone(STRING_ARGS(path)));
+	}
+	resource_import_map_close(map);
+
+	string_const_t mapdir = path_directory_name(mappath, length);
+	for (size_t ipath = 0, psize = array_size(paths); ipath < psize; ++ipath) {
+		string_t filepath = path_is_absolute(STRING_ARGS(paths[ipath])) ?
+		                        string_copy(filebuffer, sizeof(filebuffer),
+		                                    STRING_ARGS(paths[ipath])) :
+		                        path_concat(filebuffer, sizeof(filebuffer), STRING_ARGS(mapdir),
+		                                    STRING_ARGS(paths[ipath]));
+		if (!fs_is_file(STRING_ARGS(filepath)))
+			array_push(missing, paths[ipath]);
+	}
+	atomic_add32(&pass->entries, (int32_t)array_size(paths), memory_order_relaxed);
+
+	if (array_size(missing) || tombstones) {
+		map = resource_import_map_open(mappath, length, true);
+		if (map) {
+			for (size_t ipath = 0, psize = array_size(missing); ipath < psize; ++ipath) {
+				resource_signature_t sig =
+				    resource_import_map_remove(map, STRING_ARGS(missing[ipath]));
+				if (!uuid_is_null(sig.uuid))
+					array_push(uuids, sig.uuid);
+			}
+			resource_import_map_compact(map);
+			atomic_incr32(&pass->compacted, memory_order_relaxed);
+			resource_import_map_close(map);
+		}
+		if (array_size(uuids)) {
+			log_infof(HASH_RESOURCE,
+			          STRING_CONST("Pruned %" PRIsize " entries from import map: %.*s"),
+			          array_size(uuids), (int)length, mappath);
+			atomic_add32(&pass->pruned, (int32_t)array_size(uuids), memory_order_relaxed);
+			resource_autoimport_index_purge(uuids, array_size(uuids),
+			                                string_const(mappath, length));
+		}
 	}
 
-	stream_deallocate(map);
+	string_array_deallocate(paths);
+	array_deallocate(missing);
+	array_deallocate(uuids);
+}
 
-	return sig.uuid;
+static void*
+resource_import_map_prune_thread(void* arg) {
+	resource_import_prune_pass_t* pass = arg;
+	while (true) {
+		size_t imap = (size_t)atomic_incr32(&pass->next, memory_order_relaxed) - 1;
+		if (imap >= pass->num_maps)
+			break;
+		resource_import_map_prune_map(pass, STRING_ARGS(pass->maps[imap]));
+	}
+	return nullptr;
 }
 
-bool
-resource_import_map_purge(const char* path, size_t length) {
-	// TODO: Implement
-	FOUNDATION_UNUSED(path);
-	FOUNDATION_UNUSED(length);
-	return false;
+resource_import_prune_result_t
+resource_import_map_prune(const char* path, size_t length, size_t num_threads) {
+	resource_import_prune_result_t result;
+	memset(&result, 0, sizeof(result));
+	if (!num_threads)
+		num_threads = system_hardware_threads();
+
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t dirpath = string_copy(buffer, sizeof(buffer), path, length);
+	dirpath = path_absolute(STRING_ARGS(dirpath), sizeof(buffer));
+
+	tick_t start = time_current();
+	resource_import_prune_pass_t pass;
+	memset(&pass, 0, sizeof(pass));
+	regex_t* regex = regex_compile(STRING_CONST("^" RESOURCE_IMPORT_MAP "$"));
+	string_t* maps = fs_matching_files_regex(STRING_ARGS(dirpath), regex, true);
+	for (size_t imap = 0, msize = array_size(maps); imap < msize; ++imap) {
+		char mapbuffer[BUILD_MAX_PATHLEN];
+		string_t mappath = path_concat(mapbuffer, sizeof(mapbuffer), STRING_ARGS(dirpath),
+		                               STRING_ARGS(maps[imap]));
+		array_push(pass.maps, string_clone(STRING_ARGS(mappath)));
+	}
+	string_array_deallocate(maps);
+	regex_deallocate(regex);
+	pass.num_maps = array_size(pass.maps);
+	result.maps = pass.num_maps;
+
+	if (num_threads > pass.num_maps)
+		num_threads = pass.num_maps;
+	thread_t* threads = nullptr;
+	array_resize(threads, num_threads);
+	for (size_t ithread = 0; ithread < num_threads; ++ithread) {
+		thread_initialize(threads + ithread, resource_import_map_prune_thread, &pass,
+		                  STRING_CONST("resource-prune"), THREAD_PRIORITY_NORMAL, 0);
+		thread_start(threads + ithread);
+	}
+	for (size_t ithread = 0; ithread < num_threads; ++ithread) {
+		thread_join(threads + ithread);
+		thread_finalize(threads + ithread);
+	}
+	array_deallocate(threads);
+
+	result.entries = (size_t)atomic_load32(&pass.entries, memory_order_acquire);
+	result.pruned = (size_t)atomic_load32(&pass.pruned, memory_order_acquire);
+	result.compacted = (size_t)atomic_load32(&pass.compacted, memory_order_acquire);
+	result.time = time_elapsed(start);
+
+	string_array_deallocate(pass.maps);
+
+	return result;
 }
 
 static resource_signature_t
@@ -363,15 +848,14 @@ resource_import_map_lookup(const char* path, size_t length) {
 	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
 	pathstr = path_absolute(STRING_ARGS(pathstr), sizeof(buffer));
 
-	stream_t* map = resource_import_open_map(STRING_ARGS(pathstr), false);
+	resource_import_map_t* map = resource_import_open_map(STRING_ARGS(pathstr), false, false);
 	if (!map)
 		return sig;
 
 	string_const_t subpath = resource_import_map_subpath(map, STRING_ARGS(pathstr));
-	hash_t pathhash = hash(STRING_ARGS(subpath));
-	sig = resource_import_map_read_and_update(map, pathhash, STRING_ARGS(subpath), uint256_null());
+	sig = resource_import_map_get(map, STRING_ARGS(subpath));
 
-	stream_deallocate(map);
+	resource_import_map_close(map);
 
 	return sig;
 }
@@ -397,16 +881,153 @@ static mutex_t* _resource_autoimport_lock;
 static string_t* _resource_autoimport_dir;
 static atomic64_t _resource_autoimport_token;
 
+typedef struct resource_autoimport_entry_t resource_autoimport_entry_t;
+
+//! Reverse index entry mapping a resource to the asset file it is imported from
+struct resource_autoimport_entry_t {
+	uuid_t uuid;
+	//! Hash of path of the import map holding the entry
+	hash_t map;
+	string_t path;
+};
+
+static hashmap_t* _resource_autoimport_index;
+static resource_autoimport_entry_t** _resource_autoimport_entries;
+static bool _resource_autoimport_indexed;
+//! Modification time of import maps after last store, to skip our own fs events
+static hashmap_t* _resource_autoimport_map_stored;
+
+typedef struct resource_autoimport_pending_t resource_autoimport_pending_t;
+
+//! Asset file with file system events pending until quiet for the event delay
+struct resource_autoimport_pending_t {
+	hash_t pathhash;
+	string_t path;
+	tick_t deadline;
+};
+
+static mutex_t* _resource_autoimport_pending_lock;
+static resource_autoimport_pending_t* _resource_autoimport_pending;
+//! Maps path hash to index + 1 in pending array
+static hashmap_t* _resource_autoimport_pending_map;
+static semaphore_t _resource_autoimport_signal;
+static thread_t _resource_autoimport_thread;
+static bool _resource_autoimport_started;
+static atomic32_t _resource_autoimport_terminate;
+static atomic64_t _resource_autoimport_events;
+static atomic64_t _resource_autoimport_dropped;
+static atomic64_t _resource_autoimport_processed;
+static atomic64_t _resource_autoimport_triggered;
+
+#define RESOURCE_AUTOIMPORT_QUEUE_SIZE 1024
+
+typedef struct resource_autoimport_request_t resource_autoimport_request_t;
+typedef struct resource_autoimport_cell_t resource_autoimport_cell_t;
+
+//! Work for autoimport threads, either a modified asset file path or a resource to reimport
+struct resource_autoimport_request_t {
+	uuid_t uuid;
+	string_t path;
+};
+
+//! Bounded lock-free queue cell, sequence number tracks cell state relative to queue position
+struct resource_autoimport_cell_t {
+	atomic64_t sequence;
+	resource_autoimport_request_t request;
+};
+
+static resource_autoimport_cell_t* _resource_autoimport_queue;
+static atomic64_t _resource_autoimport_queue_head;
+static atomic64_t _resource_autoimport_queue_tail;
+static semaphore_t _resource_autoimport_work;
+static thread_t* _resource_autoimport_workers;
+
+static void*
+resource_autoimport_worker(void* arg);
+
+static bool
+resource_autoimport_queue_pop(resource_autoimport_request_t* request);
+
 int
 resource_autoimport_initialize(void) {
 	_resource_autoimport_lock = mutex_allocate(STRING_CONST("resource-autoimport"));
+	_resource_autoimport_index = hashmap_allocate(8191, 8);
+	_resource_autoimport_map_stored = hashmap_allocate(67, 8);
+	_resource_autoimport_pending_lock = mutex_allocate(STRING_CONST("resource-autoimport-pending"));
+	_resource_autoimport_pending_map = hashmap_allocate(257, 8);
+	semaphore_initialize(&_resource_autoimport_signal, 0);
+	atomic_store32(&_resource_autoimport_terminate, 0, memory_order_release);
+	_resource_autoimport_started = false;
+
+	size_t num_workers = resource_module_config().autoimport_thread_count;
+	if (resource_module_config().enable_local_autoimport && num_workers) {
+		_resource_autoimport_queue =
+		    memory_allocate(HASH_RESOURCE,
+		                    sizeof(resource_autoimport_cell_t) * RESOURCE_AUTOIMPORT_QUEUE_SIZE, 0,
+		                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		for (size_t icell = 0; icell < RESOURCE_AUTOIMPORT_QUEUE_SIZE; ++icell)
+			atomic_store64(&_resource_autoimport_queue[icell].sequence, (int64_t)icell,
+			               memory_order_relaxed);
+		atomic_store64(&_resource_autoimport_queue_head, 0, memory_order_relaxed);
+		atomic_store64(&_resource_autoimport_queue_tail, 0, memory_order_release);
+		semaphore_initialize(&_resource_autoimport_work, 0);
+		array_resize(_resource_autoimport_workers, num_workers);
+		for (size_t ithread = 0; ithread < num_workers; ++ithread) {
+			thread_initialize(_resource_autoimport_workers + ithread, resource_autoimport_worker,
+			                  nullptr, STRING_CONST("resource-autoimport-worker"),
+			                  THREAD_PRIORITY_BELOWNORMAL, 0);
+			thread_start(_resource_autoimport_workers + ithread);
+		}
+	}
 	return 0;
 }
 
 void
 resource_autoimport_finalize(void) {
+	atomic_store32(&_resource_autoimport_terminate, 1, memory_order_release);
+	if (_resource_autoimport_started) {
+		semaphore_post(&_resource_autoimport_signal);
+		thread_join(&_resource_autoimport_thread);
+		thread_finalize(&_resource_autoimport_thread);
+		_resource_autoimport_started = false;
+	}
+	// Workers still processing files take the pending lock, join them before freeing it
+	if (_resource_autoimport_queue) {
+		for (size_t ithread = 0, tsize = array_size(_resource_autoimport_workers); ithread < tsize;
+		     ++ithread)
+			semaphore_post(&_resource_autoimport_work);
+		for (size_t ithread = 0, tsize = array_size(_resource_autoimport_workers); ithread < tsize;
+		     ++ithread) {
+			thread_join(_resource_autoimport_workers + ithread);
+			thread_finalize(_resource_autoimport_workers + ithread);
+		}
+		resource_autoimport_request_t request;
+		while (resource_autoimport_queue_pop(&request))
+			string_deallocate(request.path.str);
+		array_deallocate(_resource_autoimport_workers);
+		semaphore_finalize(&_resource_autoimport_work);
+		memory_deallocate(_resource_autoimport_queue);
+		_resource_autoimport_workers = nullptr;
+		_resource_autoimport_queue = nullptr;
+	}
+
+	for (size_t ipend = 0, psize = array_size(_resource_autoimport_pending); ipend < psize; ++ipend)
+		string_deallocate(_resource_autoimport_pending[ipend].path.str);
+	array_deallocate(_resource_autoimport_pending);
+	hashmap_deallocate(_resource_autoimport_pending_map);
+	semaphore_finalize(&_resource_autoimport_signal);
+	mutex_deallocate(_resource_autoimport_pending_lock);
+	_resource_autoimport_pending = nullptr;
+	_resource_autoimport_pending_map = nullptr;
+	_resource_autoimport_pending_lock = nullptr;
+
 	resource_autoimport_clear();
+	hashmap_deallocate(_resource_autoimport_map_stored);
+	hashmap_deallocate(_resource_autoimport_index);
 	mutex_deallocate(_resource_autoimport_lock);
+	_resource_autoimport_map_stored = nullptr;
+	_resource_autoimport_index = nullptr;
+	_resource_autoimport_lock = nullptr;
 }
 
 static hash_t
@@ -414,57 +1035,181 @@ resource_autoimport_token(void) {
 	return (hash_t)atomic_incr64(&_resource_autoimport_token, memory_order_acq_rel);
 }
 
-static string_t
-resource_autoimport_reverse_lookup(const uuid_t uuid, char* buffer, size_t capacity) {
-	// TODO: Improve
-	string_t result = (string_t){buffer, 0};
-	regex_t* regex;
-	size_t ipath, psize;
-	size_t imap, msize;
-	uuid_t siguuid;
-	char linebuffer[BUILD_MAX_PATHLEN];
+static void
+resource_autoimport_index_clear(void) {
+	for (size_t ientry = 0, esize = array_size(_resource_autoimport_entries); ientry < esize;
+	     ++ientry) {
+		string_deallocate(_resource_autoimport_entries[ientry]->path.str);
+		memory_deallocate(_resource_autoimport_entries[ientry]);
+	}
+	array_deallocate(_resource_autoimport_entries);
+	if (_resource_autoimport_index)
+		hashmap_clear(_resource_autoimport_index);
+	if (_resource_autoimport_map_stored)
+		hashmap_clear(_resource_autoimport_map_stored);
+	_resource_autoimport_entries = nullptr;
+	_resource_autoimport_indexed = false;
+}
+
+static void
+resource_autoimport_index_insert(const uuid_t uuid, hash_t map, const char* path,
+                                 size_t length) {
+	hash_t key = hash(&uuid, sizeof(uuid));
+	resource_autoimport_entry_t* entry = hashmap_lookup(_resource_autoimport_index, key);
+	if (entry && !uuid_equal(entry->uuid, uuid)) {
+		string_const_t uuidstr = string_from_uuid_static(uuid);
+		log_warnf(HASH_RESOURCE, WARNING_SUSPICIOUS,
+		          STRING_CONST("Autoimport index key collision for resource %.*s: %.*s"),
+		          STRING_FORMAT(uuidstr), (int)length, path);
+		return;
+	}
+	if (!entry) {
+		entry = memory_allocate(HASH_RESOURCE, sizeof(resource_autoimport_entry_t), 0,
+		                        MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+		entry->uuid = uuid;
+		hashmap_insert(_resource_autoimport_index, key, entry);
+		array_push(_resource_autoimport_entries, entry);
+	} else if (string_equal(STRING_ARGS(entry->path), path, length)) {
+		entry->map = map;
+		return;
+	}
+	string_deallocate(entry->path.str);
+	entry->path = string_clone(path, length);
+	entry->map = map;
+}
 
-	regex = regex_compile(STRING_CONST("^" RESOURCE_IMPORT_MAP "$"));
+static void
+resource_autoimport_index_remove_map(hash_t map) {
+	for (size_t ientry = 0; ientry < array_size(_resource_autoimport_entries);) {
+		resource_autoimport_entry_t* entry = _resource_autoimport_entries[ientry];
+		if (entry->map != map) {
+			++ientry;
+			continue;
+		}
+		hashmap_erase(_resource_autoimport_index, hash(&entry->uuid, sizeof(entry->uuid)));
+		string_deallocate(entry->path.str);
+		memory_deallocate(entry);
+		array_erase(_resource_autoimport_entries, ientry);
+	}
+}
 
-	for (ipath = 0, psize = array_size(_resource_autoimport_dir); !result.length && (ipath < psize);
-	     ++ipath) {
+static void
+resource_autoimport_index_add_map(const char* mappath, size_t length) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char entrybuffer[BUILD_MAX_PATHLEN];
+	resource_import_map_t* map = resource_import_map_open(mappath, length, false);
+	if (!map)
+		return;
+
+	hash_t maphash = hash(mappath, length);
+	string_const_t mapdir = path_directory_name(mappath, length);
+	for (size_t islot = 0, ssize = resource_import_map_capacity(map); islot < ssize; ++islot) {
+		resource_signature_t sig;
+		string_t entrypath =
+		    resource_import_map_entry(map, islot, &sig, entrybuffer, sizeof(entrybuffer));
+		if (!entrypath.length || uuid_is_null(sig.uuid))
+			continue;
+		string_t path =
+		    path_concat(buffer, sizeof(buffer), STRING_ARGS(mapdir), STRING_ARGS(entrypath));
+		resource_autoimport_index_insert(sig.uuid, maphash, STRING_ARGS(path));
+	}
+
+	resource_import_map_close(map);
+}
+
+static void
+resource_autoimport_index_build(void) {
+	char buffer[BUILD_MAX_PATHLEN];
+	tick_t start = time_current();
+	resource_autoimport_index_clear();
+
+	regex_t* regex = regex_compile(STRING_CONST("^" RESOURCE_IMPORT_MAP "$"));
+	for (size_t ipath = 0, psize = array_size(_resource_autoimport_dir); ipath < psize; ++ipath) {
 		string_t* maps =
 		    fs_matching_files_regex(STRING_ARGS(_resource_autoimport_dir[ipath]), regex, true);
-		for (imap = 0, msize = array_size(maps); !result.length && (imap < msize); ++imap) {
+		for (size_t imap = 0, msize = array_size(maps); imap < msize; ++imap) {
 			string_t mappath =
-			    path_concat(linebuffer, sizeof(linebuffer),
-			                STRING_ARGS(_resource_autoimport_dir[ipath]), STRING_ARGS(maps[imap]));
-			stream_t* map = stream_open(STRING_ARGS(mappath), STREAM_IN);
-
-			while (map && !stream_eos(map)) {
-				string_t line = stream_read_line_buffer(map, linebuffer, sizeof(linebuffer), '\n');
-				if (line.length < 120)
-					continue;
-				if (line.str[line.length - 1] == '\r')
-					--line.length;
-
-				siguuid = string_to_uuid(line.str + 17, 37);
-				if (uuid_equal(uuid, siguuid)) {
-					string_const_t linepath = string_substr(STRING_ARGS(line), 119, line.length);
-					string_const_t mapdir = stream_path(map);
-					mapdir = path_directory_name(STRING_ARGS(mapdir));
-					result =
-					    path_concat(buffer, capacity, STRING_ARGS(mapdir), STRING_ARGS(linepath));
+			    path_concat(buffer, sizeof(buffer), STRING_ARGS(_resource_autoimport_dir[ipath]),
+			                STRING_ARGS(maps[imap]));
+			resource_autoimport_index_add_map(STRING_ARGS(mappath));
+		}
+		string_array_deallocate(maps);
+	}
+	regex_deallocate(regex);
+
+	_resource_autoimport_indexed = true;
+	log_debugf(HASH_RESOURCE,
+	           STRING_CONST("Autoimport index built: %" PRIsize " resources (%.3fs)"),
+	           array_size(_resource_autoimport_entries), (double)time_elapsed(start));
+}
+
+static void
+resource_autoimport_index_store(const uuid_t uuid, const char* path, size_t length,
+                                string_const_t mappath) {
+	char buffer[BUILD_MAX_PATHLEN];
+	if (!_resource_autoimport_lock)
+		return;
+	mutex_lock(_resource_autoimport_lock);
+	if (_resource_autoimport_indexed) {
+		string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+		pathstr = path_absolute(STRING_ARGS(pathstr), sizeof(buffer));
+		hash_t maphash = hash(STRING_ARGS(mappath));
+		resource_autoimport_index_insert(uuid, maphash, STRING_ARGS(pathstr));
+		tick_t modified = fs_last_modified(STRING_ARGS(mappath));
+		hashmap_insert(_resource_autoimport_map_stored, maphash, (void*)(uintptr_t)modified);
+	}
+	mutex_unlock(_resource_autoimport_lock);
+}
+
+static void
+resource_autoimport_index_purge(const uuid_t* uuids, size_t count, string_const_t mappath) {
+	if (!_resource_autoimport_lock)
+		return;
+	mutex_lock(_resource_autoimport_lock);
+	if (_resource_autoimport_indexed) {
+		for (size_t iuuid = 0; iuuid < count; ++iuuid) {
+			hash_t key = hash(uuids + iuuid, sizeof(uuid_t));
+			resource_autoimport_entry_t* entry = hashmap_lookup(_resource_autoimport_index, key);
+			if (!entry || !uuid_equal(entry->uuid, uuids[iuuid]))
+				continue;
+			hashmap_erase(_resource_autoimport_index, key);
+			for (size_t ientry = 0, esize = array_size(_resource_autoimport_entries);
+			     ientry < esize; ++ientry) {
+				if (_resource_autoimport_entries[ientry] == entry) {
+					array_erase(_resource_autoimport_entries, ientry);
 					break;
 				}
 			}
-
-			stream_deallocate(map);
+			string_deallocate(entry->path.str);
+			memory_deallocate(entry);
 		}
-
-		string_array_deallocate(maps);
+		hash_t maphash = hash(STRING_ARGS(mappath));
+		tick_t modified = fs_last_modified(STRING_ARGS(mappath));
+		hashmap_insert(_resource_autoimport_map_stored, maphash, (void*)(uintptr_t)modified);
 	}
+	mutex_unlock(_resource_autoimport_lock);
+}
 
-	regex_deallocate(regex);
-
+static string_t
+resource_autoimport_reverse_lookup(const uuid_t uuid, char* buffer, size_t capacity) {
+	string_t result = (string_t){buffer, 0};
+	if (!_resource_autoimport_indexed)
+		resource_autoimport_index_build();
+	resource_autoimport_entry_t* entry =
+	    hashmap_lookup(_resource_autoimport_index, hash(&uuid, sizeof(uuid)));
+	if (entry && uuid_equal(entry->uuid, uuid))
+		result = string_copy(buffer, capacity, STRING_ARGS(entry->path));
 	return result;
 }
 
+string_t
+resource_autoimport_lookup(const uuid_t uuid, char* buffer, size_t capacity) {
+	mutex_lock(_resource_autoimport_lock);
+	string_t path = resource_autoimport_reverse_lookup(uuid, buffer, capacity);
+	mutex_unlock(_resource_autoimport_lock);
+	return path;
+}
+
 bool
 resource_autoimport(const uuid_t uuid) {
 	if (!resource_module_config().enable_local_autoimport)
@@ -487,11 +1232,9 @@ resource_autoimport(const uuid_t uuid) {
 static bool
 resource_autoimport_source_changed(const char* path, size_t length, uint256_t map_hash,
                                    uint256_t import_hash, uint256_t* newhash) {
-	stream_t* stream = stream_open(path, length, STREAM_IN);
-	if (!stream)
+	uint256_t testhash = resource_hashcache_hash(path, length);
+	if (uint256_is_null(testhash))
 		return false;
-	uint256_t testhash = stream_sha256(stream);
-	stream_deallocate(stream);
 	if (newhash)
 		*newhash = testhash;
 	return !uint256_equal(map_hash, testhash) || !uint256_equal(import_hash, testhash);
@@ -550,6 +1293,7 @@ resource_autoimport_unwatch_dir(const char* path, size_t length) {
 	fs_unmonitor(path, length);
 	string_deallocate(_resource_autoimport_dir[idx].str);
 	array_erase(_resource_autoimport_dir, idx);
+	resource_autoimport_index_clear();
 }
 
 static void
@@ -575,8 +1319,10 @@ resource_autoimport_watch_dir(const char* path, size_t length) {
 			}
 		}
 		log_debugf(HASH_RESOURCE, STRING_CONST("Autoimport watch dir: %.*s"), (int)length, path);
-		if (fs_monitor(path, length))
+		if (fs_monitor(path, length)) {
 			array_push(_resource_autoimport_dir, string_clone(path, length));
+			resource_autoimport_index_clear();
+		}
 	}
 }
 
@@ -621,50 +1367,301 @@ resource_autoimport_clear(void) {
 	for (ipath = 0, psize = array_size(_resource_autoimport_dir); ipath < psize; ++ipath)
 		fs_unmonitor(STRING_ARGS(_resource_autoimport_dir[ipath]));
 	string_array_deallocate(_resource_autoimport_dir);
+	resource_autoimport_index_clear();
 	mutex_unlock(_resource_autoimport_lock);
 }
 
 static uuid_t _resource_autoimport_last_uuid;
 static uint256_t _resource_autoimport_last_hash;
 
+static void
+resource_autoimport_index_refresh(const char* mappath, size_t length, bool deleted) {
+	mutex_lock(_resource_autoimport_lock);
+	if (_resource_autoimport_indexed) {
+		hash_t maphash = hash(mappath, length);
+		tick_t modified = deleted ? 0 : fs_last_modified(mappath, length);
+		tick_t stored = (tick_t)(uintptr_t)hashmap_lookup(_resource_autoimport_map_stored, maphash);
+		if (deleted || !stored || (stored != modified)) {
+			log_debugf(HASH_RESOURCE, STRING_CONST("Autoimport index refresh: %.*s"), (int)length,
+			           mappath);
+			hashmap_erase(_resource_autoimport_map_stored, maphash);
+			resource_autoimport_index_remove_map(maphash);
+			if (!deleted)
+				resource_autoimport_index_add_map(mappath, length);
+		}
+	}
+	mutex_unlock(_resource_autoimport_lock);
+}
+
+static void
+resource_autoimport_process(const char* path, size_t length) {
+	const resource_signature_t sig = resource_import_map_lookup(path, length);
+	if (uuid_is_null(sig.uuid))
+		return;
+	uint256_t import_hash = resource_source_import_hash(sig.uuid);
+	uint256_t newhash;
+	if (!resource_autoimport_source_changed(path, length, sig.hash, import_hash, &newhash))
+		return;
+
+	// Suppress multiple events on same file in sequence
+	mutex_lock(_resource_autoimport_pending_lock);
+	bool repeated = uuid_equal(sig.uuid, _resource_autoimport_last_uuid) &&
+	                uint256_equal(newhash, _resource_autoimport_last_hash);
+	_resource_autoimport_last_uuid = sig.uuid;
+	_resource_autoimport_last_hash = newhash;
+	mutex_unlock(_resource_autoimport_pending_lock);
+	if (repeated)
+		return;
+	atomic_incr64(&_resource_autoimport_triggered, memory_order_relaxed);
+
+	hash_t token = resource_autoimport_token();
+#if BUILD_ENABLE_DEBUG_LOG
+	size_t num_reverse = resource_source_num_reverse_dependencies(sig.uuid, 0);
+	const string_const_t uuidstr = string_from_uuid_static(sig.uuid);
+	log_debugf(HASH_RESOURCE,
+	           STRING_CONST("Autoimport event trigger: %.*s (%.*s) : %" PRIsize
+	                        " reverse dependencies"),
+	           (int)length, path, STRING_FORMAT(uuidstr), num_reverse);
+#endif
+	resource_event_post(RESOURCEEVENT_MODIFY, sig.uuid, 0, token);
+	resource_event_post_depends(sig.uuid, 0, token);
+}
+
+static bool
+resource_autoimport_queue_push(const resource_autoimport_request_t* request) {
+	if (!_resource_autoimport_queue)
+		return false;
+	resource_autoimport_cell_t* cell;
+	int64_t pos = atomic_load64(&_resource_autoimport_queue_tail, memory_order_relaxed);
+	while (true) {
+		cell = _resource_autoimport_queue + (pos & (RESOURCE_AUTOIMPORT_QUEUE_SIZE - 1));
+		int64_t sequence = atomic_load64(&cell->sequence, memory_order_acquire);
+		if (sequence == pos) {
+			if (atomic_cas64(&_resource_autoimport_queue_tail, pos + 1, pos, memory_order_relaxed,
+			                 memory_order_relaxed))
+				break;
+		} else if (sequence < pos) {
+			// Queue is full
+			return false;
+		}
+		pos = atomic_load64(&_resource_autoimport_queue_tail, memory_order_relaxed);
+	}
+	cell->request = *request;
+	atomic_store64(&cell->sequence, pos + 1, memory_order_release);
+	semaphore_post(&_resource_autoimport_work);
+	return true;
+}
+
+static bool
+resource_autoimport_queue_pop(resource_autoimport_request_t* request) {
+	resource_autoimport_cell_t* cell;
+	int64_t pos = atomic_load64(&_resource_autoimport_queue_head, memory_order_relaxed);
+	while (true) {
+		cell = _resource_autoimport_queue + (pos & (RESOURCE_AUTOIMPORT_QUEUE_SIZE - 1));
+		int64_t sequence = atomic_load64(&cell->sequence, memory_order_acquire);
+		if (sequence == pos + 1) {
+			if (atomic_cas64(&_resource_autoimport_queue_head, pos + 1, pos, memory_order_relaxed,
+			                 memory_order_relaxed))
+				break;
+		} else if (sequence < pos + 1) {
+			// Queue is empty
+			return false;
+		}
+		pos = atomic_load64(&_resource_autoimport_queue_head, memory_order_relaxed);
+	}
+	*request = cell->request;
+	atomic_store64(&cell->sequence, pos + RESOURCE_AUTOIMPORT_QUEUE_SIZE, memory_order_release);
+	return true;
+}
+
+static void
+resource_autoimport_reimport(const uuid_t uuid) {
+	if (!resource_autoimport_need_update(uuid, 0))
+		return;
+	string_const_t uuidstr = string_from_uuid_static(uuid);
+	log_debugf(HASH_RESOURCE, STRING_CONST("Reimporting resource %.*s (autoimport worker)"),
+	           STRING_FORMAT(uuidstr));
+	if (resource_autoimport(uuid)) {
+		hash_t token = resource_autoimport_token();
+		resource_event_post(RESOURCEEVENT_MODIFY, uuid, 0, token);
+		resource_event_post_depends(uuid, 0, token);
+	}
+}
+
+static void*
+resource_autoimport_worker(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	resource_autoimport_request_t request;
+	while (!atomic_load32(&_resource_autoimport_terminate, memory_order_acquire)) {
+		semaphore_wait(&_resource_autoimport_work);
+		while (!atomic_load32(&_resource_autoimport_terminate, memory_order_acquire) &&
+		       resource_autoimport_queue_pop(&request)) {
+			if (request.path.length) {
+				resource_autoimport_process(STRING_ARGS(request.path));
+				string_deallocate(request.path.str);
+			} else {
+				resource_autoimport_reimport(request.uuid);
+			}
+		}
+	}
+	return nullptr;
+}
+
+bool
+resource_autoimport_request(const uuid_t uuid) {
+	resource_autoimport_request_t request;
+	request.uuid = uuid;
+	request.path = string(nullptr, 0);
+	return resource_autoimport_queue_push(&request);
+}
+
+static tick_t
+resource_autoimport_delay(void) {
+	unsigned int delay = resource_module_config().autoimport_event_delay;
+	if (!delay)
+		delay = 100;
+	return (time_ticks_per_second() * (tick_t)delay) / 1000;
+}
+
+static void*
+resource_autoimport_thread(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	unsigned int timeout = 0;
+	resource_autoimport_pending_t* ready = nullptr;
+	while (!atomic_load32(&_resource_autoimport_terminate, memory_order_acquire)) {
+		if (timeout)
+			semaphore_try_wait(&_resource_autoimport_signal, timeout);
+		else
+			semaphore_wait(&_resource_autoimport_signal);
+		if (atomic_load32(&_resource_autoimport_terminate, memory_order_acquire))
+			break;
+
+		// Collect files that have been quiet for the full delay and compact the rest
+		tick_t now = time_current();
+		tick_t next = 0;
+		mutex_lock(_resource_autoimport_pending_lock);
+		size_t psize = array_size(_resource_autoimport_pending);
+		size_t ikeep = 0;
+		for (size_t ipend = 0; ipend < psize; ++ipend) {
+			resource_autoimport_pending_t* pending = _resource_autoimport_pending + ipend;
+			if (pending->deadline <= now) {
+				array_push(ready, *pending);
+				continue;
+			}
+			if (!next || (pending->deadline < next))
+				next = pending->deadline;
+			_resource_autoimport_pending[ikeep++] = *pending;
+		}
+		if (ikeep != psize) {
+			array_resize(_resource_autoimport_pending, ikeep);
+			hashmap_clear(_resource_autoimport_pending_map);
+			for (size_t ipend = 0; ipend < ikeep; ++ipend)
+				hashmap_insert(_resource_autoimport_pending_map,
+				               _resource_autoimport_pending[ipend].pathhash,
+				               (void*)(uintptr_t)(ipend + 1));
+		}
+		mutex_unlock(_resource_autoimport_pending_lock);
+
+		timeout = 0;
+		if (next)
+			timeout = (unsigned int)((time_ticks_to_seconds(next - now) * 1000.0) + 1.0);
+
+		// Hand files to the autoimport threads if any, process directly if queue is full
+		for (size_t iready = 0, rsize = array_size(ready); iready < rsize; ++iready) {
+			resource_autoimport_request_t request;
+			request.uuid = uuid_null();
+			request.path = ready[iready].path;
+			if (resource_autoimport_queue_push(&request))
+				continue;
+			resource_autoimport_process(STRING_ARGS(ready[iready].path));
+			string_deallocate(ready[iready].path.str);
+		}
+		atomic_add64(&_resource_autoimport_processed, (int64_t)array_size(ready),
+		             memory_order_relaxed);
+		array_clear(ready);
+	}
+	array_deallocate(ready);
+	return nullptr;
+}
+
+static void
+resource_autoimport_pending_push(const char* path, size_t length) {
+	hash_t pathhash = hash(path, length);
+	tick_t deadline = time_current() + resource_autoimport_delay();
+
+	mutex_lock(_resource_autoimport_pending_lock);
+	size_t index = (size_t)(uintptr_t)hashmap_lookup(_resource_autoimport_pending_map, pathhash);
+	if (index) {
+		// Restart the delay for a file already pending to let saves settle
+		_resource_autoimport_pending[index - 1].deadline = deadline;
+		atomic_incr64(&_resource_autoimport_dropped, memory_order_relaxed);
+	} else {
+		resource_autoimport_pending_t pending = {pathhash, string_clone(path, length), deadline};
+		array_push(_resource_autoimport_pending, pending);
+		hashmap_insert(_resource_autoimport_pending_map, pathhash,
+		               (void*)(uintptr_t)array_size(_resource_autoimport_pending));
+	}
+	if (!_resource_autoimport_started) {
+		// Thread is started on first use
+		thread_initialize(&_resource_autoimport_thread, resource_autoimport_thread, nullptr,
+		                  STRING_CONST("resource-autoimport"), THREAD_PRIORITY_BELOWNORMAL, 0);
+		thread_start(&_resource_autoimport_thread);
+		_resource_autoimport_started = true;
+	}
+	mutex_unlock(_resource_autoimport_pending_lock);
+
+	semaphore_post(&_resource_autoimport_signal);
+}
+
 void
 resource_autoimport_event_handle(event_t* event) {
 	if (!resource_module_config().enable_local_autoimport)
 		return;
 
-	if ((event->id != FOUNDATIONEVENT_FILE_MODIFIED) && (event->id != FOUNDATIONEVENT_FILE_CREATED))
+	if ((event->id != FOUNDATIONEVENT_FILE_MODIFIED) &&
+	    (event->id != FOUNDATIONEVENT_FILE_CREATED) && (event->id != FOUNDATIONEVENT_FILE_DELETED))
 		return;
 
 	const string_const_t path = fs_event_path(event);
+	string_const_t filename = path_file_name(STRING_ARGS(path));
+	if (string_equal(STRING_ARGS(filename), STRING_CONST(RESOURCE_IMPORT_MAP))) {
+		resource_autoimport_index_refresh(STRING_ARGS(path),
+		                                  event->id == FOUNDATIONEVENT_FILE_DELETED);
+		return;
+	}
+	if (event->id == FOUNDATIONEVENT_FILE_DELETED) {
+		resource_hashcache_forget(STRING_ARGS(path));
+		return;
+	}
+
+	bool watched = false;
+	mutex_lock(_resource_autoimport_lock);
 	for (size_t ipath = 0, psize = array_size(_resource_autoimport_dir); ipath < psize; ++ipath) {
 		if (path_subpath(STRING_ARGS(path), STRING_ARGS(_resource_autoimport_dir[ipath])).length) {
-			const resource_signature_t sig = resource_import_map_lookup(STRING_ARGS(path));
-			uint256_t import_hash = resource_source_import_hash(sig.uuid);
-			uint256_t newhash;
-			if (!uuid_is_null(sig.uuid) &&
-			    resource_autoimport_source_changed(STRING_ARGS(path), sig.hash, import_hash,
-			                                       &newhash)) {
-				// Suppress multiple events on same file in sequence
-				if (!uuid_equal(sig.uuid, _resource_autoimport_last_uuid) ||
-				    !uint256_equal(newhash, _resource_autoimport_last_hash)) {
-					_resource_autoimport_last_uuid = sig.uuid;
-					_resource_autoimport_last_hash = newhash;
-
-					hash_t token = resource_autoimport_token();
-#if BUILD_ENABLE_DEBUG_LOG
-					size_t num_reverse = resource_source_num_reverse_dependencies(sig.uuid, 0);
-					const string_const_t uuidstr = string_from_uuid_static(sig.uuid);
-					log_debugf(HASH_RESOURCE,
-					           STRING_CONST("Autoimport event trigger: %.*s (%.*s) : %" PRIsize
-					                        " reverse dependencies"),
-					           STRING_FORMAT(path), STRING_FORMAT(uuidstr), num_reverse);
-#endif
-					resource_event_post(RESOURCEEVENT_MODIFY, sig.uuid, 0, token);
-					resource_event_post_depends(sig.uuid, 0, token);
-				}
-			}
+			watched = true;
+			break;
 		}
 	}
+	mutex_unlock(_resource_autoimport_lock);
+	if (!watched)
+		return;
+
+	// Coalesce events on the same file, file is checked once quiet for the event delay
+	atomic_incr64(&_resource_autoimport_events, memory_order_relaxed);
+	resource_autoimport_pending_push(STRING_ARGS(path));
+}
+
+resource_autoimport_statistics_t
+resource_autoimport_statistics(void) {
+	resource_autoimport_statistics_t statistics;
+	statistics.events = (uint64_t)atomic_load64(&_resource_autoimport_events, memory_order_acquire);
+	statistics.dropped =
+	    (uint64_t)atomic_load64(&_resource_autoimport_dropped, memory_order_acquire);
+	statistics.processed =
+	    (uint64_t)atomic_load64(&_resource_autoimport_processed, memory_order_acquire);
+	statistics.triggered =
+	    (uint64_t)atomic_load64(&_resource_autoimport_triggered, memory_order_acquire);
+	return statistics;
 }
 
 #else
@@ -677,6 +1674,17 @@ resource_import(const char* path, size_t length, const uuid_t uuid) {
 	return false;
 }
 
+resource_import_result_t
+resource_import_directory(const char* path, size_t length, bool recursive, size_t num_threads) {
+	resource_import_result_t result;
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+	FOUNDATION_UNUSED(recursive);
+	FOUNDATION_UNUSED(num_threads);
+	memset(&result, 0, sizeof(result));
+	return result;
+}
+
 resource_signature_t
 resource_import_lookup(const char* path, size_t length) {
 	resource_signature_t sig;
@@ -697,6 +1705,16 @@ resource_import_register_path(const char* path, size_t length) {
 	FOUNDATION_UNUSED(length);
 }
 
+void
+resource_import_register_format(resource_import_fn importer, const char* extensions,
+                                size_t length, const void* magic, size_t magic_size) {
+	FOUNDATION_UNUSED(importer);
+	FOUNDATION_UNUSED(extensions);
+	FOUNDATION_UNUSED(length);
+	FOUNDATION_UNUSED(magic);
+	FOUNDATION_UNUSED(magic_size);
+}
+
 void
 resource_import_unregister(resource_import_fn importer) {
 	FOUNDATION_UNUSED(importer);
@@ -724,6 +1742,16 @@ resource_import_map_purge(const char* path, size_t length) {
 	return false;
 }
 
+resource_import_prune_result_t
+resource_import_map_prune(const char* path, size_t length, size_t num_threads) {
+	resource_import_prune_result_t result;
+	FOUNDATION_UNUSED(path);
+	FOUNDATION_UNUSED(length);
+	FOUNDATION_UNUSED(num_threads);
+	memset(&result, 0, sizeof(result));
+	return result;
+}
+
 int
 resource_autoimport_initialize(void) {
 	return 0;
@@ -746,6 +1774,13 @@ resource_autoimport_need_update(const uuid_t uuid, uint64_t platform) {
 	return false;
 }
 
+string_t
+resource_autoimport_lookup(const uuid_t uuid, char* buffer, size_t capacity) {
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(capacity);
+	return (string_t){buffer, 0};
+}
+
 void
 resource_autoimport_watch(const char* path, size_t length) {
 	FOUNDATION_UNUSED(path);
@@ -767,4 +1802,17 @@ resource_autoimport_event_handle(event_t* event) {
 	FOUNDATION_UNUSED(event);
 }
 
+resource_autoimport_statistics_t
+resource_autoimport_statistics(void) {
+	resource_autoimport_statistics_t statistics;
+	memset(&statistics, 0, sizeof(statistics));
+	return statistics;
+}
+
+bool
+resource_autoimport_request(const uuid_t uuid) {
+	FOUNDATION_UNUSED(uuid);
+	return false;
+}
+
 #endif
@@ -31,9 +31,44 @@ resource_import_set_base_path(const char* path, size_t length);
 RESOURCE_API bool
 resource_import(const char* path, size_t length, const uuid_t uuid);
 
+/*! Import all asset files in a directory on a pool of threads. Files which are
+already mapped with an unchanged content hash are skipped. The number of concurrently
+running external import tools is limited by the tool process limit in the config.
+Files not in the file hash cache are hashed in groups with the multi-buffer SHA-256
+engine. Progress and throughput is logged while importing.
+\param path Directory path
+\param length Length of path
+\param recursive Flag to import files in subdirectories
+\param num_threads Number of import threads, 0 for number of hardware threads
+\return Import result */
+RESOURCE_API resource_import_result_t
+resource_import_directory(const char* path, size_t length, bool recursive, size_t num_threads);
+
+/*! Cancel an in-flight import of a source file by killing the external import
+tools running for it
+\param path Source file path
+\param length Length of path
+\return true if a running tool was cancelled, false if not */
+RESOURCE_API bool
+resource_import_cancel(const char* path, size_t length);
+
 RESOURCE_API void
 resource_import_register(resource_import_fn importer);
 
+/*! Register an importer with the asset file format it handles. Files are routed by
+extension and leading magic bytes to the importers declaring a matching format, tried
+before importers registered without a format declaration. Importers declaring other
+formats are not tried. Can be called multiple times for an importer to declare
+multiple formats.
+\param importer Importer
+\param extensions File extensions separated by space, comma or semicolon
+\param length Length of extensions string
+\param magic Leading magic bytes, null if none
+\param magic_size Number of magic bytes, at most RESOURCE_IMPORT_MAGIC_MAX */
+RESOURCE_API void
+resource_import_register_format(resource_import_fn importer, const char* extensions,
+                                size_t length, const void* magic, size_t magic_size);
+
 RESOURCE_API void
 resource_import_register_path(const char* path, size_t length);
 
@@ -49,9 +84,26 @@ resource_import_lookup(const char* path, size_t length);
 RESOURCE_API uuid_t
 resource_import_map_store(const char* path, size_t length, uuid_t uuid, uint256_t sighash);
 
+/*! Remove the import map entry for an asset file, for example when the asset has been
+deleted or renamed. The entry slot is left as a tombstone and the map is compacted once
+enough entries have been removed. The resource itself is not removed from the source
+repository, and the asset file will get a new UUID if imported again.
+\param path Asset file path
+\param length Length of path
+\return true if an entry was removed, false if the path was not mapped */
 RESOURCE_API bool
 resource_import_map_purge(const char* path, size_t length);
 
+/*! Remove entries for asset files that no longer exist from all import maps in a
+directory and its subdirectories, and compact the maps that had entries removed. Import
+maps are processed in parallel on a pool of threads.
+\param path Directory path
+\param length Length of path
+\param num_threads Number of threads, 0 for number of hardware threads
+\return Prune result */
+RESOURCE_API resource_import_prune_result_t
+resource_import_map_prune(const char* path, size_t length, size_t num_threads);
+
 
 RESOURCE_API bool
 resource_autoimport(const uuid_t uuid);
@@ -59,6 +111,26 @@ resource_autoimport(const uuid_t uuid);
 RESOURCE_API bool
 resource_autoimport_need_update(const uuid_t uuid, uint64_t platform);
 
+/*! Queue a reimport of a resource on the autoimport threads if the imported asset
+file has changed. A RESOURCEEVENT_MODIFY event is posted once the resource has been
+reimported. Requires autoimport_thread_count in the config to be non-zero.
+\param uuid Resource UUID
+\return true if queued, false if there are no autoimport threads or the queue is
+        full, in which case the caller should import synchronously */
+RESOURCE_API bool
+resource_autoimport_request(const uuid_t uuid);
+
+/*! Lookup path of the asset file a resource is imported from, through the import maps
+in watched autoimport directories. Uses an index of all mapped resources which is built
+on first use, updated when resources are stored in import maps and refreshed when
+import maps are modified.
+\param uuid Resource UUID
+\param buffer Path buffer
+\param capacity Capacity of path buffer
+\return Asset file path, empty if not found */
+RESOURCE_API string_t
+resource_autoimport_lookup(const uuid_t uuid, char* buffer, size_t capacity);
+
 RESOURCE_API void
 resource_autoimport_watch(const char* path, size_t length);
 
@@ -68,8 +140,15 @@ resource_autoimport_unwatch(const char* path, size_t length);
 RESOURCE_API void
 resource_autoimport_clear(void);
 
-/*! Handle foundation events from fs_event_stream event stream.
-No other event types should be passed to this function.
+/*! Handle foundation events from fs_event_stream event stream. Events for asset
+files in watched directories are coalesced per file and processed in a batch on a
+background thread once no new event for the file has been seen within the configured
+delay. No other event types should be passed to this function.
 \param event Foundation event */
 RESOURCE_API void
 resource_autoimport_event_handle(event_t* event);
+
+/*! Get autoimport file system event statistics
+\return Statistics */
+RESOURCE_API resource_autoimport_statistics_t
+resource_autoimport_statistics(void);
@@ -0,0 +1,635 @@
+/* importmap.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+
+#if FOUNDATION_PLATFORM_WINDOWS
+#include <foundation/windows.h>
+#elif FOUNDATION_PLATFORM_POSIX
+#include <foundation/posix.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#endif
+
+/* Indexed import map file layout, all values in native byte order:
+   header, open addressed hash table of fixed size slots keyed by path hash and a string
+   area holding the paths. A slot with zero path length is empty. Removed entries are
+   left as tombstones, empty slots with the offset set to RESOURCE_IMPORT_MAP_TOMBSTONE,
+   which continue probe sequences. The table is compacted, rebuilt from the live entries
+   dropping tombstones and unreferenced path strings, when more than three quarters of
+   the slots are used or tombstoned, or when more than a quarter are tombstones.
+   Importer tools in other processes update the same file, so every map operation also holds
+   an advisory lock on the file itself, shared for reads and exclusive for writes. */
+
+#define RESOURCE_IMPORT_MAP_MAGIC 0x50414d49
+#define RESOURCE_IMPORT_MAP_VERSION 1
+#define RESOURCE_IMPORT_MAP_MIN_CAPACITY 64
+#define RESOURCE_IMPORT_MAP_TOMBSTONE 0xFFFFFFFF
+#define RESOURCE_IMPORT_MAP_LOCKS 32
+
+typedef struct resource_import_map_header_t resource_import_map_header_t;
+typedef struct resource_import_map_slot_t resource_import_map_slot_t;
+
+struct resource_import_map_header_t {
+	uint32_t magic;
+	uint32_t version;
+	//! Number of slots, power of two
+	uint32_t capacity;
+	//! Number of used slots
+	uint32_t count;
+	//! Size of string area in bytes
+	uint64_t strings;
+	//! Number of tombstone slots
+	uint32_t tombstones;
+	uint32_t reserved;
+};
+
+struct resource_import_map_slot_t {
+	hash_t pathhash;
+	uuid_t uuid;
+	uint256_t hash;
+	//! Offset of path in string area
+	uint32_t offset;
+	//! Length of path, zero if slot is empty or a tombstone
+	uint32_t length;
+};
+
+FOUNDATION_STATIC_ASSERT(sizeof(resource_import_map_header_t) == 32, "Invalid import map header");
+FOUNDATION_STATIC_ASSERT(sizeof(resource_import_map_slot_t) == 64, "Invalid import map slot");
+
+struct resource_import_map_t {
+	stream_t* stream;
+	//! Path of the map file
+	string_t path;
+	//! Map was opened for writing
+	bool write;
+	//! Lock of the map file, shared by all maps opened on the same path
+	mutex_t* lock;
+	//! Handle of the map file used for the cross process lock, invalid if not locking
+#if FOUNDATION_PLATFORM_WINDOWS
+	HANDLE file;
+#elif FOUNDATION_PLATFORM_POSIX
+	int file;
+#endif
+	resource_import_map_header_t header;
+};
+
+//! Map file locks, selected by hash of the absolute map path
+static mutex_t* _resource_import_map_locks[RESOURCE_IMPORT_MAP_LOCKS];
+
+int
+resource_import_map_initialize(void) {
+	for (size_t ilock = 0; ilock < RESOURCE_IMPORT_MAP_LOCKS; ++ilock)
+		_resource_import_map_locks[ilock] = mutex_allocate(STRING_CONST("resource-import-map"));
+	return 0;
+}
+
+void
+resource_import_map_finalize(void) {
+	for (size_t ilock = 0; ilock < RESOURCE_IMPORT_MAP_LOCKS; ++ilock) {
+		mutex_deallocate(_resource_import_map_locks[ilock]);
+		_resource_import_map_locks[ilock] = nullptr;
+	}
+}
+
+static mutex_t*
+resource_import_map_path_lock(const char* path, size_t length) {
+	// Same file opened through different paths must use the same lock
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t abspath = string_copy(buffer, sizeof(buffer), path, length);
+	abspath = path_absolute(STRING_ARGS(abspath), sizeof(buffer));
+	return _resource_import_map_locks[hash(STRING_ARGS(abspath)) % RESOURCE_IMPORT_MAP_LOCKS];
+}
+
+static void
+resource_import_map_file_open(resource_import_map_t* map) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+	map->file = CreateFileA(map->path.str, GENERIC_READ, share, nullptr, OPEN_EXISTING,
+	                        FILE_ATTRIBUTE_NORMAL, nullptr);
+#elif FOUNDATION_PLATFORM_POSIX
+	map->file = open(map->path.str, O_RDONLY | O_CLOEXEC);
+#else
+	FOUNDATION_UNUSED(map);
+#endif
+}
+
+static void
+resource_import_map_file_close(resource_import_map_t* map) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (map->file != INVALID_HANDLE_VALUE)
+		CloseHandle(map->file);
+	map->file = INVALID_HANDLE_VALUE;
+#elif FOUNDATION_PLATFORM_POSIX
+	if (map->file >= 0)
+		close(map->file);
+	map->file = -1;
+#else
+	FOUNDATION_UNUSED(map);
+#endif
+}
+
+/*! Lock the map file against other processes. Windows locks are mandatory, so the locked
+range is placed far beyond the end of the file where it does not block stream I/O */
+static void
+resource_import_map_file_lock(resource_import_map_t* map, bool exclusive) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (map->file != INVALID_HANDLE_VALUE) {
+		OVERLAPPED overlapped;
+		memset(&overlapped, 0, sizeof(overlapped));
+		overlapped.OffsetHigh = 0x7FFFFFFF;
+		LockFileEx(map->file, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0, 1, 0, &overlapped);
+	}
+#elif FOUNDATION_PLATFORM_POSIX
+	if (map->file >= 0) {
+		while ((flock(map->file, exclusive ? LOCK_EX : LOCK_SH) != 0) && (errno == EINTR)) {
+		}
+	}
+#else
+	FOUNDATION_UNUSED(map);
+	FOUNDATION_UNUSED(exclusive);
+#endif
+}
+
+static void
+resource_import_map_file_unlock(resource_import_map_t* map) {
+#if FOUNDATION_PLATFORM_WINDOWS
+	if (map->file != INVALID_HANDLE_VALUE) {
+		OVERLAPPED overlapped;
+		memset(&overlapped, 0, sizeof(overlapped));
+		overlapped.OffsetHigh = 0x7FFFFFFF;
+		UnlockFileEx(map->file, 0, 1, 0, &overlapped);
+	}
+#elif FOUNDATION_PLATFORM_POSIX
+	if (map->file >= 0)
+		flock(map->file, LOCK_UN);
+#else
+	FOUNDATION_UNUSED(map);
+#endif
+}
+
+/*! Lock map file and reload header, which may have been changed through another map
+opened on the same file or by another process */
+static void
+resource_import_map_lock(resource_import_map_t* map, bool exclusive) {
+	resource_import_map_header_t header;
+	mutex_lock(map->lock);
+	resource_import_map_file_lock(map, exclusive);
+	stream_seek(map->stream, 0, STREAM_SEEK_BEGIN);
+	if ((stream_read(map->stream, &header, sizeof(header)) == sizeof(header)) &&
+	    (header.magic == RESOURCE_IMPORT_MAP_MAGIC))
+		map->header = header;
+}
+
+static void
+resource_import_map_unlock(resource_import_map_t* map) {
+	if (map->write)
+		stream_flush(map->stream);
+	resource_import_map_file_unlock(map);
+	mutex_unlock(map->lock);
+}
+
+static size_t
+resource_import_map_slot_offset(resource_import_map_t* map, size_t islot) {
+	FOUNDATION_UNUSED(map);
+	return sizeof(resource_import_map_header_t) + (sizeof(resource_import_map_slot_t) * islot);
+}
+
+static size_t
+resource_import_map_string_offset(resource_import_map_t* map, uint32_t offset) {
+	return resource_import_map_slot_offset(map, map->header.capacity) + offset;
+}
+
+static bool
+resource_import_map_read_slot(resource_import_map_t* map, size_t islot,
+                              resource_import_map_slot_t* slot) {
+	stream_seek(map->stream, (ssize_t)resource_import_map_slot_offset(map, islot),
+	            STREAM_SEEK_BEGIN);
+	return stream_read(map->stream, slot, sizeof(*slot)) == sizeof(*slot);
+}
+
+static void
+resource_import_map_write_slot(resource_import_map_t* map, size_t islot,
+                               const resource_import_map_slot_t* slot) {
+	stream_seek(map->stream, (ssize_t)resource_import_map_slot_offset(map, islot),
+	            STREAM_SEEK_BEGIN);
+	stream_write(map->stream, slot, sizeof(*slot));
+}
+
+static void
+resource_import_map_write_header(resource_import_map_t* map) {
+	stream_seek(map->stream, 0, STREAM_SEEK_BEGIN);
+	stream_write(map->stream, &map->header, sizeof(map->header));
+}
+
+static bool
+resource_import_map_is_tombstone(const resource_import_map_slot_t* slot) {
+	return !slot->length && (slot->offset == RESOURCE_IMPORT_MAP_TOMBSTONE);
+}
+
+static string_t
+resource_import_map_read_path(resource_import_map_t* map, const resource_import_map_slot_t* slot,
+                              char* buffer, size_t capacity) {
+	size_t length = slot->length;
+	if (length >= capacity)
+		length = capacity - 1;
+	stream_seek(map->stream, (ssize_t)resource_import_map_string_offset(map, slot->offset),
+	            STREAM_SEEK_BEGIN);
+	length = stream_read(map->stream, buffer, length);
+	buffer[length] = 0;
+	return (string_t){buffer, length};
+}
+
+/*! Find slot for path, either the slot holding the path or the slot to insert the path
+in, which is the first tombstone in the probe sequence or the empty slot ending it
+\return true if path was found, false if not */
+static bool
+resource_import_map_find(resource_import_map_t* map, hash_t pathhash, const char* path,
+                         size_t length, size_t* index, resource_import_map_slot_t* slot) {
+	char buffer[BUILD_MAX_PATHLEN];
+	size_t mask = (size_t)map->header.capacity - 1;
+	size_t tombstone = (size_t)-1;
+	for (size_t iprobe = 0; iprobe < map->header.capacity; ++iprobe) {
+		size_t islot = ((size_t)pathhash + iprobe) & mask;
+		if (!resource_import_map_read_slot(map, islot, slot))
+			break;
+		if (resource_import_map_is_tombstone(slot)) {
+			if (tombstone == (size_t)-1)
+				tombstone = islot;
+			continue;
+		}
+		if (!slot->length) {
+			*index = (tombstone != (size_t)-1) ? tombstone : islot;
+			return false;
+		}
+		if ((slot->pathhash != pathhash) || (slot->length != length))
+			continue;
+		string_t slotpath = resource_import_map_read_path(map, slot, buffer, sizeof(buffer));
+		if (string_equal(STRING_ARGS(slotpath), path, length)) {
+			*index = islot;
+			return true;
+		}
+	}
+	*index = tombstone;
+	return false;
+}
+
+/*! Rewrite map with given entries, offset of each entry is into the given strings */
+static void
+resource_import_map_rebuild(resource_import_map_t* map, const resource_import_map_slot_t* entries,
+                            const char* strings) {
+	size_t count = array_size(entries);
+	uint32_t capacity = RESOURCE_IMPORT_MAP_MIN_CAPACITY;
+	while ((size_t)capacity < count * 2)
+		capacity *= 2;
+
+	resource_import_map_slot_t* slots =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_import_map_slot_t) * capacity, 0,
+	                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	uint32_t offset = 0;
+	for (size_t ientry = 0; ientry < count; ++ientry) {
+		size_t islot = (size_t)entries[ientry].pathhash & (capacity - 1);
+		while (slots[islot].length)
+			islot = (islot + 1) & (capacity - 1);
+		slots[islot] = entries[ientry];
+		slots[islot].offset = offset;
+		offset += entries[ientry].length;
+	}
+
+	map->header.magic = RESOURCE_IMPORT_MAP_MAGIC;
+	map->header.version = RESOURCE_IMPORT_MAP_VERSION;
+	map->header.capacity = capacity;
+	map->header.count = (uint32_t)count;
+	map->header.strings = offset;
+	map->header.tombstones = 0;
+	map->header.reserved = 0;
+
+	resource_import_map_write_header(map);
+	stream_write(map->stream, slots, sizeof(resource_import_map_slot_t) * capacity);
+	for (size_t ientry = 0; ientry < count; ++ientry)
+		stream_write(map->stream, strings + entries[ientry].offset, entries[ientry].length);
+	stream_truncate(map->stream, stream_tell(map->stream));
+	memory_deallocate(slots);
+}
+
+static void
+resource_import_map_push_entry(resource_import_map_slot_t** entries, char** strings,
+                               hash_t pathhash, const uuid_t uuid, const uint256_t hash,
+                               const char* path, size_t length) {
+	resource_import_map_slot_t entry;
+	entry.pathhash = pathhash;
+	entry.uuid = uuid;
+	entry.hash = hash;
+	entry.offset = (uint32_t)array_size(*strings);
+	entry.length = (uint32_t)length;
+	array_push(*entries, entry);
+	array_resize(*strings, entry.offset + length);
+	memcpy(*strings + entry.offset, path, length);
+}
+
+static size_t
+resource_import_map_compact_slots(resource_import_map_t* map) {
+	char buffer[BUILD_MAX_PATHLEN];
+	size_t tombstones = map->header.tombstones;
+	if (!map->write)
+		return 0;
+	resource_import_map_slot_t* entries = nullptr;
+	char* strings = nullptr;
+	resource_import_map_slot_t slot;
+	for (size_t islot = 0; islot < map->header.capacity; ++islot) {
+		if (!resource_import_map_read_slot(map, islot, &slot) || !slot.length)
+			continue;
+		string_t path = resource_import_map_read_path(map, &slot, buffer, sizeof(buffer));
+		resource_import_map_push_entry(&entries, &strings, slot.pathhash, slot.uuid, slot.hash,
+		                               STRING_ARGS(path));
+	}
+	resource_import_map_rebuild(map, entries, strings);
+	array_deallocate(entries);
+	array_deallocate(strings);
+	return tombstones;
+}
+
+size_t
+resource_import_map_compact(resource_import_map_t* map) {
+	resource_import_map_lock(map, true);
+	size_t tombstones = resource_import_map_compact_slots(map);
+	resource_import_map_unlock(map);
+	return tombstones;
+}
+
+/*! Convert a text import map of lines "<pathhash> <uuid> <hash> <path>" read from the given
+stream, rebuilding the map in the map stream */
+static void
+resource_import_map_convert(resource_import_map_t* map, stream_t* source) {
+	char buffer[BUILD_MAX_PATHLEN + 128];
+	resource_import_map_slot_t* entries = nullptr;
+	char* strings = nullptr;
+	stream_seek(source, 0, STREAM_SEEK_BEGIN);
+	while (!stream_eos(source)) {
+		string_t line = stream_read_line_buffer(source, buffer, sizeof(buffer), '\n');
+		if (line.length < 120)
+			continue;
+		if (line.str[line.length - 1] == '\r')
+			--line.length;
+		hash_t pathhash = string_to_uint64(line.str, 16, true);
+		uuid_t uuid = string_to_uuid(line.str + 17, 37);
+		uint256_t hash = string_to_uint256(line.str + 54, 64);
+		string_const_t path = string_substr(STRING_ARGS(line), 119, line.length);
+		resource_import_map_push_entry(&entries, &strings, pathhash, uuid, hash,
+		                               STRING_ARGS(path));
+	}
+
+	if (map->write)
+		log_infof(HASH_RESOURCE,
+		          STRING_CONST("Converted import map to indexed format: %.*s (%" PRIsize
+		                       " entries)"),
+		          STRING_FORMAT(map->path), array_size(entries));
+
+	resource_import_map_rebuild(map, entries, strings);
+	array_deallocate(entries);
+	array_deallocate(strings);
+}
+
+resource_import_map_t*
+resource_import_map_open(const char* path, size_t length, bool write) {
+	unsigned int mode = STREAM_IN | STREAM_BINARY | (write ? (STREAM_OUT | STREAM_CREATE) : 0);
+	// Lock is only held while creating or converting, each map operation locks on its own
+	mutex_t* lock = resource_import_map_path_lock(path, length);
+	mutex_lock(lock);
+	stream_t* stream = stream_open(path, length, mode);
+	if (!stream) {
+		mutex_unlock(lock);
+		return nullptr;
+	}
+
+	resource_import_map_t* map =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_import_map_t), 0,
+	                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	map->stream = stream;
+	map->path = string_clone(path, length);
+	map->write = write;
+	map->lock = lock;
+	resource_import_map_file_open(map);
+	resource_import_map_file_lock(map, write);
+
+	size_t size = stream_size(stream);
+	if ((size < sizeof(map->header)) ||
+	    (stream_read(stream, &map->header, sizeof(map->header)) != sizeof(map->header)) ||
+	    (map->header.magic != RESOURCE_IMPORT_MAP_MAGIC)) {
+		memset(&map->header, 0, sizeof(map->header));
+		if (!write) {
+			// Text map opened for reading is converted into a private in memory copy, the
+			// file is left for the next writer to convert
+			map->stream = buffer_stream_allocate(nullptr, STREAM_IN | STREAM_OUT | STREAM_BINARY,
+			                                     0, 0, true, true);
+			resource_import_map_convert(map, stream);
+			stream_deallocate(stream);
+			resource_import_map_file_unlock(map);
+			resource_import_map_file_close(map);
+			mutex_unlock(lock);
+			return map;
+		}
+		if (size)
+			resource_import_map_convert(map, stream);
+		else
+			resource_import_map_rebuild(map, nullptr, nullptr);
+	} else if (map->header.version != RESOURCE_IMPORT_MAP_VERSION) {
+		log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+		          STRING_CONST("Unsupported import map version %u: %.*s"), map->header.version,
+		          (int)length, path);
+		resource_import_map_file_unlock(map);
+		resource_import_map_file_close(map);
+		mutex_unlock(lock);
+		resource_import_map_close(map);
+		return nullptr;
+	}
+
+	resource_import_map_unlock(map);
+	return map;
+}
+
+void
+resource_import_map_close(resource_import_map_t* map) {
+	if (!map)
+		return;
+	resource_import_map_file_close(map);
+	stream_deallocate(map->stream);
+	string_deallocate(map->path.str);
+	memory_deallocate(map);
+}
+
+string_const_t
+resource_import_map_path(resource_import_map_t* map) {
+	return string_to_const(map->path);
+}
+
+resource_signature_t
+resource_import_map_get(resource_import_map_t* map, const char* path, size_t length) {
+	resource_signature_t sig = {uuid_null(), uint256_null()};
+	resource_import_map_slot_t slot;
+	size_t islot;
+	resource_import_map_lock(map, false);
+	if (resource_import_map_find(map, hash(path, length), path, length, &islot, &slot)) {
+		sig.uuid = slot.uuid;
+		sig.hash = slot.hash;
+	}
+	resource_import_map_unlock(map);
+	return sig;
+}
+
+resource_signature_t
+resource_import_map_set(resource_import_map_t* map, const char* path, size_t length,
+                        const uuid_t uuid, const uint256_t sighash) {
+	resource_signature_t sig = {uuid_null(), uint256_null()};
+	resource_import_map_slot_t slot;
+	size_t islot;
+	hash_t pathhash = hash(path, length);
+	if (!map->write || !length)
+		return sig;
+
+	resource_import_map_lock(map, true);
+	if (resource_import_map_find(map, pathhash, path, length, &islot, &slot)) {
+		// Existing entries keep their UUID, only the signature hash is updated in place
+		if (!uint256_is_null(sighash) && !uint256_equal(slot.hash, sighash)) {
+			slot.hash = sighash;
+			resource_import_map_write_slot(map, islot, &slot);
+		}
+		resource_import_map_unlock(map);
+		sig.uuid = slot.uuid;
+		sig.hash = slot.hash;
+		return sig;
+	}
+
+	// Reusing a tombstone does not increase the load of the table
+	bool reuse = (islot != (size_t)-1) && resource_import_map_read_slot(map, islot, &slot) &&
+	             resource_import_map_is_tombstone(&slot);
+	if (!reuse && (((size_t)map->header.count + map->header.tombstones + 1) * 4 >
+	               (size_t)map->header.capacity * 3)) {
+		resource_import_map_compact_slots(map);
+		resource_import_map_find(map, pathhash, path, length, &islot, &slot);
+	}
+
+	slot.pathhash = pathhash;
+	slot.uuid = uuid;
+	slot.hash = sighash;
+	slot.offset = (uint32_t)map->header.strings;
+	slot.length = (uint32_t)length;
+
+	stream_seek(map->stream,
+	            (ssize_t)resource_import_map_string_offset(map, (uint32_t)map->header.strings),
+	            STREAM_SEEK_BEGIN);
+	stream_write(map->stream, path, length);
+	resource_import_map_write_slot(map, islot, &slot);
+
+	map->header.strings += length;
+	++map->header.count;
+	if (reuse)
+		--map->header.tombstones;
+	resource_import_map_write_header(map);
+	resource_import_map_unlock(map);
+
+	sig.uuid = uuid;
+	sig.hash = sighash;
+	return sig;
+}
+
+resource_signature_t
+resource_import_map_remove(resource_import_map_t* map, const char* path, size_t length) {
+	resource_signature_t sig = {uuid_null(), uint256_null()};
+	resource_import_map_slot_t slot;
+	size_t islot;
+	if (!map->write || !length)
+		return sig;
+
+	resource_import_map_lock(map, true);
+	if (!resource_import_map_find(map, hash(path, length), path, length, &islot, &slot)) {
+		resource_import_map_unlock(map);
+		return sig;
+	}
+	sig.uuid = slot.uuid;
+	sig.hash = slot.hash;
+
+	// Path string is left unreferenced in string area until next compaction
+	memset(&slot, 0, sizeof(slot));
+	slot.offset = RESOURCE_IMPORT_MAP_TOMBSTONE;
+	resource_import_map_write_slot(map, islot, &slot);
+
+	--map->header.count;
+	++map->header.tombstones;
+	resource_import_map_write_header(map);
+
+	if ((size_t)map->header.tombstones * 4 > (size_t)map->header.capacity)
+		resource_import_map_compact_slots(map);
+	resource_import_map_unlock(map);
+
+	return sig;
+}
+
+size_t
+resource_import_map_capacity(resource_import_map_t* map) {
+	resource_import_map_lock(map, false);
+	size_t capacity = map->header.capacity;
+	resource_import_map_unlock(map);
+	return capacity;
+}
+
+size_t
+resource_import_map_tombstones(resource_import_map_t* map) {
+	resource_import_map_lock(map, false);
+	size_t tombstones = map->header.tombstones;
+	resource_import_map_unlock(map);
+	return tombstones;
+}
+
+string_t
+resource_import_map_entry(resource_import_map_t* map, size_t index, resource_signature_t* sig,
+                          char* buffer, size_t capacity) {
+	resource_import_map_slot_t slot;
+	string_t path = {buffer, 0};
+	resource_import_map_lock(map, false);
+	if ((index < map->header.capacity) && resource_import_map_read_slot(map, index, &slot) &&
+	    slot.length) {
+		if (sig) {
+			sig->uuid = slot.uuid;
+			sig->hash = slot.hash;
+		}
+		path = resource_import_map_read_path(map, &slot, buffer, capacity);
+	}
+	resource_import_map_unlock(map);
+	return path;
+}
+
+#else
+
+int
+resource_import_map_initialize(void) {
+	return 0;
+}
+
+void
+resource_import_map_finalize(void) {
+}
+
+#endif
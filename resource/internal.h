@@ -33,6 +33,72 @@ resource_import_initialize(void);
 RESOURCE_API void
 resource_import_finalize(void);
 
+typedef struct resource_import_map_t resource_import_map_t;
+
+RESOURCE_API int
+resource_import_map_initialize(void);
+
+RESOURCE_API void
+resource_import_map_finalize(void);
+
+RESOURCE_API resource_import_map_t*
+resource_import_map_open(const char* path, size_t length, bool write);
+
+RESOURCE_API void
+resource_import_map_close(resource_import_map_t* map);
+
+RESOURCE_API string_const_t
+resource_import_map_path(resource_import_map_t* map);
+
+RESOURCE_API resource_signature_t
+resource_import_map_get(resource_import_map_t* map, const char* path, size_t length);
+
+RESOURCE_API resource_signature_t
+resource_import_map_set(resource_import_map_t* map, const char* path, size_t length,
+                        const uuid_t uuid, const uint256_t sighash);
+
+RESOURCE_API resource_signature_t
+resource_import_map_remove(resource_import_map_t* map, const char* path, size_t length);
+
+RESOURCE_API size_t
+resource_import_map_compact(resource_import_map_t* map);
+
+RESOURCE_API size_t
+resource_import_map_capacity(resource_import_map_t* map);
+
+RESOURCE_API size_t
+resource_import_map_tombstones(resource_import_map_t* map);
+
+RESOURCE_API string_t
+resource_import_map_entry(resource_import_map_t* map, size_t index, resource_signature_t* sig,
+                          char* buffer, size_t capacity);
+
+typedef struct resource_file_stat_t resource_file_stat_t;
+
+struct resource_file_stat_t {
+	uint64_t size;
+	uint64_t modified;
+	uint64_t inode;
+	uint64_t sampled;
+};
+
+RESOURCE_API int
+resource_hashcache_initialize(void);
+
+RESOURCE_API void
+resource_hashcache_finalize(void);
+
+RESOURCE_API bool
+resource_hashcache_stat(const char* path, size_t length, resource_file_stat_t* stat);
+
+RESOURCE_API bool
+resource_hashcache_lookup(const char* path, size_t length, const resource_file_stat_t* stat,
+                          uint256_t* hash);
+
+RESOURCE_API void
+resource_hashcache_store(const char* path, size_t length, const resource_file_stat_t* stat,
+                         const uint256_t hash);
+
 RESOURCE_API int
 resource_autoimport_initialize(void);
 
@@ -45,8 +111,137 @@ resource_compile_initialize(void);
 RESOURCE_API void
 resource_compile_finalize(void);
 
+RESOURCE_API bool
+resource_compile_need_update_node(const uuid_t uuid, uint64_t platform);
+
+RESOURCE_API bool
+resource_compile_node(const uuid_t uuid, uint64_t platform);
+
+RESOURCE_API void
+resource_compile_record_dependency(const uuid_t uuid, uint64_t platform);
+
+typedef struct resource_compile_recorder_t resource_compile_recorder_t;
+
+RESOURCE_API resource_compile_recorder_t*
+resource_compile_record_suspend(void);
+
+RESOURCE_API void
+resource_compile_record_resume(resource_compile_recorder_t* recorder);
+
+RESOURCE_API int
+resource_compile_queue_initialize(void);
+
+RESOURCE_API void
+resource_compile_queue_finalize(void);
+
+RESOURCE_API int
+resource_failure_initialize(void);
+
+RESOURCE_API void
+resource_failure_finalize(void);
+
+RESOURCE_API bool
+resource_failure_recorded(resource_failure_type type, hash_t key);
+
+RESOURCE_API bool
+resource_failure_check(resource_failure_type type, hash_t key, hash_t fingerprint);
+
+RESOURCE_API void
+resource_failure_record(resource_failure_type type, hash_t key, hash_t fingerprint,
+                        const char* diagnostics, size_t length);
+
+RESOURCE_API void
+resource_failure_forget(resource_failure_type type, hash_t key);
+
+RESOURCE_API int
+resource_metrics_initialize(void);
+
+RESOURCE_API void
+resource_metrics_finalize(void);
+
+RESOURCE_API void
+resource_metrics_time(const char* type, size_t length, uint64_t platform,
+                      resource_metric_phase phase, tick_t ticks);
+
+RESOURCE_API void
+resource_metrics_count(const char* type, size_t length, uint64_t platform,
+                       resource_metric_counter counter);
+
+RESOURCE_API int
+resource_speculate_initialize(void);
+
+RESOURCE_API void
+resource_speculate_finalize(void);
+
+RESOURCE_API string_t
+resource_local_find_path(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform,
+                         const char* suffix, size_t suffix_length);
+
+RESOURCE_API string_t
+resource_local_make_path(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform,
+                         const char* suffix, size_t suffix_length);
+
+RESOURCE_API int
+resource_tool_initialize(void);
+
+RESOURCE_API void
+resource_tool_finalize(void);
+
+RESOURCE_API hash_t
+resource_tool_extension_hash(const char* extension, size_t length);
+
+RESOURCE_API int
+resource_tool_match_format(const hash_t* extensions, const resource_import_magic_t* magic,
+                           hash_t extension, const void* header, size_t size);
+
+RESOURCE_API int
+resource_worker_initialize(void);
+
+RESOURCE_API void
+resource_worker_finalize(void);
+
+typedef struct resource_tool_watch_t resource_tool_watch_t;
+
+RESOURCE_API void
+resource_tool_watch_begin(resource_tool_watch_t* watch);
+
+RESOURCE_API bool
+resource_tool_watch_attach(resource_tool_watch_t* watch, process_t* process);
+
+RESOURCE_API void
+resource_tool_watch_detach(resource_tool_watch_t* watch);
+
+RESOURCE_API void
+resource_tool_watch_end(resource_tool_watch_t* watch);
+
+RESOURCE_API int
+resource_tool_watch_result(resource_tool_watch_t* watch);
+
+RESOURCE_API bool
+resource_worker_execute(const string_t tool, resource_tool_watch_t* watch,
+                        const string_const_t* args, size_t num_args,
+                        const string_const_t* common, size_t num_common, int* exit_code);
+
+RESOURCE_API int
+resource_cache_initialize(void);
+
+RESOURCE_API void
+resource_cache_finalize(void);
+
+RESOURCE_API int
+resource_async_initialize(void);
+
+RESOURCE_API void
+resource_async_finalize(void);
+
 RESOURCE_API int
 resource_remote_initialize(void);
 
 RESOURCE_API void
 resource_remote_finalize(void);
+
+static FOUNDATION_FORCEINLINE hash_t
+resource_dependency_hash(const uuid_t uuid, uint64_t platform) {
+	const resource_dependency_t dependency = {uuid, platform};
+	return hash(&dependency, sizeof(dependency));
+}
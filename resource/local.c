@@ -112,7 +112,16 @@ retry:
 				string_const_t path = path_directory_name(STRING_ARGS(platformpath));
 				fs_make_directory(STRING_ARGS(path));
 			}
-			stream = stream_open(STRING_ARGS(platformpath), mode);
+			if ((mode & STREAM_TRUNCATE) && !(mode & STREAM_CREATE) &&
+			        fs_is_file(STRING_ARGS(platformpath))) {
+				//Replace instead of rewriting in place, file might be a hard
+				//link shared with the compile cache
+				fs_remove_file(STRING_ARGS(platformpath));
+				stream = stream_open(STRING_ARGS(platformpath), mode | STREAM_CREATE);
+			}
+			else {
+				stream = stream_open(STRING_ARGS(platformpath), mode);
+			}
 		}
 		if (!stream && try_create) {
 			if (tried_create)
@@ -129,6 +138,40 @@ retry:
 	return stream;
 }
 
+string_t
+resource_local_find_path(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform,
+                         const char* suffix, size_t suffix_length) {
+	size_t ipath, pathsize;
+	uint64_t full_platform = platform;
+
+	if (!resource_module_config().enable_local_cache)
+		return string(buffer, 0);
+
+	while (true) {
+		for (ipath = 0, pathsize = array_size(_resource_local_paths); ipath < pathsize; ++ipath) {
+			string_t platformpath = resource_local_make_platform_path(
+			                            buffer, capacity, ipath,
+			                            uuid, platform, suffix, suffix_length);
+			if (fs_is_file(STRING_ARGS(platformpath)))
+				return platformpath;
+		}
+		if (!platform)
+			break;
+		platform = resource_platform_reduce(platform, full_platform);
+	}
+
+	return string(buffer, 0);
+}
+
+string_t
+resource_local_make_path(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform,
+                         const char* suffix, size_t suffix_length) {
+	if (!resource_module_config().enable_local_cache || !array_size(_resource_local_paths))
+		return string(buffer, 0);
+	return resource_local_make_platform_path(buffer, capacity, 0, uuid, platform,
+	                                         suffix, suffix_length);
+}
+
 stream_t*
 resource_local_open_static(const uuid_t uuid, uint64_t platform) {
 	return resource_local_open_stream(uuid, platform, 0, 0, STREAM_IN | STREAM_BINARY);
@@ -168,6 +211,28 @@ void
 resource_local_clear_paths(void) {
 }
 
+string_t
+resource_local_find_path(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform,
+                         const char* suffix, size_t suffix_length) {
+	FOUNDATION_UNUSED(capacity);
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(suffix);
+	FOUNDATION_UNUSED(suffix_length);
+	return string(buffer, 0);
+}
+
+string_t
+resource_local_make_path(char* buffer, size_t capacity, const uuid_t uuid, uint64_t platform,
+                         const char* suffix, size_t suffix_length) {
+	FOUNDATION_UNUSED(capacity);
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(suffix);
+	FOUNDATION_UNUSED(suffix_length);
+	return string(buffer, 0);
+}
+
 stream_t*
 resource_local_open_static(const uuid_t uuid, uint64_t platform) {
 	FOUNDATION_UNUSED(uuid);
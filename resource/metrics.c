@@ -0,0 +1,273 @@
+/* metrics.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+typedef struct resource_metrics_record_t resource_metrics_record_t;
+
+struct resource_metrics_record_t {
+	string_t type;
+	uint64_t platform;
+	resource_metric_histogram_t phase[RESOURCEMETRIC_PHASE_COUNT];
+	uint64_t counter[RESOURCEMETRIC_COUNTER_COUNT];
+	//! Next record with colliding key
+	resource_metrics_record_t* next;
+};
+
+static mutex_t* _resource_metrics_lock;
+static hashmap_t* _resource_metrics_map;
+static resource_metrics_record_t** _resource_metrics_records;
+static atomic32_t _resource_metrics_enabled;
+static string_t _resource_metrics_dump_path;
+
+static const char* _resource_metrics_phase_name[RESOURCEMETRIC_PHASE_COUNT] = {
+    "need_update", "cache", "source_read", "collapse", "internal", "external"};
+
+static const char* _resource_metrics_counter_name[RESOURCEMETRIC_COUNTER_COUNT] = {
+    "cache_hit", "cache_miss", "compiled", "failed", "failure_skipped", "up_to_date",
+    "out_of_date"};
+
+int
+resource_metrics_initialize(void) {
+	_resource_metrics_lock = mutex_allocate(STRING_CONST("resource-metrics"));
+	_resource_metrics_map = hashmap_allocate(67, 8);
+	atomic_store32(&_resource_metrics_enabled, resource_module_config().enable_metrics ? 1 : 0,
+	               memory_order_release);
+	return 0;
+}
+
+void
+resource_metrics_finalize(void) {
+	if (_resource_metrics_dump_path.length)
+		resource_metrics_write();
+	string_deallocate(_resource_metrics_dump_path.str);
+	_resource_metrics_dump_path = string(0, 0);
+
+	resource_metrics_reset();
+	array_deallocate(_resource_metrics_records);
+	hashmap_deallocate(_resource_metrics_map);
+	mutex_deallocate(_resource_metrics_lock);
+	_resource_metrics_records = nullptr;
+	_resource_metrics_map = nullptr;
+	_resource_metrics_lock = nullptr;
+}
+
+void
+resource_metrics_enable(bool enable) {
+	atomic_store32(&_resource_metrics_enabled, enable ? 1 : 0, memory_order_release);
+}
+
+bool
+resource_metrics_is_enabled(void) {
+	return atomic_load32(&_resource_metrics_enabled, memory_order_relaxed) != 0;
+}
+
+void
+resource_metrics_set_dump_path(const char* path, size_t length) {
+	string_deallocate(_resource_metrics_dump_path.str);
+	_resource_metrics_dump_path = length ? string_clone(path, length) : string(0, 0);
+	if (length)
+		resource_metrics_enable(true);
+}
+
+bool
+resource_metrics_write(void) {
+	if (!_resource_metrics_dump_path.length)
+		return false;
+	stream_t* stream = stream_open(STRING_ARGS(_resource_metrics_dump_path),
+	                               STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
+	if (!stream) {
+		log_warnf(HASH_RESOURCE, WARNING_RESOURCE, STRING_CONST("Unable to write metrics: %.*s"),
+		          STRING_FORMAT(_resource_metrics_dump_path));
+		return false;
+	}
+	resource_metrics_dump(stream);
+	stream_deallocate(stream);
+	return true;
+}
+
+void
+resource_metrics_reset(void) {
+	mutex_lock(_resource_metrics_lock);
+	for (size_t irec = 0, rsize = array_size(_resource_metrics_records); irec < rsize; ++irec) {
+		string_deallocate(_resource_metrics_records[irec]->type.str);
+		memory_deallocate(_resource_metrics_records[irec]);
+	}
+	array_clear(_resource_metrics_records);
+	hashmap_clear(_resource_metrics_map);
+	mutex_unlock(_resource_metrics_lock);
+}
+
+static hash_t
+resource_metrics_key(const char* type, size_t length, uint64_t platform) {
+	return hash(type, length) ^ hash(&platform, sizeof(platform));
+}
+
+static resource_metrics_record_t*
+resource_metrics_lookup(const char* type, size_t length, uint64_t platform, bool create) {
+	hash_t key = resource_metrics_key(type, length, platform);
+	resource_metrics_record_t* head = hashmap_lookup(_resource_metrics_map, key);
+	for (resource_metrics_record_t* record = head; record; record = record->next) {
+		if ((record->platform == platform) && string_equal(STRING_ARGS(record->type), type, length))
+			return record;
+	}
+	if (!create)
+		return nullptr;
+	// Colliding keys are chained from the record in the map
+	resource_metrics_record_t* record = memory_allocate(
+	    HASH_RESOURCE, sizeof(resource_metrics_record_t), 0,
+	    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	record->type = string_clone(type, length);
+	record->platform = platform;
+	record->next = head;
+	hashmap_insert(_resource_metrics_map, key, record);
+	array_push(_resource_metrics_records, record);
+	return record;
+}
+
+void
+resource_metrics_time(const char* type, size_t length, uint64_t platform,
+                      resource_metric_phase phase, tick_t ticks) {
+	deltatime_t seconds = time_ticks_to_seconds(ticks);
+	tick_t micros = (ticks * 1000000) / time_ticks_per_second();
+	unsigned int bucket = 0;
+	while ((bucket < (RESOURCE_METRIC_BUCKETS - 1)) && (micros >= ((tick_t)1 << bucket)))
+		++bucket;
+
+	mutex_lock(_resource_metrics_lock);
+	resource_metrics_record_t* record = resource_metrics_lookup(type, length, platform, true);
+	if (record) {
+		resource_metric_histogram_t* histogram = record->phase + phase;
+		if (!histogram->count || (seconds < histogram->min))
+			histogram->min = seconds;
+		if (seconds > histogram->max)
+			histogram->max = seconds;
+		histogram->total += seconds;
+		++histogram->count;
+		++histogram->buckets[bucket];
+	}
+	mutex_unlock(_resource_metrics_lock);
+}
+
+void
+resource_metrics_count(const char* type, size_t length, uint64_t platform,
+                       resource_metric_counter counter) {
+	mutex_lock(_resource_metrics_lock);
+	resource_metrics_record_t* record = resource_metrics_lookup(type, length, platform, true);
+	if (record)
+		++record->counter[counter];
+	mutex_unlock(_resource_metrics_lock);
+}
+
+resource_metric_histogram_t
+resource_metrics_histogram(const char* type, size_t length, uint64_t platform,
+                           resource_metric_phase phase) {
+	resource_metric_histogram_t histogram;
+	memset(&histogram, 0, sizeof(histogram));
+	mutex_lock(_resource_metrics_lock);
+	resource_metrics_record_t* record = resource_metrics_lookup(type, length, platform, false);
+	if (record)
+		histogram = record->phase[phase];
+	mutex_unlock(_resource_metrics_lock);
+	return histogram;
+}
+
+uint64_t
+resource_metrics_counter(const char* type, size_t length, uint64_t platform,
+                         resource_metric_counter counter) {
+	uint64_t value = 0;
+	mutex_lock(_resource_metrics_lock);
+	resource_metrics_record_t* record = resource_metrics_lookup(type, length, platform, false);
+	if (record)
+		value = record->counter[counter];
+	mutex_unlock(_resource_metrics_lock);
+	return value;
+}
+
+static void
+resource_metrics_write_escaped(stream_t* stream, const char* str, size_t length) {
+	size_t last = 0;
+	for (size_t ichar = 0; ichar < length; ++ichar) {
+		unsigned char c = (unsigned char)str[ichar];
+		if ((c >= 0x20) && (c != '"') && (c != '\\'))
+			continue;
+		if (ichar > last)
+			stream_write(stream, str + last, ichar - last);
+		if ((c == '"') || (c == '\\'))
+			stream_write_format(stream, STRING_CONST("\\%c"), (char)c);
+		else
+			stream_write_format(stream, STRING_CONST("\\u%04x"), (unsigned int)c);
+		last = ichar + 1;
+	}
+	if (length > last)
+		stream_write(stream, str + last, length - last);
+}
+
+void
+resource_metrics_dump(stream_t* stream) {
+	mutex_lock(_resource_metrics_lock);
+	stream_write_string(stream, STRING_CONST("{\n\t\"bucket_limits_us\": ["));
+	for (unsigned int bucket = 0; bucket < RESOURCE_METRIC_BUCKETS - 1; ++bucket)
+		stream_write_format(stream, STRING_CONST("%s%" PRIu64), bucket ? ", " : "",
+		                    (uint64_t)1 << bucket);
+	stream_write_string(stream, STRING_CONST("],\n\t\"metrics\": ["));
+	for (size_t irec = 0, rsize = array_size(_resource_metrics_records); irec < rsize; ++irec) {
+		const resource_metrics_record_t* record = _resource_metrics_records[irec];
+		// Type is arbitrary text from resource sources
+		stream_write_format(stream, STRING_CONST("%s\n\t\t{\n\t\t\t\"type\": \""),
+		                    irec ? "," : "");
+		resource_metrics_write_escaped(stream, STRING_ARGS(record->type));
+		stream_write_format(stream,
+		                    STRING_CONST("\",\n\t\t\t\"platform\": \"%" PRIx64 "\",\n"
+		                                 "\t\t\t\"counters\": {"),
+		                    record->platform);
+		for (int icounter = 0; icounter < RESOURCEMETRIC_COUNTER_COUNT; ++icounter)
+			stream_write_format(stream, STRING_CONST("%s\"%s\": %" PRIu64), icounter ? ", " : "",
+			                    _resource_metrics_counter_name[icounter],
+			                    record->counter[icounter]);
+		stream_write_string(stream, STRING_CONST("},\n\t\t\t\"phases\": {"));
+		bool first = true;
+		for (int iphase = 0; iphase < RESOURCEMETRIC_PHASE_COUNT; ++iphase) {
+			const resource_metric_histogram_t* histogram = record->phase + iphase;
+			if (!histogram->count)
+				continue;
+			stream_write_format(stream,
+			                    STRING_CONST("%s\n\t\t\t\t\"%s\": {\"count\": %" PRIu64
+			                                 ", \"total\": %.6f, \"min\": %.6f, \"max\": %.6f, "
+			                                 "\"buckets\": ["),
+			                    first ? "" : ",", _resource_metrics_phase_name[iphase],
+			                    histogram->count, (double)histogram->total,
+			                    (double)histogram->min, (double)histogram->max);
+			for (unsigned int bucket = 0; bucket < RESOURCE_METRIC_BUCKETS; ++bucket)
+				stream_write_format(stream, STRING_CONST("%s%" PRIu64), bucket ? ", " : "",
+				                    histogram->buckets[bucket]);
+			stream_write_string(stream, STRING_CONST("]}"));
+			first = false;
+		}
+		if (first)
+			stream_write_string(stream, STRING_CONST("}\n\t\t}"));
+		else
+			stream_write_string(stream, STRING_CONST("\n\t\t\t}\n\t\t}"));
+	}
+	stream_write_string(stream, STRING_CONST("\n\t]\n}\n"));
+	mutex_unlock(_resource_metrics_lock);
+}
@@ -0,0 +1,78 @@
+/* metrics.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Enable or disable collection of compile pipeline metrics. Metrics are timings of
+compile pipeline phases and counters of compile outcomes, kept per resource type and
+platform. Phases where the resource type is not known, like need update checks, are
+kept with an empty type. While disabled, instrumentation costs a single flag check.
+\param enable Enable flag */
+RESOURCE_API void
+resource_metrics_enable(bool enable);
+
+/*! Check if collection of compile pipeline metrics is enabled
+\return true if enabled, false if not */
+RESOURCE_API bool
+resource_metrics_is_enabled(void);
+
+/*! Discard all collected metrics */
+RESOURCE_API void
+resource_metrics_reset(void);
+
+/*! Get timing histogram of a compile pipeline phase
+\param type Resource type
+\param length Length of resource type
+\param platform Resource platform
+\param phase Phase
+\return Histogram, zero if no samples */
+RESOURCE_API resource_metric_histogram_t
+resource_metrics_histogram(const char* type, size_t length, uint64_t platform,
+                           resource_metric_phase phase);
+
+/*! Get value of a compile outcome counter
+\param type Resource type
+\param length Length of resource type
+\param platform Resource platform
+\param counter Counter
+\return Counter value */
+RESOURCE_API uint64_t
+resource_metrics_counter(const char* type, size_t length, uint64_t platform,
+                         resource_metric_counter counter);
+
+/*! Write all collected metrics as JSON
+\param stream Output stream */
+RESOURCE_API void
+resource_metrics_dump(stream_t* stream);
+
+/*! Set path of file to write metrics JSON to when the resource module is finalized,
+also enables metrics collection. Set with --resource-metrics <path> on the command line.
+\param path Output file path, empty to disable
+\param length Length of path */
+RESOURCE_API void
+resource_metrics_set_dump_path(const char* path, size_t length);
+
+/*! Write all collected metrics as JSON to the dump path now, without waiting for the
+resource module to be finalized. Used by daemons to dump metrics on request.
+\return true if written, false if no dump path is set or the file could not be opened */
+RESOURCE_API bool
+resource_metrics_write(void);
@@ -0,0 +1,588 @@
+/* queue.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+typedef struct resource_compile_queue_entry_t resource_compile_queue_entry_t;
+typedef struct resource_compile_queue_waiter_t resource_compile_queue_waiter_t;
+typedef struct resource_compile_queue_node_t resource_compile_queue_node_t;
+
+struct resource_compile_queue_waiter_t {
+	semaphore_t signal;
+	bool success;
+};
+
+struct resource_compile_queue_entry_t {
+	uuid_t uuid;
+	uint64_t platform;
+	hash_t key;
+	int priority;
+	uint64_t sequence;
+	//! Index in queue heap, or -1 if not ready or running
+	size_t queue_index;
+	//! Index in list of all entries
+	size_t entry_index;
+	//! Number of dependencies not yet processed
+	size_t pending;
+	//! Currently walking dependencies of this entry, used to break cycles
+	bool visiting;
+	bool running;
+	//! Pushed again while running, process once more when done
+	bool again;
+	//! A dependency failed to compile
+	bool failed;
+	//! Time entry last became ready with all dependencies processed
+	tick_t ready;
+	hash_t* dependencies;
+	resource_compile_queue_entry_t** dependents;
+	resource_compile_queue_waiter_t** waiters;
+};
+
+//! Resource in dependency graph read from source before taking the queue lock
+struct resource_compile_queue_node_t {
+	uuid_t uuid;
+	resource_dependency_t* dependencies;
+	size_t num_dependencies;
+};
+
+static mutex_t* _resource_compile_queue_lock;
+static hashmap_t* _resource_compile_queue_map;
+static resource_compile_queue_entry_t** _resource_compile_queue_entries;
+static resource_compile_queue_entry_t** _resource_compile_queue;
+static uint64_t _resource_compile_queue_sequence;
+static semaphore_t _resource_compile_queue_work;
+static thread_t* _resource_compile_queue_threads;
+static atomic32_t _resource_compile_queue_terminate;
+static semaphore_t** _resource_compile_queue_flush_waiters;
+static size_t _resource_compile_queue_depth;
+static size_t _resource_compile_queue_running;
+static resource_compile_queue_statistics_t _resource_compile_queue_stats;
+static tick_t _resource_compile_queue_wait_total;
+
+FOUNDATION_DECLARE_THREAD_LOCAL(int, resource_compile_queue_worker, 0)
+
+int
+resource_compile_queue_initialize(void) {
+	_resource_compile_queue_lock = mutex_allocate(STRING_CONST("resource-compile-queue"));
+	_resource_compile_queue_map = hashmap_allocate(4099, 8);
+	semaphore_initialize(&_resource_compile_queue_work, 0);
+	atomic_store32(&_resource_compile_queue_terminate, 0, memory_order_release);
+	memset(&_resource_compile_queue_stats, 0, sizeof(_resource_compile_queue_stats));
+	_resource_compile_queue_wait_total = 0;
+	return 0;
+}
+
+static void
+resource_compile_queue_entry_deallocate(resource_compile_queue_entry_t* entry) {
+	for (size_t iwait = 0, wsize = array_size(entry->waiters); iwait < wsize; ++iwait) {
+		entry->waiters[iwait]->success = false;
+		semaphore_post(&entry->waiters[iwait]->signal);
+	}
+	array_deallocate(entry->waiters);
+	array_deallocate(entry->dependents);
+	array_deallocate(entry->dependencies);
+	memory_deallocate(entry);
+}
+
+void
+resource_compile_queue_finalize(void) {
+	size_t ithread, tsize;
+	atomic_store32(&_resource_compile_queue_terminate, 1, memory_order_release);
+	for (ithread = 0, tsize = array_size(_resource_compile_queue_threads); ithread < tsize;
+	     ++ithread)
+		semaphore_post(&_resource_compile_queue_work);
+	for (ithread = 0, tsize = array_size(_resource_compile_queue_threads); ithread < tsize;
+	     ++ithread) {
+		thread_join(_resource_compile_queue_threads + ithread);
+		thread_finalize(_resource_compile_queue_threads + ithread);
+	}
+	array_deallocate(_resource_compile_queue_threads);
+
+	// Entries not yet processed are released, failing any waiters
+	for (size_t ientry = 0, esize = array_size(_resource_compile_queue_entries); ientry < esize;
+	     ++ientry)
+		resource_compile_queue_entry_deallocate(_resource_compile_queue_entries[ientry]);
+	array_deallocate(_resource_compile_queue_entries);
+
+	for (size_t iwait = 0, wsize = array_size(_resource_compile_queue_flush_waiters);
+	     iwait < wsize; ++iwait)
+		semaphore_post(_resource_compile_queue_flush_waiters[iwait]);
+	array_deallocate(_resource_compile_queue_flush_waiters);
+	array_deallocate(_resource_compile_queue);
+
+	hashmap_deallocate(_resource_compile_queue_map);
+	semaphore_finalize(&_resource_compile_queue_work);
+	mutex_deallocate(_resource_compile_queue_lock);
+
+	_resource_compile_queue_threads = nullptr;
+	_resource_compile_queue_flush_waiters = nullptr;
+	_resource_compile_queue = nullptr;
+	_resource_compile_queue_map = nullptr;
+	_resource_compile_queue_entries = nullptr;
+	_resource_compile_queue_lock = nullptr;
+	_resource_compile_queue_depth = 0;
+	_resource_compile_queue_running = 0;
+}
+
+bool
+resource_compile_queue_is_active(void) {
+	return _resource_compile_queue_lock && resource_module_config().compile_queue_thread_count &&
+	       !get_thread_resource_compile_queue_worker();
+}
+
+#if (RESOURCE_ENABLE_LOCAL_SOURCE || RESOURCE_ENABLE_REMOTE_SOURCED) && RESOURCE_ENABLE_LOCAL_CACHE
+
+static bool
+resource_compile_queue_before(const resource_compile_queue_entry_t* lhs,
+                              const resource_compile_queue_entry_t* rhs) {
+	if (lhs->priority != rhs->priority)
+		return lhs->priority > rhs->priority;
+	return lhs->sequence < rhs->sequence;
+}
+
+static void
+resource_compile_queue_swap(size_t first, size_t second) {
+	resource_compile_queue_entry_t* entry = _resource_compile_queue[first];
+	_resource_compile_queue[first] = _resource_compile_queue[second];
+	_resource_compile_queue[second] = entry;
+	_resource_compile_queue[first]->queue_index = first;
+	_resource_compile_queue[second]->queue_index = second;
+}
+
+static void
+resource_compile_queue_up(size_t index) {
+	while (index) {
+		size_t parent = (index - 1) / 2;
+		if (!resource_compile_queue_before(_resource_compile_queue[index],
+		                                   _resource_compile_queue[parent]))
+			break;
+		resource_compile_queue_swap(index, parent);
+		index = parent;
+	}
+}
+
+static void
+resource_compile_queue_down(size_t index) {
+	size_t size = array_size(_resource_compile_queue);
+	while (true) {
+		size_t first = index;
+		size_t left = (index * 2) + 1;
+		size_t right = left + 1;
+		if ((left < size) && resource_compile_queue_before(_resource_compile_queue[left],
+		                                                   _resource_compile_queue[first]))
+			first = left;
+		if ((right < size) && resource_compile_queue_before(_resource_compile_queue[right],
+		                                                    _resource_compile_queue[first]))
+			first = right;
+		if (first == index)
+			break;
+		resource_compile_queue_swap(index, first);
+		index = first;
+	}
+}
+
+static resource_compile_queue_entry_t*
+resource_compile_queue_pop(void) {
+	resource_compile_queue_entry_t* entry = _resource_compile_queue[0];
+	size_t last = array_size(_resource_compile_queue) - 1;
+	if (last) {
+		_resource_compile_queue[0] = _resource_compile_queue[last];
+		_resource_compile_queue[0]->queue_index = 0;
+		array_pop(_resource_compile_queue);
+		resource_compile_queue_down(0);
+	} else {
+		array_pop(_resource_compile_queue);
+	}
+	entry->queue_index = (size_t)-1;
+	return entry;
+}
+
+static void
+resource_compile_queue_ready(resource_compile_queue_entry_t* entry) {
+	entry->sequence = _resource_compile_queue_sequence++;
+	entry->ready = time_current();
+	entry->queue_index = array_size(_resource_compile_queue);
+	array_push(_resource_compile_queue, entry);
+	resource_compile_queue_up(entry->queue_index);
+	semaphore_post(&_resource_compile_queue_work);
+}
+
+static void
+resource_compile_queue_raise_entry(resource_compile_queue_entry_t* entry, int priority) {
+	if (priority <= entry->priority)
+		return;
+	entry->priority = priority;
+	if (entry->queue_index != (size_t)-1)
+		resource_compile_queue_up(entry->queue_index);
+	// Dependencies of a blocked entry inherit the raised priority
+	for (size_t idep = 0, dsize = array_size(entry->dependencies); idep < dsize; ++idep) {
+		resource_compile_queue_entry_t* dependency =
+		    hashmap_lookup(_resource_compile_queue_map, entry->dependencies[idep]);
+		if (dependency)
+			resource_compile_queue_raise_entry(dependency, priority);
+	}
+}
+
+/*! Read dependency graph of a resource from source, keeping the disk I/O out of the queue
+lock. Nodes are keyed by dependency hash, a colliding resource is left out and read again
+when inserted */
+static void
+resource_compile_queue_collect(const uuid_t uuid, uint64_t platform, hashmap_t* graph,
+                               resource_compile_queue_node_t*** nodes) {
+	hash_t key = resource_dependency_hash(uuid, platform);
+	if (hashmap_lookup(graph, key))
+		return;
+
+	resource_compile_queue_node_t* node =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_compile_queue_node_t), 0,
+	                    MEMORY_TEMPORARY | MEMORY_ZERO_INITIALIZED);
+	node->uuid = uuid;
+	hashmap_insert(graph, key, node);
+	array_push(*nodes, node);
+
+	size_t numdeps = resource_source_num_dependencies(uuid, platform);
+	if (numdeps) {
+		node->dependencies = memory_allocate(
+		    HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16, MEMORY_TEMPORARY);
+		node->num_dependencies =
+		    resource_source_dependencies(uuid, platform, node->dependencies, numdeps);
+	}
+	for (size_t idep = 0; idep < node->num_dependencies; ++idep)
+		resource_compile_queue_collect(node->dependencies[idep].uuid, platform, graph, nodes);
+}
+
+static void
+resource_compile_queue_release(hashmap_t* graph, resource_compile_queue_node_t** nodes) {
+	for (size_t inode = 0, nsize = array_size(nodes); inode < nsize; ++inode) {
+		memory_deallocate(nodes[inode]->dependencies);
+		memory_deallocate(nodes[inode]);
+	}
+	array_deallocate(nodes);
+	hashmap_deallocate(graph);
+}
+
+static resource_compile_queue_entry_t*
+resource_compile_queue_insert(const uuid_t uuid, uint64_t platform, int priority, bool again,
+                              hashmap_t* graph) {
+	hash_t key = resource_dependency_hash(uuid, platform);
+	resource_compile_queue_entry_t* entry = hashmap_lookup(_resource_compile_queue_map, key);
+	if (entry) {
+		if (!uuid_equal(entry->uuid, uuid) || (entry->platform != platform))
+			return nullptr;
+		if (again && entry->running)
+			entry->again = true;
+		resource_compile_queue_raise_entry(entry, priority);
+		return entry;
+	}
+
+	entry = memory_allocate(HASH_RESOURCE, sizeof(resource_compile_queue_entry_t), 0,
+	                        MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	entry->uuid = uuid;
+	entry->platform = platform;
+	entry->key = key;
+	entry->priority = priority;
+	entry->queue_index = (size_t)-1;
+	entry->visiting = true;
+	entry->entry_index = array_size(_resource_compile_queue_entries);
+	array_push(_resource_compile_queue_entries, entry);
+	hashmap_insert(_resource_compile_queue_map, key, entry);
+
+	++_resource_compile_queue_depth;
+	if (_resource_compile_queue_depth > _resource_compile_queue_stats.max_depth)
+		_resource_compile_queue_stats.max_depth = _resource_compile_queue_depth;
+
+	resource_dependency_t localdeps[8];
+	resource_dependency_t* deps = localdeps;
+	size_t numdeps = 0;
+	resource_compile_queue_node_t* node = hashmap_lookup(graph, key);
+	if (node && uuid_equal(node->uuid, uuid)) {
+		deps = node->dependencies;
+		numdeps = node->num_dependencies;
+	} else {
+		// Not collected due to a key collision in the graph, read under the lock
+		size_t depscapacity = sizeof(localdeps) / sizeof(localdeps[0]);
+		numdeps = resource_source_num_dependencies(uuid, platform);
+		if (numdeps > depscapacity)
+			deps = memory_allocate(HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16,
+			                       MEMORY_PERSISTENT);
+		if (numdeps)
+			numdeps = resource_source_dependencies(uuid, platform, deps, numdeps);
+	}
+	for (size_t idep = 0; idep < numdeps; ++idep) {
+		resource_compile_queue_entry_t* dependency =
+		    resource_compile_queue_insert(deps[idep].uuid, platform, priority, false, graph);
+		// Edges back to an entry being walked are cycles, compile order is then undefined
+		if (!dependency || dependency->visiting)
+			continue;
+		bool linked = false;
+		for (size_t iref = 0, rsize = array_size(dependency->dependents); iref < rsize; ++iref)
+			linked = linked || (dependency->dependents[iref] == entry);
+		if (linked)
+			continue;
+		array_push(dependency->dependents, entry);
+		array_push(entry->dependencies, dependency->key);
+		++entry->pending;
+	}
+	if ((deps != localdeps) && (!node || (deps != node->dependencies)))
+		memory_deallocate(deps);
+
+	entry->visiting = false;
+	if (!entry->pending)
+		resource_compile_queue_ready(entry);
+
+	return entry;
+}
+
+static void
+resource_compile_queue_complete(resource_compile_queue_entry_t* entry, bool success) {
+	for (size_t iwait = 0, wsize = array_size(entry->waiters); iwait < wsize; ++iwait) {
+		entry->waiters[iwait]->success = success;
+		semaphore_post(&entry->waiters[iwait]->signal);
+	}
+	array_clear(entry->waiters);
+
+	for (size_t iref = 0, rsize = array_size(entry->dependents); iref < rsize; ++iref) {
+		resource_compile_queue_entry_t* dependent = entry->dependents[iref];
+		if (!success)
+			dependent->failed = true;
+		if (!--dependent->pending)
+			resource_compile_queue_ready(dependent);
+	}
+
+	hashmap_erase(_resource_compile_queue_map, entry->key);
+	size_t last = array_size(_resource_compile_queue_entries) - 1;
+	if (entry->entry_index != last) {
+		_resource_compile_queue_entries[entry->entry_index] = _resource_compile_queue_entries[last];
+		_resource_compile_queue_entries[entry->entry_index]->entry_index = entry->entry_index;
+	}
+	array_pop(_resource_compile_queue_entries);
+	resource_compile_queue_entry_deallocate(entry);
+
+	if (!--_resource_compile_queue_depth) {
+		for (size_t iwait = 0, wsize = array_size(_resource_compile_queue_flush_waiters);
+		     iwait < wsize; ++iwait)
+			semaphore_post(_resource_compile_queue_flush_waiters[iwait]);
+		array_clear(_resource_compile_queue_flush_waiters);
+	}
+}
+
+static void*
+resource_compile_queue_thread(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	set_thread_resource_compile_queue_worker(1);
+	while (true) {
+		semaphore_wait(&_resource_compile_queue_work);
+		if (atomic_load32(&_resource_compile_queue_terminate, memory_order_acquire))
+			break;
+
+		resource_compile_queue_entry_t* entry = nullptr;
+		mutex_lock(_resource_compile_queue_lock);
+		if (array_size(_resource_compile_queue)) {
+			entry = resource_compile_queue_pop();
+			entry->running = true;
+			++_resource_compile_queue_running;
+
+			// Time ready and waiting for a thread, time blocked on dependencies excluded
+			tick_t wait = time_current() - entry->ready;
+			_resource_compile_queue_wait_total += wait;
+			if (time_ticks_to_seconds(wait) > _resource_compile_queue_stats.wait_max)
+				_resource_compile_queue_stats.wait_max = time_ticks_to_seconds(wait);
+		}
+		mutex_unlock(_resource_compile_queue_lock);
+
+		if (!entry)
+			continue;
+
+		bool success = !entry->failed;
+		if (success && resource_compile_need_update_node(entry->uuid, entry->platform))
+			success = resource_compile_node(entry->uuid, entry->platform);
+
+		mutex_lock(_resource_compile_queue_lock);
+		entry->running = false;
+		--_resource_compile_queue_running;
+		++_resource_compile_queue_stats.completed;
+		if (entry->again) {
+			entry->again = false;
+			entry->failed = false;
+			resource_compile_queue_ready(entry);
+		} else {
+			resource_compile_queue_complete(entry, success);
+		}
+		mutex_unlock(_resource_compile_queue_lock);
+	}
+	return nullptr;
+}
+
+static resource_compile_queue_entry_t*
+resource_compile_queue_enqueue(const uuid_t uuid, uint64_t platform, int priority,
+                               resource_compile_queue_waiter_t* waiter) {
+	hashmap_t* graph = hashmap_allocate(67, 8);
+	resource_compile_queue_node_t** nodes = nullptr;
+	resource_compile_queue_collect(uuid, platform, graph, &nodes);
+
+	mutex_lock(_resource_compile_queue_lock);
+	if (!_resource_compile_queue_threads) {
+		// Threads are started on first use
+		size_t num_threads = resource_module_config().compile_queue_thread_count;
+		array_resize(_resource_compile_queue_threads, num_threads);
+		for (size_t ithread = 0; ithread < num_threads; ++ithread) {
+			thread_initialize(_resource_compile_queue_threads + ithread,
+			                  resource_compile_queue_thread, nullptr,
+			                  STRING_CONST("resource-compile"), THREAD_PRIORITY_NORMAL, 0);
+			thread_start(_resource_compile_queue_threads + ithread);
+		}
+	}
+	resource_compile_queue_entry_t* entry =
+	    resource_compile_queue_insert(uuid, platform, priority, !waiter, graph);
+	if (entry && waiter)
+		array_push(entry->waiters, waiter);
+	mutex_unlock(_resource_compile_queue_lock);
+
+	resource_compile_queue_release(graph, nodes);
+
+	if (!entry) {
+		string_const_t uuidstr = string_from_uuid_static(uuid);
+		log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+		          STRING_CONST("Compile queue key collision for resource %.*s (platform 0x%" PRIx64
+		                       "), compiling inline"),
+		          STRING_FORMAT(uuidstr), platform);
+	}
+	return entry;
+}
+
+void
+resource_compile_queue_push(const uuid_t uuid, uint64_t platform, int priority) {
+	if (!resource_compile_queue_is_active()) {
+		if (resource_compile_need_update(uuid, platform))
+			resource_compile(uuid, platform);
+		return;
+	}
+	if (!resource_compile_queue_enqueue(uuid, platform, priority, nullptr)) {
+		if (resource_compile_need_update(uuid, platform))
+			resource_compile(uuid, platform);
+	}
+}
+
+bool
+resource_compile_queue_compile(const uuid_t uuid, uint64_t platform, int priority) {
+	if (resource_compile_queue_is_active()) {
+		resource_compile_queue_waiter_t waiter;
+		semaphore_initialize(&waiter.signal, 0);
+		waiter.success = false;
+		bool queued =
+		    (resource_compile_queue_enqueue(uuid, platform, priority, &waiter) != nullptr);
+		if (queued)
+			semaphore_wait(&waiter.signal);
+		semaphore_finalize(&waiter.signal);
+		if (queued)
+			return waiter.success;
+	}
+	if (resource_compile_need_update(uuid, platform))
+		return resource_compile(uuid, platform);
+	return true;
+}
+
+bool
+resource_compile_queue_raise(const uuid_t uuid, uint64_t platform, int priority) {
+	if (!_resource_compile_queue_lock)
+		return false;
+	mutex_lock(_resource_compile_queue_lock);
+	resource_compile_queue_entry_t* entry =
+	    hashmap_lookup(_resource_compile_queue_map, resource_dependency_hash(uuid, platform));
+	bool found = entry && uuid_equal(entry->uuid, uuid) && (entry->platform == platform);
+	if (found)
+		resource_compile_queue_raise_entry(entry, priority);
+	mutex_unlock(_resource_compile_queue_lock);
+	return found;
+}
+
+void
+resource_compile_queue_flush(void) {
+	if (!_resource_compile_queue_lock)
+		return;
+	semaphore_t signal;
+	semaphore_initialize(&signal, 0);
+	mutex_lock(_resource_compile_queue_lock);
+	bool pending = (_resource_compile_queue_depth > 0);
+	if (pending)
+		array_push(_resource_compile_queue_flush_waiters, &signal);
+	mutex_unlock(_resource_compile_queue_lock);
+	if (pending)
+		semaphore_wait(&signal);
+	semaphore_finalize(&signal);
+}
+
+resource_compile_queue_statistics_t
+resource_compile_queue_statistics(void) {
+	resource_compile_queue_statistics_t stats;
+	memset(&stats, 0, sizeof(stats));
+	if (!_resource_compile_queue_lock)
+		return stats;
+	mutex_lock(_resource_compile_queue_lock);
+	stats = _resource_compile_queue_stats;
+	stats.queued = array_size(_resource_compile_queue);
+	stats.running = _resource_compile_queue_running;
+	stats.blocked = _resource_compile_queue_depth - stats.queued - stats.running;
+	if (stats.completed)
+		stats.wait_average = time_ticks_to_seconds(_resource_compile_queue_wait_total) /
+		                     (deltatime_t)stats.completed;
+	mutex_unlock(_resource_compile_queue_lock);
+	return stats;
+}
+
+#else
+
+void
+resource_compile_queue_push(const uuid_t uuid, uint64_t platform, int priority) {
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(priority);
+}
+
+bool
+resource_compile_queue_compile(const uuid_t uuid, uint64_t platform, int priority) {
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(priority);
+	return false;
+}
+
+bool
+resource_compile_queue_raise(const uuid_t uuid, uint64_t platform, int priority) {
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(priority);
+	return false;
+}
+
+void
+resource_compile_queue_flush(void) {
+}
+
+resource_compile_queue_statistics_t
+resource_compile_queue_statistics(void) {
+	resource_compile_queue_statistics_t stats;
+	memset(&stats, 0, sizeof(stats));
+	return stats;
+}
+
+#endif
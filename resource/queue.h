@@ -0,0 +1,68 @@
+/* queue.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Check if the compile queue is active on the calling thread. The queue is active
+if enabled in the module config, and never on compile queue threads themselves
+to avoid blocking a queue thread on work queued behind it.
+\return true if compile queue is active */
+RESOURCE_API bool
+resource_compile_queue_is_active(void);
+
+/*! Queue a resource for compilation. Dependencies are queued with the same
+priority, and a resource already queued has its priority and the priority of its
+dependencies raised to the highest priority requested. A resource is compiled
+once all of its queued dependencies have been processed. A resource pushed again
+while compiling is processed once more when done. If the queue is not active the
+resource is compiled on the calling thread.
+\param uuid Resource UUID
+\param platform Resource platform
+\param priority Priority, see resource_compile_priority */
+RESOURCE_API void
+resource_compile_queue_push(const uuid_t uuid, uint64_t platform, int priority);
+
+/*! Queue a resource for compilation and wait until it has been processed
+\param uuid Resource UUID
+\param platform Resource platform
+\param priority Priority, see resource_compile_priority
+\return true if resource is up to date or compiled successfully, false if not */
+RESOURCE_API bool
+resource_compile_queue_compile(const uuid_t uuid, uint64_t platform, int priority);
+
+/*! Raise the priority of a resource already in the queue or being compiled, and of
+its queued dependencies. Resources not in the queue are not queued
+\param uuid Resource UUID
+\param platform Resource platform
+\param priority Priority, see resource_compile_priority
+\return true if resource was found in the queue, false if not */
+RESOURCE_API bool
+resource_compile_queue_raise(const uuid_t uuid, uint64_t platform, int priority);
+
+/*! Wait until the compile queue is empty */
+RESOURCE_API void
+resource_compile_queue_flush(void);
+
+/*! Get compile queue depth and wait time statistics
+\return Queue statistics */
+RESOURCE_API resource_compile_queue_statistics_t
+resource_compile_queue_statistics(void);
@@ -41,6 +41,8 @@ resource_module_initialize_config(const resource_config_t config) {
 #endif
 	if (!_resource_config.enable_local_source)
 		_resource_config.enable_local_autoimport = false;
+	if (!_resource_config.tool_process_limit)
+		_resource_config.tool_process_limit = system_hardware_threads();
 }
 
 int
@@ -52,6 +54,24 @@ resource_module_initialize(const resource_config_t config) {
 
 	_resource_event_stream = event_stream_allocate(0);
 
+	if (resource_tool_initialize() < 0)
+		return -1;
+
+	if (resource_worker_initialize() < 0)
+		return -1;
+
+	if (resource_cache_initialize() < 0)
+		return -1;
+
+	if (resource_failure_initialize() < 0)
+		return -1;
+
+	if (resource_metrics_initialize() < 0)
+		return -1;
+
+	if (resource_hashcache_initialize() < 0)
+		return -1;
+
 	size_t iarg, argsize, ipath;
 	const string_const_t* cmdline = environment_command_line();
 	for (iarg = 0, argsize = array_size(cmdline); iarg < argsize; ++iarg) {
@@ -99,6 +119,21 @@ resource_module_initialize(const resource_config_t config) {
 			resource_import_register_path(STRING_ARGS(cmdline[iarg]));
 			resource_compile_register_path(STRING_ARGS(cmdline[iarg]));
 		}
+		else if (string_equal(STRING_ARGS(cmdline[iarg]), STRING_CONST("--resource-compile-cache")) &&
+		         (iarg < (argsize - 1))) {
+			++iarg;
+			resource_cache_set_path(STRING_ARGS(cmdline[iarg]));
+		}
+		else if (string_equal(STRING_ARGS(cmdline[iarg]), STRING_CONST("--resource-hash-cache")) &&
+		         (iarg < (argsize - 1))) {
+			++iarg;
+			resource_hashcache_set_path(STRING_ARGS(cmdline[iarg]));
+		}
+		else if (string_equal(STRING_ARGS(cmdline[iarg]), STRING_CONST("--resource-metrics")) &&
+		         (iarg < (argsize - 1))) {
+			++iarg;
+			resource_metrics_set_dump_path(STRING_ARGS(cmdline[iarg]));
+		}
 	}
 
 	//Make sure we have at least one way of loading resources
@@ -112,15 +147,27 @@ resource_module_initialize(const resource_config_t config) {
 	if (resource_import_initialize() < 0)
 		return -1;
 
+	if (resource_import_map_initialize() < 0)
+		return -1;
+
 	if (resource_compile_initialize() < 0)
 		return -1;
 
+	if (resource_compile_queue_initialize() < 0)
+		return -1;
+
+	if (resource_speculate_initialize() < 0)
+		return -1;
+
 	if (resource_autoimport_initialize() < 0)
 		return -1;
 
 	if (resource_remote_initialize() < 0)
 		return -1;
 
+	if (resource_async_initialize() < 0)
+		return -1;
+
 	_resource_module_initialized = true;
 
 	return 0;
@@ -131,12 +178,23 @@ resource_module_finalize(void) {
 	if (!_resource_module_initialized)
 		return;
 
+	resource_async_finalize();
+	resource_speculate_finalize();
+	resource_compile_queue_finalize();
+
 	resource_local_clear_paths();
 
 	resource_remote_finalize();
 	resource_autoimport_finalize();
+	resource_import_map_finalize();
 	resource_import_finalize();
 	resource_compile_finalize();
+	resource_hashcache_finalize();
+	resource_metrics_finalize();
+	resource_failure_finalize();
+	resource_cache_finalize();
+	resource_worker_finalize();
+	resource_tool_finalize();
 
 	event_stream_deallocate(_resource_event_stream);
 
@@ -196,6 +254,8 @@ resource_module_parse_config(const char* path, size_t path_size,
 						resource_import_register_path(STRING_ARGS(fullpath));
 						resource_compile_register_path(STRING_ARGS(fullpath));
 					}
+					else if (string_equal(STRING_ARGS(resid), STRING_CONST("compile_cache")))
+						resource_cache_set_path(STRING_ARGS(fullpath));
 				}
 				else if (tokens[restok].type == JSON_ARRAY) {
 					if (idhash == HASH_AUTOIMPORT_PATH) {
@@ -26,8 +26,20 @@
 
 #include <resource/event.h>
 #include <resource/stream.h>
+#include <resource/async.h>
+#include <resource/batch.h>
 #include <resource/bundle.h>
 #include <resource/compile.h>
+#include <resource/cache.h>
+#include <resource/failure.h>
+#include <resource/digest.h>
+#include <resource/hashcache.h>
+#include <resource/metrics.h>
+#include <resource/tool.h>
+#include <resource/worker.h>
+#include <resource/schedule.h>
+#include <resource/queue.h>
+#include <resource/speculate.h>
 #include <resource/local.h>
 #include <resource/remote.h>
 #include <resource/change.h>
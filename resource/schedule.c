@@ -0,0 +1,402 @@
+/* schedule.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+typedef struct resource_schedule_link_t resource_schedule_link_t;
+typedef struct resource_schedule_worker_t resource_schedule_worker_t;
+
+struct resource_schedule_link_t {
+	//! Indices of nodes depending on this node
+	size_t* dependents;
+	//! Number of dependencies
+	int32_t dependencies;
+	//! Number of dependencies not yet processed
+	atomic32_t pending;
+	//! Flag set if any dependency failed
+	atomic32_t failed;
+};
+
+struct resource_schedule_worker_t {
+	resource_schedule_t* schedule;
+	unsigned int index;
+	thread_t thread;
+	mutex_t* lock;
+	//! Queue of node indices, owner pushes and pops at end, thieves steal at head
+	size_t* queue;
+	size_t head;
+};
+
+struct resource_schedule_t {
+	resource_schedule_node_t* nodes;
+	resource_schedule_link_t* links;
+	size_t* order;
+	hashmap_t* map;
+	size_t threads;
+	resource_schedule_worker_t* workers;
+	size_t num_workers;
+	semaphore_t work;
+	atomic32_t completed;
+	atomic32_t terminate;
+};
+
+resource_schedule_t*
+resource_schedule_allocate(size_t threads) {
+	resource_schedule_t* schedule =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_schedule_t), 0, MEMORY_PERSISTENT);
+	memset(schedule, 0, sizeof(resource_schedule_t));
+	schedule->map = hashmap_allocate(4099, 8);
+	schedule->threads = threads ? threads : system_hardware_threads();
+	return schedule;
+}
+
+void
+resource_schedule_deallocate(resource_schedule_t* schedule) {
+	if (!schedule)
+		return;
+	for (size_t ilink = 0, lsize = array_size(schedule->links); ilink < lsize; ++ilink)
+		array_deallocate(schedule->links[ilink].dependents);
+	array_deallocate(schedule->links);
+	array_deallocate(schedule->nodes);
+	array_deallocate(schedule->order);
+	hashmap_deallocate(schedule->map);
+	memory_deallocate(schedule);
+}
+
+static size_t
+resource_schedule_find(resource_schedule_t* schedule, const uuid_t uuid, uint64_t platform) {
+	void* stored = hashmap_lookup(schedule->map, resource_dependency_hash(uuid, platform));
+	if (stored) {
+		size_t inode = (size_t)(uintptr_t)stored - 1;
+		if (uuid_equal(schedule->nodes[inode].uuid, uuid) &&
+		    (schedule->nodes[inode].platform == platform))
+			return inode;
+		// Hash collision, resolve with linear search
+		for (inode = 0; inode < array_size(schedule->nodes); ++inode) {
+			if (uuid_equal(schedule->nodes[inode].uuid, uuid) &&
+			    (schedule->nodes[inode].platform == platform))
+				return inode;
+		}
+	}
+	return (size_t)-1;
+}
+
+static size_t
+resource_schedule_insert(resource_schedule_t* schedule, const uuid_t uuid, uint64_t platform) {
+	size_t inode = resource_schedule_find(schedule, uuid, platform);
+	if (inode != (size_t)-1)
+		return inode;
+
+	resource_schedule_node_t node;
+	memset(&node, 0, sizeof(node));
+	node.uuid = uuid;
+	node.platform = platform;
+
+	resource_schedule_link_t link;
+	memset(&link, 0, sizeof(link));
+
+	inode = array_size(schedule->nodes);
+	array_push(schedule->nodes, node);
+	array_push(schedule->links, link);
+	hashmap_insert(schedule->map, resource_dependency_hash(uuid, platform),
+	               (void*)(uintptr_t)(inode + 1));
+
+	// Resolve dependencies, node is already in map so cycles terminate
+	resource_dependency_t localdeps[8];
+	size_t depscapacity = sizeof(localdeps) / sizeof(localdeps[0]);
+	size_t numdeps = resource_source_num_dependencies(uuid, platform);
+	if (numdeps) {
+		resource_dependency_t* deps = localdeps;
+		if (numdeps > depscapacity)
+			deps = memory_allocate(HASH_RESOURCE, sizeof(resource_dependency_t) * numdeps, 16,
+			                       MEMORY_PERSISTENT);
+		numdeps = resource_source_dependencies(uuid, platform, deps, numdeps);
+		for (size_t idep = 0; idep < numdeps; ++idep) {
+			size_t idepnode = resource_schedule_insert(schedule, deps[idep].uuid, platform);
+			array_push(schedule->links[idepnode].dependents, inode);
+			++schedule->links[inode].dependencies;
+		}
+		if (deps != localdeps)
+			memory_deallocate(deps);
+	}
+	schedule->nodes[inode].num_dependencies = (size_t)schedule->links[inode].dependencies;
+
+	return inode;
+}
+
+void
+resource_schedule_add(resource_schedule_t* schedule, const uuid_t uuid, uint64_t platform) {
+	resource_schedule_insert(schedule, uuid, platform);
+}
+
+const resource_schedule_node_t*
+resource_schedule_nodes(resource_schedule_t* schedule, size_t* count) {
+	if (count)
+		*count = array_size(schedule->nodes);
+	return schedule->nodes;
+}
+
+static void
+resource_schedule_push(resource_schedule_worker_t* worker, size_t inode) {
+	mutex_lock(worker->lock);
+	array_push(worker->queue, inode);
+	mutex_unlock(worker->lock);
+	semaphore_post(&worker->schedule->work);
+}
+
+static bool
+resource_schedule_pop(resource_schedule_worker_t* worker, size_t* inode) {
+	bool found = false;
+	mutex_lock(worker->lock);
+	if (array_size(worker->queue) > worker->head) {
+		*inode = worker->queue[array_size(worker->queue) - 1];
+		array_pop(worker->queue);
+		found = true;
+	}
+	if (worker->head >= array_size(worker->queue)) {
+		array_clear(worker->queue);
+		worker->head = 0;
+	}
+	mutex_unlock(worker->lock);
+	return found;
+}
+
+static bool
+resource_schedule_steal(resource_schedule_worker_t* worker, size_t* inode) {
+	// Called with worker lock held
+	if (array_size(worker->queue) <= worker->head)
+		return false;
+	*inode = worker->queue[worker->head++];
+	return true;
+}
+
+static bool
+resource_schedule_take(resource_schedule_worker_t* worker, size_t* inode) {
+	resource_schedule_t* schedule = worker->schedule;
+	// Newest node from own queue keeps dependency chains local to the worker,
+	// oldest node from another queue spreads out the remaining graph
+	if (resource_schedule_pop(worker, inode))
+		return true;
+
+	// Every post matches a queued node, but a node pushed to an already visited queue
+	// while another worker steals the node matching this post would be missed. Scan all
+	// queues with all locks held, in worker order, to see them in one consistent state.
+	bool found = false;
+	for (size_t iworker = 0; iworker < schedule->num_workers; ++iworker)
+		mutex_lock(schedule->workers[iworker].lock);
+	for (size_t iworker = 0; !found && (iworker < schedule->num_workers); ++iworker) {
+		size_t ivictim = (worker->index + iworker) % schedule->num_workers;
+		found = resource_schedule_steal(schedule->workers + ivictim, inode);
+	}
+	for (size_t iworker = 0; iworker < schedule->num_workers; ++iworker)
+		mutex_unlock(schedule->workers[iworker].lock);
+	return found;
+}
+
+static void
+resource_schedule_process(resource_schedule_worker_t* worker, size_t inode) {
+	resource_schedule_t* schedule = worker->schedule;
+	resource_schedule_node_t* node = schedule->nodes + inode;
+	resource_schedule_link_t* link = schedule->links + inode;
+
+	node->worker = worker->index;
+	node->start = time_current();
+	node->checked = node->start;
+	if (atomic_load32(&link->failed, memory_order_acquire)) {
+		node->state = RESOURCESCHEDULE_SKIPPED;
+	} else {
+		bool need_update = resource_compile_need_update_node(node->uuid, node->platform);
+		node->checked = time_current();
+		if (!need_update)
+			node->state = RESOURCESCHEDULE_UPTODATE;
+		else if (resource_compile_node(node->uuid, node->platform))
+			node->state = RESOURCESCHEDULE_COMPILED;
+		else
+			node->state = RESOURCESCHEDULE_FAILED;
+	}
+	node->end = time_current();
+
+#if BUILD_ENABLE_DEBUG_LOG
+	string_const_t uuidstr = string_from_uuid_static(node->uuid);
+	log_debugf(HASH_RESOURCE,
+	           STRING_CONST("Schedule: %.*s (platform 0x%" PRIx64 ") state %d in %.3fms (worker %u)"),
+	           STRING_FORMAT(uuidstr), node->platform, (int)node->state,
+	           (double)time_ticks_to_seconds(time_diff(node->start, node->end)) * 1000.0,
+	           node->worker);
+#endif
+
+	bool failed =
+	    (node->state == RESOURCESCHEDULE_FAILED) || (node->state == RESOURCESCHEDULE_SKIPPED);
+	for (size_t idep = 0, dsize = array_size(link->dependents); idep < dsize; ++idep) {
+		resource_schedule_link_t* deplink = schedule->links + link->dependents[idep];
+		if (failed)
+			atomic_store32(&deplink->failed, 1, memory_order_release);
+		if (atomic_decr32(&deplink->pending, memory_order_acq_rel) == 0)
+			resource_schedule_push(worker, link->dependents[idep]);
+	}
+
+	if (atomic_incr32(&schedule->completed, memory_order_acq_rel) ==
+	    (int32_t)array_size(schedule->order)) {
+		atomic_store32(&schedule->terminate, 1, memory_order_release);
+		for (size_t iworker = 0; iworker < schedule->num_workers; ++iworker)
+			semaphore_post(&schedule->work);
+	}
+}
+
+static void*
+resource_schedule_worker(void* arg) {
+	resource_schedule_worker_t* worker = arg;
+	resource_schedule_t* schedule = worker->schedule;
+	while (true) {
+		semaphore_wait(&schedule->work);
+		if (atomic_load32(&schedule->terminate, memory_order_acquire))
+			break;
+		size_t inode;
+		if (resource_schedule_take(worker, &inode))
+			resource_schedule_process(worker, inode);
+	}
+	return nullptr;
+}
+
+static size_t
+resource_schedule_sort(resource_schedule_t* schedule) {
+	size_t num_nodes = array_size(schedule->nodes);
+	int32_t* remain =
+	    memory_allocate(HASH_RESOURCE, sizeof(int32_t) * num_nodes, 0, MEMORY_TEMPORARY);
+
+	array_clear(schedule->order);
+	for (size_t inode = 0; inode < num_nodes; ++inode) {
+		remain[inode] = schedule->links[inode].dependencies;
+		if (!remain[inode])
+			array_push(schedule->order, inode);
+	}
+	for (size_t iorder = 0; iorder < array_size(schedule->order); ++iorder) {
+		resource_schedule_link_t* link = schedule->links + schedule->order[iorder];
+		for (size_t idep = 0, dsize = array_size(link->dependents); idep < dsize; ++idep) {
+			if (!--remain[link->dependents[idep]])
+				array_push(schedule->order, link->dependents[idep]);
+		}
+	}
+
+	// Nodes never reaching zero remaining dependencies are part of or depend on a cycle
+	for (size_t inode = 0; inode < num_nodes; ++inode) {
+		if (remain[inode]) {
+			schedule->nodes[inode].state = RESOURCESCHEDULE_CYCLE;
+			string_const_t uuidstr = string_from_uuid_static(schedule->nodes[inode].uuid);
+			log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+			          STRING_CONST("Dependency cycle, unable to schedule: %.*s (platform 0x%" PRIx64
+			                       ")"),
+			          STRING_FORMAT(uuidstr), schedule->nodes[inode].platform);
+		}
+	}
+
+	memory_deallocate(remain);
+
+	return array_size(schedule->order);
+}
+
+bool
+resource_schedule_run(resource_schedule_t* schedule) {
+	size_t inode, iworker;
+	size_t num_nodes = array_size(schedule->nodes);
+	tick_t start = time_current();
+
+	for (inode = 0; inode < num_nodes; ++inode) {
+		schedule->nodes[inode].state = RESOURCESCHEDULE_PENDING;
+		schedule->nodes[inode].start = 0;
+		schedule->nodes[inode].checked = 0;
+		schedule->nodes[inode].end = 0;
+	}
+
+	size_t num_ordered = resource_schedule_sort(schedule);
+	if (num_ordered) {
+		schedule->num_workers = schedule->threads;
+		if (schedule->num_workers > num_ordered)
+			schedule->num_workers = num_ordered;
+		schedule->workers = memory_allocate(
+		    HASH_RESOURCE, sizeof(resource_schedule_worker_t) * schedule->num_workers, 0,
+		    MEMORY_PERSISTENT);
+		memset(schedule->workers, 0, sizeof(resource_schedule_worker_t) * schedule->num_workers);
+
+		semaphore_initialize(&schedule->work, 0);
+		atomic_store32(&schedule->completed, 0, memory_order_release);
+		atomic_store32(&schedule->terminate, 0, memory_order_release);
+
+		for (iworker = 0; iworker < schedule->num_workers; ++iworker) {
+			resource_schedule_worker_t* worker = schedule->workers + iworker;
+			worker->schedule = schedule;
+			worker->index = (unsigned int)iworker;
+			worker->lock = mutex_allocate(STRING_CONST("resource-schedule"));
+		}
+
+		for (inode = 0; inode < num_nodes; ++inode) {
+			resource_schedule_link_t* link = schedule->links + inode;
+			atomic_store32(&link->pending, link->dependencies, memory_order_release);
+			atomic_store32(&link->failed, 0, memory_order_release);
+		}
+
+		// Seed the worker queues with all leaf nodes
+		for (inode = 0, iworker = 0; inode < num_ordered; ++inode) {
+			size_t iordered = schedule->order[inode];
+			if (schedule->links[iordered].dependencies)
+				break;
+			resource_schedule_push(schedule->workers + iworker, iordered);
+			iworker = (iworker + 1) % schedule->num_workers;
+		}
+
+		for (iworker = 0; iworker < schedule->num_workers; ++iworker) {
+			resource_schedule_worker_t* worker = schedule->workers + iworker;
+			thread_initialize(&worker->thread, resource_schedule_worker, worker,
+			                  STRING_CONST("resource-schedule"), THREAD_PRIORITY_NORMAL, 0);
+			thread_start(&worker->thread);
+		}
+
+		for (iworker = 0; iworker < schedule->num_workers; ++iworker) {
+			resource_schedule_worker_t* worker = schedule->workers + iworker;
+			thread_join(&worker->thread);
+			thread_finalize(&worker->thread);
+			mutex_deallocate(worker->lock);
+			array_deallocate(worker->queue);
+		}
+
+		semaphore_finalize(&schedule->work);
+		memory_deallocate(schedule->workers);
+		schedule->workers = nullptr;
+	}
+
+	size_t count[RESOURCESCHEDULE_CYCLE + 1];
+	memset(count, 0, sizeof(count));
+	for (inode = 0; inode < num_nodes; ++inode)
+		++count[schedule->nodes[inode].state];
+
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Scheduled %" PRIsize " resources in %.3fs on %" PRIsize
+	                       " threads: %" PRIsize " compiled, %" PRIsize " up to date, %" PRIsize
+	                       " failed, %" PRIsize " skipped, %" PRIsize " in cycles"),
+	          num_nodes, (double)time_elapsed(start), schedule->num_workers,
+	          count[RESOURCESCHEDULE_COMPILED], count[RESOURCESCHEDULE_UPTODATE],
+	          count[RESOURCESCHEDULE_FAILED], count[RESOURCESCHEDULE_SKIPPED],
+	          count[RESOURCESCHEDULE_CYCLE]);
+
+	return (count[RESOURCESCHEDULE_FAILED] + count[RESOURCESCHEDULE_SKIPPED] +
+	        count[RESOURCESCHEDULE_CYCLE]) == 0;
+}
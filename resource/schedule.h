@@ -0,0 +1,57 @@
+/* schedule.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Allocate a compile schedule
+\param threads Number of worker threads, 0 for number of hardware threads
+\return New compile schedule */
+RESOURCE_API resource_schedule_t*
+resource_schedule_allocate(size_t threads);
+
+/*! Deallocate a compile schedule
+\param schedule Compile schedule */
+RESOURCE_API void
+resource_schedule_deallocate(resource_schedule_t* schedule);
+
+/*! Add a root resource to the schedule. The full dependency graph of the
+resource is resolved and added to the schedule as well.
+\param schedule Compile schedule
+\param uuid Resource UUID
+\param platform Resource platform */
+RESOURCE_API void
+resource_schedule_add(resource_schedule_t* schedule, const uuid_t uuid, uint64_t platform);
+
+/*! Check and compile all resources in the schedule in dependency order, running
+independent resources in parallel on the worker threads. A resource is only processed
+once all its dependencies have been processed, and is skipped if a dependency failed.
+\param schedule Compile schedule
+\return true if all resources are up to date or compiled, false if any failed */
+RESOURCE_API bool
+resource_schedule_run(resource_schedule_t* schedule);
+
+/*! Get the nodes in the schedule, with state and timing from the last run
+\param schedule Compile schedule
+\param count Receives number of nodes
+\return Nodes array */
+RESOURCE_API const resource_schedule_node_t*
+resource_schedule_nodes(resource_schedule_t* schedule, size_t* count);
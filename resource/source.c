@@ -588,6 +588,9 @@ exit:
 
 bool
 resource_source_read(resource_source_t* source, const uuid_t uuid) {
+	// Source reads cover every platform of the resource, existence checks are not reads
+	if (source)
+		resource_compile_record_dependency(uuid, RESOURCE_PLATFORM_ALL);
 	if (source && resource_remote_sourced_is_connected() &&
 	    resource_remote_sourced_read(source, uuid))
 		return true;
@@ -600,13 +603,14 @@ resource_source_write(resource_source_t* source, const uuid_t uuid, bool binary)
 	const char op_set = '=';
 	const char op_unset = '-';
 	const char op_blob = '#';
-	sha256_t sha;
+	resource_digest_t digest;
 	stream_t* stream = resource_source_open(uuid, STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
 	if (!stream)
 		return false;
 	stream_set_binary(stream, binary);
 
-	sha256_initialize(&sha);
+	resource_hash_algorithm algorithm = resource_digest_algorithm();
+	resource_digest_initialize(&digest, algorithm);
 
 	resource_change_block_t* block = &source->first;
 	while (block) {
@@ -620,9 +624,9 @@ resource_source_write(resource_source_t* source, const uuid_t uuid, bool binary)
 			stream_write_uint64(stream, change->platform);
 			stream_write_separator(stream);
 
-			sha256_digest(&sha, &change->timestamp, sizeof(change->timestamp));
-			sha256_digest(&sha, &change->hash, sizeof(change->hash));
-			sha256_digest(&sha, &change->platform, sizeof(change->platform));
+			resource_digest_update(&digest, &change->timestamp, sizeof(change->timestamp));
+			resource_digest_update(&digest, &change->hash, sizeof(change->hash));
+			resource_digest_update(&digest, &change->platform, sizeof(change->platform));
 
 			if (change->flags == RESOURCE_SOURCEFLAG_UNSET) {
 				stream_write(stream, &op_unset, 1);
@@ -634,32 +638,36 @@ resource_source_write(resource_source_t* source, const uuid_t uuid, bool binary)
 					stream_write_separator(stream);
 					stream_write_uint64(stream, change->value.blob.size);
 
-					sha256_digest(&sha, &change->value.blob.checksum,
-					              sizeof(change->value.blob.checksum));
-					sha256_digest(&sha, &change->value.blob.size, sizeof(change->value.blob.size));
+					resource_digest_update(&digest, &change->value.blob.checksum,
+					                       sizeof(change->value.blob.checksum));
+					resource_digest_update(&digest, &change->value.blob.size,
+					                       sizeof(change->value.blob.size));
 				} else {
 					stream_write(stream, &op_set, 1);
 					stream_write_separator(stream);
 					stream_write_string(stream, STRING_ARGS(change->value.value));
 
-					sha256_digest(&sha, STRING_ARGS(change->value.value));
+					resource_digest_update(&digest, STRING_ARGS(change->value.value));
 				}
 			}
 			stream_write_endl(stream);
 
-			sha256_digest(&sha, &change->flags, sizeof(change->flags));
+			resource_digest_update(&digest, &change->flags, sizeof(change->flags));
 		}
 		block = block->next;
 	}
 
 	stream_deallocate(stream);
 
-	sha256_digest_finalize(&sha);
+	uint256_t sourcehash = resource_digest_finalize(&digest);
 
+	// Hash is followed by the algorithm name, readers only parse the leading hash token
 	stream = resource_source_open_hash(uuid, STREAM_OUT | STREAM_CREATE | STREAM_TRUNCATE);
 	if (stream) {
-		uint256_t hash = sha256_get_digest_raw(&sha);
-		string_const_t value = string_from_uint256_static(hash);
+		string_const_t value = string_from_uint256_static(sourcehash);
+		stream_write_string(stream, STRING_ARGS(value));
+		stream_write_separator(stream);
+		value = resource_digest_algorithm_name(algorithm);
 		stream_write_string(stream, STRING_ARGS(value));
 	}
 	stream_deallocate(stream);
@@ -449,3 +449,38 @@ sourced_read_notify(socket_t* sock, size_t size, sourced_notify_t* notify) {
 		return 0;
 	return -1;
 }
+
+int
+sourced_write_metrics(socket_t* sock) {
+	sourced_message_t msg = {
+		SOURCED_METRICS,
+		0
+	};
+	if (socket_write(sock, &msg, sizeof(msg)) == sizeof(msg))
+		return 0;
+	return -1;
+}
+
+int
+sourced_write_metrics_reply(socket_t* sock, bool success) {
+	sourced_message_t msg = {
+		SOURCED_METRICS_RESULT,
+		(uint32_t)sizeof(sourced_reply_t)
+	};
+	sourced_reply_t reply = {
+		success ? SOURCED_OK : SOURCED_FAILED,
+		0
+	};
+	if (socket_write(sock, &msg, sizeof(msg)) == sizeof(msg))
+		if (socket_write(sock, &reply, sizeof(reply)) == sizeof(reply))
+			return 0;
+	return -1;
+}
+
+int
+sourced_read_metrics_reply(socket_t* sock, size_t size, sourced_reply_t* result) {
+	if ((size == sizeof(sourced_reply_t)) &&
+	    (socket_read(sock, result, size) == size))
+		return 0;
+	return -1;
+}
@@ -61,7 +61,10 @@ enum sourced_message_id {
 	SOURCED_NOTIFY_CREATE,
 	SOURCED_NOTIFY_MODIFY,
 	SOURCED_NOTIFY_DEPENDS,
-	SOURCED_NOTIFY_DELETE
+	SOURCED_NOTIFY_DELETE,
+
+	SOURCED_METRICS,
+	SOURCED_METRICS_RESULT
 };
 
 enum sourced_result_id {
@@ -337,3 +340,12 @@ sourced_write_notify(socket_t* sock, sourced_message_id id, uuid_t uuid, uint64_
 
 int
 sourced_read_notify(socket_t* sock, size_t size, sourced_notify_t* notify);
+
+int
+sourced_write_metrics(socket_t* sock);
+
+int
+sourced_write_metrics_reply(socket_t* sock, bool success);
+
+int
+sourced_read_metrics_reply(socket_t* sock, size_t size, sourced_reply_t* result);
@@ -0,0 +1,234 @@
+/* speculate.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+typedef struct resource_speculate_pending_t resource_speculate_pending_t;
+
+struct resource_speculate_pending_t {
+	uuid_t uuid;
+	uint64_t platform;
+	tick_t deadline;
+};
+
+static mutex_t* _resource_speculate_lock;
+static uint64_t* _resource_speculate_platforms;
+static resource_speculate_pending_t* _resource_speculate_pending;
+static semaphore_t _resource_speculate_signal;
+static thread_t _resource_speculate_thread;
+static bool _resource_speculate_started;
+static atomic32_t _resource_speculate_terminate;
+
+int
+resource_speculate_initialize(void) {
+	_resource_speculate_lock = mutex_allocate(STRING_CONST("resource-speculate"));
+	semaphore_initialize(&_resource_speculate_signal, 0);
+	atomic_store32(&_resource_speculate_terminate, 0, memory_order_release);
+	_resource_speculate_started = false;
+	return 0;
+}
+
+void
+resource_speculate_finalize(void) {
+	atomic_store32(&_resource_speculate_terminate, 1, memory_order_release);
+	if (_resource_speculate_started) {
+		semaphore_post(&_resource_speculate_signal);
+		thread_join(&_resource_speculate_thread);
+		thread_finalize(&_resource_speculate_thread);
+		_resource_speculate_started = false;
+	}
+
+	array_deallocate(_resource_speculate_pending);
+	array_deallocate(_resource_speculate_platforms);
+	semaphore_finalize(&_resource_speculate_signal);
+	mutex_deallocate(_resource_speculate_lock);
+
+	_resource_speculate_pending = nullptr;
+	_resource_speculate_platforms = nullptr;
+	_resource_speculate_lock = nullptr;
+}
+
+#if (RESOURCE_ENABLE_LOCAL_SOURCE || RESOURCE_ENABLE_REMOTE_SOURCED) && RESOURCE_ENABLE_LOCAL_CACHE
+
+static tick_t
+resource_speculate_delay(void) {
+	unsigned int delay = resource_module_config().speculative_compile_delay;
+	if (!delay)
+		delay = 250;
+	return (time_ticks_per_second() * (tick_t)delay) / 1000;
+}
+
+static void*
+resource_speculate_thread(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	unsigned int timeout = 0;
+	resource_speculate_pending_t* ready = nullptr;
+	uint64_t* platforms = nullptr;
+	while (!atomic_load32(&_resource_speculate_terminate, memory_order_acquire)) {
+		if (timeout)
+			semaphore_try_wait(&_resource_speculate_signal, timeout);
+		else
+			semaphore_wait(&_resource_speculate_signal);
+		if (atomic_load32(&_resource_speculate_terminate, memory_order_acquire))
+			break;
+
+		// Collect resources that have been quiet for the full delay
+		tick_t now = time_current();
+		tick_t next = 0;
+		array_clear(ready);
+		mutex_lock(_resource_speculate_lock);
+		for (size_t ipend = 0; ipend < array_size(_resource_speculate_pending);) {
+			resource_speculate_pending_t* pending = _resource_speculate_pending + ipend;
+			if (pending->deadline <= now) {
+				array_push(ready, *pending);
+				array_erase(_resource_speculate_pending, ipend);
+				continue;
+			}
+			if (!next || (pending->deadline < next))
+				next = pending->deadline;
+			++ipend;
+		}
+		array_clear(platforms);
+		for (size_t iplat = 0, psize = array_size(_resource_speculate_platforms); iplat < psize;
+		     ++iplat)
+			array_push(platforms, _resource_speculate_platforms[iplat]);
+		mutex_unlock(_resource_speculate_lock);
+
+		timeout = 0;
+		if (next)
+			timeout = (unsigned int)((time_ticks_to_seconds(next - now) * 1000.0) + 1.0);
+
+		for (size_t iready = 0, rsize = array_size(ready); iready < rsize; ++iready) {
+			for (size_t iplat = 0, psize = array_size(platforms); iplat < psize; ++iplat) {
+				if (ready[iready].platform &&
+				    !resource_platform_is_equal_or_more_specific(platforms[iplat],
+				                                                 ready[iready].platform))
+					continue;
+				resource_compile_queue_push(ready[iready].uuid, platforms[iplat],
+				                            RESOURCECOMPILE_PRIORITY_SPECULATIVE);
+			}
+		}
+	}
+	array_deallocate(ready);
+	array_deallocate(platforms);
+	return nullptr;
+}
+
+void
+resource_speculate_add_platform(uint64_t platform) {
+	mutex_lock(_resource_speculate_lock);
+	for (size_t iplat = 0, psize = array_size(_resource_speculate_platforms); iplat < psize;
+	     ++iplat) {
+		if (_resource_speculate_platforms[iplat] == platform) {
+			mutex_unlock(_resource_speculate_lock);
+			return;
+		}
+	}
+	array_push(_resource_speculate_platforms, platform);
+	if (!_resource_speculate_started) {
+		// Thread is started on first use
+		thread_initialize(&_resource_speculate_thread, resource_speculate_thread, nullptr,
+		                  STRING_CONST("resource-speculate"), THREAD_PRIORITY_BELOWNORMAL, 0);
+		thread_start(&_resource_speculate_thread);
+		_resource_speculate_started = true;
+	}
+	mutex_unlock(_resource_speculate_lock);
+}
+
+void
+resource_speculate_remove_platform(uint64_t platform) {
+	mutex_lock(_resource_speculate_lock);
+	for (size_t iplat = 0, psize = array_size(_resource_speculate_platforms); iplat < psize;
+	     ++iplat) {
+		if (_resource_speculate_platforms[iplat] == platform) {
+			array_erase(_resource_speculate_platforms, iplat);
+			break;
+		}
+	}
+	if (!array_size(_resource_speculate_platforms))
+		array_clear(_resource_speculate_pending);
+	mutex_unlock(_resource_speculate_lock);
+}
+
+void
+resource_speculate_clear_platforms(void) {
+	mutex_lock(_resource_speculate_lock);
+	array_clear(_resource_speculate_platforms);
+	array_clear(_resource_speculate_pending);
+	mutex_unlock(_resource_speculate_lock);
+}
+
+void
+resource_speculate_event_handle(event_t* event) {
+	if ((event->id != RESOURCEEVENT_CREATE) && (event->id != RESOURCEEVENT_MODIFY) &&
+	    (event->id != RESOURCEEVENT_DEPENDS))
+		return;
+
+	uuid_t uuid = resource_event_uuid(event);
+	uint64_t platform = resource_event_platform(event);
+	tick_t deadline = time_current() + resource_speculate_delay();
+
+	mutex_lock(_resource_speculate_lock);
+	if (!array_size(_resource_speculate_platforms)) {
+		mutex_unlock(_resource_speculate_lock);
+		return;
+	}
+	// Restart the delay for a resource already pending to let edits settle
+	size_t ipend, psize;
+	for (ipend = 0, psize = array_size(_resource_speculate_pending); ipend < psize; ++ipend) {
+		resource_speculate_pending_t* pending = _resource_speculate_pending + ipend;
+		if (uuid_equal(pending->uuid, uuid) && (pending->platform == platform)) {
+			pending->deadline = deadline;
+			break;
+		}
+	}
+	if (ipend == psize) {
+		resource_speculate_pending_t pending = {uuid, platform, deadline};
+		array_push(_resource_speculate_pending, pending);
+	}
+	mutex_unlock(_resource_speculate_lock);
+
+	semaphore_post(&_resource_speculate_signal);
+}
+
+#else
+
+void
+resource_speculate_add_platform(uint64_t platform) {
+	FOUNDATION_UNUSED(platform);
+}
+
+void
+resource_speculate_remove_platform(uint64_t platform) {
+	FOUNDATION_UNUSED(platform);
+}
+
+void
+resource_speculate_clear_platforms(void) {
+}
+
+void
+resource_speculate_event_handle(event_t* event) {
+	FOUNDATION_UNUSED(event);
+}
+
+#endif
@@ -0,0 +1,47 @@
+/* speculate.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Add a platform to the set of hot platforms recompiled in the background when
+resource sources are modified. Speculative recompilation is disabled while the set
+is empty.
+\param platform Platform */
+RESOURCE_API void
+resource_speculate_add_platform(uint64_t platform);
+
+/*! Remove a platform from the set of hot platforms
+\param platform Platform */
+RESOURCE_API void
+resource_speculate_remove_platform(uint64_t platform);
+
+/*! Remove all hot platforms, disabling speculative recompilation */
+RESOURCE_API void
+resource_speculate_clear_platforms(void);
+
+/*! Handle resource events. Modified resources and resources with modified
+dependencies are recompiled for all hot platforms once no new event for the resource
+has been seen within the configured delay. No other event types than resource events
+should be passed to this function.
+\param event Resource event */
+RESOURCE_API void
+resource_speculate_event_handle(event_t* event);
@@ -17,31 +17,79 @@
  */
 
 #include <resource/resource.h>
+#include <resource/internal.h>
 
 #include <foundation/foundation.h>
 
+static void
+resource_stream_reimport(const uuid_t res, uint64_t platform, const char* suffix,
+                         size_t suffix_length, const char* mode, size_t mode_length) {
+	char buffer[BUILD_MAX_PATHLEN];
+
+	if (!resource_autoimport_need_update(res, platform))
+		return;
+
+	// Reimport in the background only if the source exists and a compiled output can be opened
+	// meanwhile, a modify event is posted once reimported. Otherwise import synchronously.
+	string_const_t sourcepath = resource_source_path();
+	string_t path = resource_stream_make_path(buffer, sizeof(buffer), STRING_ARGS(sourcepath), res);
+	if (fs_is_file(STRING_ARGS(path))) {
+		path = resource_local_find_path(buffer, sizeof(buffer), res, platform, suffix,
+		                                suffix_length);
+		if (path.length && resource_autoimport_request(res))
+			return;
+	}
+
+	string_const_t uuidstr = string_from_uuid_static(res);
+	log_debugf(HASH_RESOURCE,
+	           STRING_CONST("Reimporting resource %.*s (platform 0x%" PRIx64 ") (open %.*s)"),
+	           STRING_FORMAT(uuidstr), platform, (int)mode_length, mode);
+	resource_autoimport(res);
+}
+
+static void
+resource_stream_update(resource_compile_session_t* session, const uuid_t res, uint64_t platform,
+                       const char* suffix, size_t suffix_length, const char* mode,
+                       size_t mode_length) {
+	// Only the opened resource is a dependency of a compiler opening it, resources read
+	// while reimporting and compiling it are not
+	resource_compile_recorder_t* recorder = resource_compile_record_suspend();
+
+	resource_stream_reimport(res, platform, suffix, suffix_length, mode, mode_length);
+
+	log_debugf(HASH_RESOURCE, STRING_CONST("Open %.*s compile check"), (int)mode_length, mode);
+	if (!session && resource_compile_queue_is_active()) {
+		// Up to date resources are opened directly without a round trip through the queue
+		if (resource_compile_need_update(res, platform))
+			resource_compile_queue_compile(res, platform, RESOURCECOMPILE_PRIORITY_REQUESTED);
+	} else if (resource_compile_session_need_update(session, res, platform)) {
+		string_const_t uuidstr = string_from_uuid_static(res);
+		log_debugf(HASH_RESOURCE,
+		           STRING_CONST("Recompiling resource %.*s (platform 0x%" PRIx64 ") (open %.*s)"),
+		           STRING_FORMAT(uuidstr), platform, (int)mode_length, mode);
+		resource_compile_session(session, res, platform);
+	}
+
+	resource_compile_record_resume(recorder);
+}
+
 stream_t*
 resource_stream_open_static(const uuid_t res, uint64_t platform) {
+	return resource_stream_open_static_session(nullptr, res, platform);
+}
+
+stream_t*
+resource_stream_open_static_session(resource_compile_session_t* session, const uuid_t res,
+                                    uint64_t platform) {
 	stream_t* stream;
 
+	resource_compile_record_dependency(res, platform);
+
 	stream = resource_remote_open_static(res, platform);
 	if (stream)
 		return stream;
 
-	if (resource_autoimport_need_update(res, platform)) {
-		string_const_t uuidstr = string_from_uuid_static(res);
-		log_debugf(HASH_RESOURCE, STRING_CONST("Reimporting resource %.*s (platform 0x%" PRIx64 ") (open static)"),
-		           STRING_FORMAT(uuidstr), platform);
-		resource_autoimport(res);
-	}
-
-	log_debug(HASH_RESOURCE, STRING_CONST("Open static compile check"));
-	if (resource_compile_need_update(res, platform)) {
-		string_const_t uuidstr = string_from_uuid_static(res);
-		log_debugf(HASH_RESOURCE, STRING_CONST("Recompiling resource %.*s (platform 0x%" PRIx64 ") (open static)"),
-		           STRING_FORMAT(uuidstr), platform);
-		resource_compile(res, platform);
-	}
+	resource_stream_update(session, res, platform, nullptr, 0, STRING_CONST("static"));
 
 	stream = resource_local_open_static(res, platform);
 	if (stream)
@@ -57,26 +105,21 @@ resource_stream_open_static(const uuid_t res, uint64_t platform) {
 
 stream_t*
 resource_stream_open_dynamic(const uuid_t res, uint64_t platform) {
+	return resource_stream_open_dynamic_session(nullptr, res, platform);
+}
+
+stream_t*
+resource_stream_open_dynamic_session(resource_compile_session_t* session, const uuid_t res,
+                                     uint64_t platform) {
 	stream_t* stream;
 
+	resource_compile_record_dependency(res, platform);
+
 	stream = resource_remote_open_dynamic(res, platform);
 	if (stream)
 		return stream;
 
-	if (resource_autoimport_need_update(res, platform)) {
-		string_const_t uuidstr = string_from_uuid_static(res);
-		log_debugf(HASH_RESOURCE, STRING_CONST("Reimporting resource %.*s (platform 0x%" PRIx64 ") (open dynamic)"),
-		           STRING_FORMAT(uuidstr), platform);
-		resource_autoimport(res);
-	}
-
-	log_debug(HASH_RESOURCE, STRING_CONST("Open dynamic compile check"));
-	if (resource_compile_need_update(res, platform)) {
-		string_const_t uuidstr = string_from_uuid_static(res);
-		log_debugf(HASH_RESOURCE, STRING_CONST("Recompiling resource %.*s (platform 0x%" PRIx64 ") (open dynamic)"),
-		           STRING_FORMAT(uuidstr), platform);
-		resource_compile(res, platform);
-	}
+	resource_stream_update(session, res, platform, STRING_CONST(".blob"), STRING_CONST("dynamic"));
 
 	stream = resource_local_open_dynamic(res, platform);
 	if (stream) {
@@ -27,11 +27,23 @@ stream using function, such as loading another resource */
 RESOURCE_API stream_t*
 resource_stream_open_static(const uuid_t res, uint64_t platform);
 
+/*! Open static stream, reusing compile checks and results from the given compile
+session. Same restrictions as resource_stream_open_static apply to the returned stream */
+RESOURCE_API stream_t*
+resource_stream_open_static_session(resource_compile_session_t* session, const uuid_t res,
+                                    uint64_t platform);
+
 /*! The stream returned must be deallocated before calling any other resource
 stream using function, such as loading another resource */
 RESOURCE_API stream_t*
 resource_stream_open_dynamic(const uuid_t res, uint64_t platform);
 
+/*! Open dynamic stream, reusing compile checks and results from the given compile
+session. Same restrictions as resource_stream_open_dynamic apply to the returned stream */
+RESOURCE_API stream_t*
+resource_stream_open_dynamic_session(resource_compile_session_t* session, const uuid_t res,
+                                     uint64_t platform);
+
 RESOURCE_API string_t
 resource_stream_make_path(char* buffer, size_t capacity, const char* base, size_t base_length,
                           const uuid_t res);
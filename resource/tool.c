@@ -0,0 +1,733 @@
+/* tool.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+typedef struct resource_tool_registry_t resource_tool_registry_t;
+
+struct resource_tool_registry_t {
+	mutex_t* lock;
+	string_t* paths;
+	resource_tool_list_t* list;
+	atomic32_t dirty;
+	atomic32_t generation;
+};
+
+typedef struct resource_tool_drain_t resource_tool_drain_t;
+
+//! Standard output of a one-shot tool process consumed by a pooled drain thread
+struct resource_tool_drain_t {
+	stream_t* stream;
+	string_const_t name;
+	semaphore_t done;
+};
+
+struct resource_tool_watch_t {
+	//! Process running the job, null until spawned or attached
+	process_t* process;
+	hash_t job;
+	//! Time the process is killed, 0 if no limit
+	tick_t deadline;
+	//! Exit code override once killed, 0 if running
+	int result;
+};
+
+static resource_tool_registry_t _resource_tool_registry[RESOURCETOOL_COUNT];
+static semaphore_t _resource_tool_slots;
+static mutex_t* _resource_tool_watch_lock;
+static resource_tool_watch_t** _resource_tool_watches;
+static semaphore_t _resource_tool_watch_signal;
+static thread_t _resource_tool_watchdog;
+static bool _resource_tool_watchdog_started;
+static atomic32_t _resource_tool_watchdog_terminate;
+static mutex_t* _resource_tool_drain_lock;
+static resource_tool_drain_t** _resource_tool_drain_queue;
+static semaphore_t _resource_tool_drain_work;
+static thread_t* _resource_tool_drain_threads;
+static atomic32_t _resource_tool_drain_terminate;
+
+#if FOUNDATION_PLATFORM_WINDOWS
+static const char* _resource_tool_pattern[RESOURCETOOL_COUNT] = {"^.*import\\.exe$",
+                                                                 "^.*compile\\.exe$"};
+#else
+static const char* _resource_tool_pattern[RESOURCETOOL_COUNT] = {"^.*import$", "^.*compile$"};
+#endif
+
+int
+resource_tool_initialize(void) {
+	for (int itype = 0; itype < RESOURCETOOL_COUNT; ++itype) {
+		resource_tool_registry_t* registry = _resource_tool_registry + itype;
+		registry->lock = mutex_allocate(STRING_CONST("resource-tool"));
+		registry->paths = nullptr;
+		registry->list = nullptr;
+		atomic_store32(&registry->dirty, 1, memory_order_release);
+	}
+	// Cap the number of concurrently running external tool jobs
+	semaphore_initialize(&_resource_tool_slots,
+	                     (unsigned int)resource_module_config().tool_process_limit);
+	_resource_tool_watch_lock = mutex_allocate(STRING_CONST("resource-tool-watch"));
+	semaphore_initialize(&_resource_tool_watch_signal, 0);
+	atomic_store32(&_resource_tool_watchdog_terminate, 0, memory_order_release);
+	_resource_tool_watchdog_started = false;
+	_resource_tool_drain_lock = mutex_allocate(STRING_CONST("resource-tool-drain"));
+	semaphore_initialize(&_resource_tool_drain_work, 0);
+	atomic_store32(&_resource_tool_drain_terminate, 0, memory_order_release);
+	return 0;
+}
+
+void
+resource_tool_finalize(void) {
+	for (int itype = 0; itype < RESOURCETOOL_COUNT; ++itype) {
+		resource_tool_registry_t* registry = _resource_tool_registry + itype;
+		resource_tool_clear_paths((resource_tool_type)itype);
+		resource_tool_release(registry->list);
+		mutex_deallocate(registry->lock);
+		registry->list = nullptr;
+		registry->lock = nullptr;
+	}
+	semaphore_finalize(&_resource_tool_slots);
+
+	atomic_store32(&_resource_tool_watchdog_terminate, 1, memory_order_release);
+	if (_resource_tool_watchdog_started) {
+		semaphore_post(&_resource_tool_watch_signal);
+		thread_join(&_resource_tool_watchdog);
+		thread_finalize(&_resource_tool_watchdog);
+		_resource_tool_watchdog_started = false;
+	}
+	array_deallocate(_resource_tool_watches);
+	semaphore_finalize(&_resource_tool_watch_signal);
+	mutex_deallocate(_resource_tool_watch_lock);
+	_resource_tool_watches = nullptr;
+	_resource_tool_watch_lock = nullptr;
+
+	size_t ithread, tsize;
+	atomic_store32(&_resource_tool_drain_terminate, 1, memory_order_release);
+	for (ithread = 0, tsize = array_size(_resource_tool_drain_threads); ithread < tsize;
+	     ++ithread)
+		semaphore_post(&_resource_tool_drain_work);
+	for (ithread = 0, tsize = array_size(_resource_tool_drain_threads); ithread < tsize;
+	     ++ithread) {
+		thread_join(_resource_tool_drain_threads + ithread);
+		thread_finalize(_resource_tool_drain_threads + ithread);
+	}
+	array_deallocate(_resource_tool_drain_threads);
+	array_deallocate(_resource_tool_drain_queue);
+	semaphore_finalize(&_resource_tool_drain_work);
+	mutex_deallocate(_resource_tool_drain_lock);
+	_resource_tool_drain_threads = nullptr;
+	_resource_tool_drain_queue = nullptr;
+	_resource_tool_drain_lock = nullptr;
+}
+
+static bool
+resource_tool_path_registered(resource_tool_type exclude, const char* path, size_t length) {
+	for (int itype = 0; itype < RESOURCETOOL_COUNT; ++itype) {
+		if (itype == (int)exclude)
+			continue;
+		const string_t* paths = _resource_tool_registry[itype].paths;
+		if (string_array_find((const string_const_t*)paths, array_size(paths), path, length) >= 0)
+			return true;
+	}
+	return false;
+}
+
+void
+resource_tool_register_path(resource_tool_type type, const char* path, size_t length) {
+	size_t ipath, psize;
+	char buffer[BUILD_MAX_PATHLEN];
+	resource_tool_registry_t* registry = _resource_tool_registry + type;
+	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
+
+	mutex_lock(registry->lock);
+	for (ipath = 0, psize = array_size(registry->paths); ipath != psize; ++ipath) {
+		if (string_equal(STRING_ARGS(registry->paths[ipath]), STRING_ARGS(pathstr)))
+			break;
+	}
+	if (ipath == psize) {
+		// Monitor is shared between tool types using the same path
+		if (!resource_tool_path_registered(type, STRING_ARGS(pathstr)))
+			fs_monitor(STRING_ARGS(pathstr));
+		array_push(registry->paths, string_clone(STRING_ARGS(pathstr)));
+		atomic_store32(&registry->dirty, 1, memory_order_release);
+	}
+	mutex_unlock(registry->lock);
+}
+
+void
+resource_tool_unregister_path(resource_tool_type type, const char* path, size_t length) {
+	size_t ipath, psize;
+	char buffer[BUILD_MAX_PATHLEN];
+	resource_tool_registry_t* registry = _resource_tool_registry + type;
+	string_t pathstr = string_copy(buffer, sizeof(buffer), path, length);
+	pathstr = path_clean(STRING_ARGS(pathstr), sizeof(buffer));
+
+	mutex_lock(registry->lock);
+	for (ipath = 0, psize = array_size(registry->paths); ipath != psize; ++ipath) {
+		if (string_equal(STRING_ARGS(registry->paths[ipath]), STRING_ARGS(pathstr))) {
+			if (!resource_tool_path_registered(type, STRING_ARGS(pathstr)))
+				fs_unmonitor(STRING_ARGS(pathstr));
+			string_deallocate(registry->paths[ipath].str);
+			array_erase(registry->paths, ipath);
+			atomic_store32(&registry->dirty, 1, memory_order_release);
+			break;
+		}
+	}
+	mutex_unlock(registry->lock);
+}
+
+void
+resource_tool_clear_paths(resource_tool_type type) {
+	resource_tool_registry_t* registry = _resource_tool_registry + type;
+	mutex_lock(registry->lock);
+	for (size_t ipath = 0, psize = array_size(registry->paths); ipath != psize; ++ipath) {
+		if (!resource_tool_path_registered(type, STRING_ARGS(registry->paths[ipath])))
+			fs_unmonitor(STRING_ARGS(registry->paths[ipath]));
+	}
+	string_array_deallocate(registry->paths);
+	atomic_store32(&registry->dirty, 1, memory_order_release);
+	mutex_unlock(registry->lock);
+}
+
+static void
+resource_tool_load_manifest(resource_tool_t* tool) {
+	char buffer[BUILD_MAX_PATHLEN];
+	string_const_t dir = path_directory_name(STRING_ARGS(tool->path));
+	string_const_t base = path_base_file_name(STRING_ARGS(tool->path));
+	string_t manifestpath = path_concat(buffer, sizeof(buffer), STRING_ARGS(dir), STRING_ARGS(base));
+	manifestpath =
+	    string_append(STRING_ARGS(manifestpath), sizeof(buffer), STRING_CONST(".manifest"));
+
+	// Manifest is optional, one declaration per line as a key followed by values
+	stream_t* stream = stream_open(STRING_ARGS(manifestpath), STREAM_IN);
+	if (!stream)
+		return;
+
+	while (!stream_eos(stream)) {
+		string_t line = stream_read_line_buffer(stream, buffer, sizeof(buffer), '\n');
+		if (line.length && (line.str[line.length - 1] == '\r'))
+			--line.length;
+		if (!line.length || (line.str[0] == '#'))
+			continue;
+
+		string_const_t tokens[64];
+		size_t numtokens = string_explode(STRING_ARGS(line), STRING_CONST(" \t"), tokens,
+		                                  sizeof(tokens) / sizeof(tokens[0]), false);
+		if (!numtokens)
+			continue;
+		// Worker protocol is opt-in, tools are never probed with the worker flag
+		if (string_equal(STRING_ARGS(tokens[0]), STRING_CONST("worker"))) {
+			tool->worker = true;
+			continue;
+		}
+		if (numtokens < 2)
+			continue;
+		if (string_equal(STRING_ARGS(tokens[0]), STRING_CONST("types"))) {
+			for (size_t itoken = 1; itoken < numtokens; ++itoken)
+				array_push(tool->types, hash(STRING_ARGS(tokens[itoken])));
+		} else if (string_equal(STRING_ARGS(tokens[0]), STRING_CONST("timeout"))) {
+			tool->time_limit = string_to_uint(STRING_ARGS(tokens[1]), false);
+		} else if (string_equal(STRING_ARGS(tokens[0]), STRING_CONST("platforms"))) {
+			tool->multiplatform = string_equal(STRING_ARGS(tokens[1]), STRING_CONST("multiple"));
+		} else if (string_equal(STRING_ARGS(tokens[0]), STRING_CONST("extensions"))) {
+			for (size_t itoken = 1; itoken < numtokens; ++itoken) {
+				hash_t extension = resource_tool_extension_hash(STRING_ARGS(tokens[itoken]));
+				array_push(tool->extensions, extension);
+			}
+		} else if (string_equal(STRING_ARGS(tokens[0]), STRING_CONST("magic"))) {
+			// Magic bytes given as hex strings, for example 89504e47 for PNG files
+			for (size_t itoken = 1; itoken < numtokens; ++itoken) {
+				resource_import_magic_t magic;
+				memset(&magic, 0, sizeof(magic));
+				for (size_t ichar = 0; (ichar + 1 < tokens[itoken].length) &&
+				                       (magic.size < RESOURCE_IMPORT_MAGIC_MAX);
+				     ichar += 2)
+					magic.bytes[magic.size++] =
+					    (uint8_t)string_to_uint(tokens[itoken].str + ichar, 2, true);
+				if (magic.size)
+					array_push(tool->magic, magic);
+			}
+		}
+	}
+
+	stream_deallocate(stream);
+}
+
+static resource_tool_list_t*
+resource_tool_scan(resource_tool_registry_t* registry, const char* pattern, size_t pattern_length) {
+	resource_tool_list_t* list =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_tool_list_t), 0, MEMORY_PERSISTENT);
+	atomic_store32(&list->ref, 1, memory_order_release);
+	list->tools = nullptr;
+
+	for (size_t ipath = 0, psize = array_size(registry->paths); ipath != psize; ++ipath) {
+		string_t* tools =
+		    fs_matching_files(STRING_ARGS(registry->paths[ipath]), pattern, pattern_length, true);
+		for (size_t itool = 0, tsize = array_size(tools); itool != tsize; ++itool) {
+			char buffer[BUILD_MAX_PATHLEN];
+			string_t fullpath = path_concat(buffer, sizeof(buffer),
+			                                STRING_ARGS(registry->paths[ipath]),
+			                                STRING_ARGS(tools[itool]));
+			resource_tool_t tool;
+			tool.path = string_clone(STRING_ARGS(fullpath));
+			tool.types = nullptr;
+			tool.extensions = nullptr;
+			tool.magic = nullptr;
+			tool.time_limit = 0;
+			tool.multiplatform = false;
+			tool.worker = false;
+			resource_tool_load_manifest(&tool);
+			array_push(list->tools, tool);
+		}
+		string_array_deallocate(tools);
+	}
+
+	return list;
+}
+
+resource_tool_list_t*
+resource_tool_acquire(resource_tool_type type) {
+	resource_tool_registry_t* registry = _resource_tool_registry + type;
+	mutex_lock(registry->lock);
+	if (atomic_load32(&registry->dirty, memory_order_acquire) || !registry->list) {
+		atomic_store32(&registry->dirty, 0, memory_order_release);
+		const char* pattern = _resource_tool_pattern[type];
+		resource_tool_list_t* list = resource_tool_scan(registry, pattern, string_length(pattern));
+		resource_tool_release(registry->list);
+		registry->list = list;
+		atomic_incr32(&registry->generation, memory_order_release);
+		log_debugf(HASH_RESOURCE, STRING_CONST("Tool scan: %" PRIsize " tools of type %d"),
+		           array_size(list->tools), (int)type);
+	}
+	resource_tool_list_t* list = registry->list;
+	atomic_incr32(&list->ref, memory_order_relaxed);
+	mutex_unlock(registry->lock);
+	return list;
+}
+
+void
+resource_tool_release(resource_tool_list_t* list) {
+	if (!list || (atomic_decr32(&list->ref, memory_order_acq_rel) > 0))
+		return;
+	for (size_t itool = 0, tsize = array_size(list->tools); itool != tsize; ++itool) {
+		string_deallocate(list->tools[itool].path.str);
+		array_deallocate(list->tools[itool].types);
+		array_deallocate(list->tools[itool].extensions);
+		array_deallocate(list->tools[itool].magic);
+	}
+	array_deallocate(list->tools);
+	memory_deallocate(list);
+}
+
+size_t*
+resource_tool_select(const resource_tool_list_t* list, hash_t type) {
+	size_t* selected = nullptr;
+	size_t itool, tsize;
+	if (!type) {
+		for (itool = 0, tsize = array_size(list->tools); itool != tsize; ++itool)
+			array_push(selected, itool);
+		return selected;
+	}
+	for (itool = 0, tsize = array_size(list->tools); itool != tsize; ++itool) {
+		const hash_t* types = list->tools[itool].types;
+		for (size_t itype = 0, typesize = array_size(types); itype != typesize; ++itype) {
+			if (types[itype] == type) {
+				array_push(selected, itool);
+				break;
+			}
+		}
+	}
+	for (itool = 0, tsize = array_size(list->tools); itool != tsize; ++itool) {
+		if (!array_size(list->tools[itool].types))
+			array_push(selected, itool);
+	}
+	return selected;
+}
+
+hash_t
+resource_tool_extension_hash(const char* extension, size_t length) {
+	char buffer[32];
+	if (length && (extension[0] == '.')) {
+		++extension;
+		--length;
+	}
+	if (length > sizeof(buffer))
+		length = sizeof(buffer);
+	for (size_t ichar = 0; ichar < length; ++ichar) {
+		char c = extension[ichar];
+		buffer[ichar] = ((c >= 'A') && (c <= 'Z')) ? (char)(c + ('a' - 'A')) : c;
+	}
+	return length ? hash(buffer, length) : 0;
+}
+
+int
+resource_tool_match_format(const hash_t* extensions, const resource_import_magic_t* magic,
+                           hash_t extension, const void* header, size_t size) {
+	// 2 for magic match, 1 for extension match, 0 if other formats declared, -1 if undeclared
+	for (size_t imagic = 0, msize = array_size(magic); imagic != msize; ++imagic) {
+		if ((magic[imagic].size <= size) &&
+		    (memcmp(magic[imagic].bytes, header, magic[imagic].size) == 0))
+			return 2;
+	}
+	for (size_t iext = 0, esize = array_size(extensions); extension && (iext != esize); ++iext) {
+		if (extensions[iext] == extension)
+			return 1;
+	}
+	return (array_size(magic) || array_size(extensions)) ? 0 : -1;
+}
+
+size_t*
+resource_tool_select_format(const resource_tool_list_t* list, hash_t extension,
+                            const void* header, size_t size) {
+	size_t* selected = nullptr;
+	int match[] = {2, 1, -1};
+	for (size_t imatch = 0; imatch < sizeof(match) / sizeof(match[0]); ++imatch) {
+		for (size_t itool = 0, tsize = array_size(list->tools); itool != tsize; ++itool) {
+			const resource_tool_t* tool = list->tools + itool;
+			if (resource_tool_match_format(tool->extensions, tool->magic, extension, header,
+			                               size) == match[imatch])
+				array_push(selected, itool);
+		}
+	}
+	return selected;
+}
+
+unsigned int
+resource_tool_generation(resource_tool_type type) {
+	return (unsigned int)atomic_load32(&_resource_tool_registry[type].generation,
+	                                   memory_order_acquire);
+}
+
+void
+resource_tool_refresh(resource_tool_type type) {
+	atomic_store32(&_resource_tool_registry[type].dirty, 1, memory_order_release);
+}
+
+static void*
+resource_tool_watchdog(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	unsigned int timeout = 0;
+	while (true) {
+		if (timeout)
+			semaphore_try_wait(&_resource_tool_watch_signal, timeout);
+		else
+			semaphore_wait(&_resource_tool_watch_signal);
+		if (atomic_load32(&_resource_tool_watchdog_terminate, memory_order_acquire))
+			break;
+
+		// Kill processes past their deadline and sleep until the next deadline
+		tick_t now = time_current();
+		tick_t next = 0;
+		mutex_lock(_resource_tool_watch_lock);
+		for (size_t iwatch = 0, wsize = array_size(_resource_tool_watches); iwatch < wsize;
+		     ++iwatch) {
+			resource_tool_watch_t* watch = _resource_tool_watches[iwatch];
+			if (!watch->deadline || watch->result)
+				continue;
+			if (watch->deadline <= now) {
+				// A process not yet attached is killed as it attaches
+				watch->result = RESOURCE_TOOL_EXIT_TIMEOUT;
+				if (watch->process)
+					process_kill(watch->process);
+			} else if (!next || (watch->deadline < next)) {
+				next = watch->deadline;
+			}
+		}
+		mutex_unlock(_resource_tool_watch_lock);
+
+		timeout = 0;
+		if (next)
+			timeout = (unsigned int)((time_ticks_to_seconds(next - now) * 1000.0) + 1.0);
+	}
+	return nullptr;
+}
+
+void
+resource_tool_watch_begin(resource_tool_watch_t* watch) {
+	mutex_lock(_resource_tool_watch_lock);
+	watch->process = nullptr;
+	array_push(_resource_tool_watches, watch);
+	mutex_unlock(_resource_tool_watch_lock);
+}
+
+static void
+resource_tool_watch_set_deadline(resource_tool_watch_t* watch, tick_t deadline) {
+	mutex_lock(_resource_tool_watch_lock);
+	watch->deadline = deadline;
+	if (!_resource_tool_watchdog_started) {
+		// Watchdog is started on first use of a time limit
+		thread_initialize(&_resource_tool_watchdog, resource_tool_watchdog, nullptr,
+		                  STRING_CONST("resource-tool-watchdog"), THREAD_PRIORITY_ABOVENORMAL, 0);
+		thread_start(&_resource_tool_watchdog);
+		_resource_tool_watchdog_started = true;
+	}
+	mutex_unlock(_resource_tool_watch_lock);
+	semaphore_post(&_resource_tool_watch_signal);
+}
+
+bool
+resource_tool_watch_attach(resource_tool_watch_t* watch, process_t* process) {
+	mutex_lock(_resource_tool_watch_lock);
+	// Job cancelled or timed out before the process was attached
+	bool running = !watch->result;
+	if (running)
+		watch->process = process;
+	mutex_unlock(_resource_tool_watch_lock);
+	return running;
+}
+
+void
+resource_tool_watch_detach(resource_tool_watch_t* watch) {
+	mutex_lock(_resource_tool_watch_lock);
+	watch->process = nullptr;
+	mutex_unlock(_resource_tool_watch_lock);
+}
+
+void
+resource_tool_watch_end(resource_tool_watch_t* watch) {
+	mutex_lock(_resource_tool_watch_lock);
+	for (size_t iwatch = 0, wsize = array_size(_resource_tool_watches); iwatch < wsize;
+	     ++iwatch) {
+		if (_resource_tool_watches[iwatch] == watch) {
+			array_erase(_resource_tool_watches, iwatch);
+			break;
+		}
+	}
+	watch->process = nullptr;
+	mutex_unlock(_resource_tool_watch_lock);
+}
+
+int
+resource_tool_watch_result(resource_tool_watch_t* watch) {
+	mutex_lock(_resource_tool_watch_lock);
+	int result = watch->result;
+	mutex_unlock(_resource_tool_watch_lock);
+	return result;
+}
+
+bool
+resource_tool_cancel(hash_t job) {
+	bool cancelled = false;
+	if (!job)
+		return false;
+	mutex_lock(_resource_tool_watch_lock);
+	for (size_t iwatch = 0, wsize = array_size(_resource_tool_watches); iwatch < wsize;
+	     ++iwatch) {
+		resource_tool_watch_t* watch = _resource_tool_watches[iwatch];
+		if ((watch->job == job) && !watch->result) {
+			// A process not yet attached is killed as it attaches
+			watch->result = RESOURCE_TOOL_EXIT_CANCELLED;
+			if (watch->process)
+				process_kill(watch->process);
+			cancelled = true;
+		}
+	}
+	mutex_unlock(_resource_tool_watch_lock);
+	return cancelled;
+}
+
+static void*
+resource_tool_drain(void* arg) {
+	FOUNDATION_UNUSED(arg);
+	char buffer[BUILD_MAX_PATHLEN];
+	while (true) {
+		semaphore_wait(&_resource_tool_drain_work);
+		if (atomic_load32(&_resource_tool_drain_terminate, memory_order_acquire))
+			break;
+
+		mutex_lock(_resource_tool_drain_lock);
+		resource_tool_drain_t* drain = nullptr;
+		if (array_size(_resource_tool_drain_queue)) {
+			drain = _resource_tool_drain_queue[0];
+			array_erase_ordered(_resource_tool_drain_queue, 0);
+		}
+		mutex_unlock(_resource_tool_drain_lock);
+		if (!drain)
+			continue;
+
+		while (!stream_eos(drain->stream)) {
+			string_t line = stream_read_line_buffer(drain->stream, buffer, sizeof(buffer), '\n');
+			if (line.length && (line.str[line.length - 1] == '\r'))
+				--line.length;
+			if (line.length)
+				log_debugf(HASH_RESOURCE, STRING_CONST("%.*s: %.*s"), STRING_FORMAT(drain->name),
+				           STRING_FORMAT(line));
+		}
+		semaphore_post(&drain->done);
+	}
+	return nullptr;
+}
+
+static void
+resource_tool_drain_queue(resource_tool_drain_t* drain) {
+	mutex_lock(_resource_tool_drain_lock);
+	if (!_resource_tool_drain_threads) {
+		// Drain pool is started on first use, one thread per concurrent tool process
+		size_t count = resource_module_config().tool_process_limit;
+		if (!count)
+			count = 1;
+		array_resize(_resource_tool_drain_threads, count);
+		for (size_t ithread = 0; ithread < count; ++ithread) {
+			thread_initialize(_resource_tool_drain_threads + ithread, resource_tool_drain, nullptr,
+			                  STRING_CONST("resource-tool-drain"), THREAD_PRIORITY_NORMAL, 0);
+			thread_start(_resource_tool_drain_threads + ithread);
+		}
+	}
+	array_push(_resource_tool_drain_queue, drain);
+	mutex_unlock(_resource_tool_drain_lock);
+	semaphore_post(&_resource_tool_drain_work);
+}
+
+static int
+resource_tool_spawn(const resource_tool_t* tool, resource_tool_watch_t* watch,
+                    const string_const_t* args, size_t num_args, const string_const_t* common,
+                    size_t num_common) {
+	char buffer[BUILD_MAX_PATHLEN];
+
+	process_t proc;
+	string_const_t name = path_file_name(STRING_ARGS(tool->path));
+	process_initialize(&proc);
+
+	string_const_t wd = environment_current_working_directory();
+	process_set_working_directory(&proc, STRING_ARGS(wd));
+	process_set_executable_path(&proc, STRING_ARGS(tool->path));
+
+	string_const_t* procargs = nullptr;
+	for (size_t iarg = 0; iarg < num_args; ++iarg)
+		array_push(procargs, args[iarg]);
+	array_push(procargs, string_const(STRING_CONST("--")));
+	for (size_t iarg = 0; iarg < num_common; ++iarg)
+		array_push(procargs, common[iarg]);
+
+	process_set_arguments(&proc, procargs, array_size(procargs));
+	process_set_flags(&proc, PROCESS_STDSTREAMS | PROCESS_DETACHED);
+	if (process_spawn(&proc) != 0) {
+		process_finalize(&proc);
+		array_deallocate(procargs);
+		return -1;
+	}
+
+	// Cancelled or timed out while spawning, the process is killed and its output still drained
+	if (!resource_tool_watch_attach(watch, &proc))
+		process_kill(&proc);
+
+	// Output is consumed as it arrives, stdout on a pooled drain thread and stderr here,
+	// until the tool closes its pipes by exiting or being killed
+	resource_tool_drain_t drain;
+	drain.stream = process_stdout(&proc);
+	drain.name = name;
+	semaphore_initialize(&drain.done, 0);
+	resource_tool_drain_queue(&drain);
+
+	stream_t* err = process_stderr(&proc);
+	while (!stream_eos(err)) {
+		string_t line = stream_read_line_buffer(err, buffer, sizeof(buffer), '\n');
+		if (line.length) {
+			if (line.str[line.length - 1] == '\r')
+				--line.length;
+			log_infof(HASH_RESOURCE, STRING_CONST("%.*s: %.*s"), STRING_FORMAT(name),
+			          STRING_FORMAT(line));
+		}
+	}
+	semaphore_wait(&drain.done);
+	semaphore_finalize(&drain.done);
+
+	// Pipes are closed, the process has exited or is about to, so block on it
+	process_set_flags(&proc, PROCESS_STDSTREAMS);
+	int exit_code;
+	do {
+		exit_code = process_wait(&proc);
+	} while (exit_code == PROCESS_WAIT_INTERRUPTED);
+
+	resource_tool_watch_detach(watch);
+
+	process_finalize(&proc);
+	array_deallocate(procargs);
+
+	return exit_code;
+}
+
+int
+resource_tool_execute(const resource_tool_t* tool, hash_t job, const string_const_t* args,
+                      size_t num_args, const string_const_t* common, size_t num_common) {
+	int exit_code = -1;
+	resource_tool_watch_t watch;
+	memset(&watch, 0, sizeof(watch));
+	watch.job = job;
+	unsigned int limit = tool->time_limit ? tool->time_limit :
+	                                        resource_module_config().tool_time_limit;
+
+	// Registered before waiting for a slot so a cancel is never missed
+	resource_tool_watch_begin(&watch);
+
+	semaphore_wait(&_resource_tool_slots);
+	// Time limit covers running the job, not waiting for a free slot
+	if (limit)
+		resource_tool_watch_set_deadline(
+		    &watch, time_current() + ((time_ticks_per_second() * (tick_t)limit) / 1000));
+	if (!resource_tool_watch_result(&watch) &&
+	    (!resource_module_config().enable_tool_workers || !tool->worker ||
+	     !resource_worker_execute(tool->path, &watch, args, num_args, common, num_common,
+	                              &exit_code))) {
+		// A killed worker must not be retried as a one-shot process
+		if (!resource_tool_watch_result(&watch))
+			exit_code = resource_tool_spawn(tool, &watch, args, num_args, common, num_common);
+	}
+	semaphore_post(&_resource_tool_slots);
+
+	resource_tool_watch_end(&watch);
+
+	if (watch.result == RESOURCE_TOOL_EXIT_TIMEOUT) {
+		log_warnf(HASH_RESOURCE, WARNING_RESOURCE,
+		          STRING_CONST("Tool exceeded time limit of %ums and was killed: %.*s"), limit,
+		          STRING_FORMAT(tool->path));
+		exit_code = watch.result;
+	} else if (watch.result == RESOURCE_TOOL_EXIT_CANCELLED) {
+		log_infof(HASH_RESOURCE, STRING_CONST("Tool job cancelled: %.*s"),
+		          STRING_FORMAT(tool->path));
+		exit_code = watch.result;
+	}
+	return exit_code;
+}
+
+void
+resource_tool_event_handle(event_t* event) {
+	if ((event->id != FOUNDATIONEVENT_FILE_CREATED) &&
+	    (event->id != FOUNDATIONEVENT_FILE_DELETED) &&
+	    (event->id != FOUNDATIONEVENT_FILE_MODIFIED))
+		return;
+
+	const string_const_t path = fs_event_path(event);
+	for (int itype = 0; itype < RESOURCETOOL_COUNT; ++itype) {
+		resource_tool_registry_t* registry = _resource_tool_registry + itype;
+		mutex_lock(registry->lock);
+		for (size_t ipath = 0, psize = array_size(registry->paths); ipath != psize; ++ipath) {
+			if (path_subpath(STRING_ARGS(path), STRING_ARGS(registry->paths[ipath])).length) {
+				log_debugf(HASH_RESOURCE, STRING_CONST("Tool path changed: %.*s"),
+				           STRING_FORMAT(path));
+				atomic_store32(&registry->dirty, 1, memory_order_release);
+				break;
+			}
+		}
+		mutex_unlock(registry->lock);
+	}
+}
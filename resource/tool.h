@@ -0,0 +1,121 @@
+/* tool.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Add a directory to search for external tools of the given type. The directory
+is scanned once and monitored for changes, the discovered tools are cached until
+a file system event invalidates them.
+\param type Tool type
+\param path Directory path
+\param length Length of path */
+RESOURCE_API void
+resource_tool_register_path(resource_tool_type type, const char* path, size_t length);
+
+/*! Remove a directory from the external tool search paths
+\param type Tool type
+\param path Directory path
+\param length Length of path */
+RESOURCE_API void
+resource_tool_unregister_path(resource_tool_type type, const char* path, size_t length);
+
+/*! Remove all external tool search paths for the given type
+\param type Tool type */
+RESOURCE_API void
+resource_tool_clear_paths(resource_tool_type type);
+
+/*! Get a reference to the current list of discovered tools of the given type,
+rescanning the search paths if invalidated. Must be released with
+resource_tool_release
+\param type Tool type
+\return Tool list */
+RESOURCE_API resource_tool_list_t*
+resource_tool_acquire(resource_tool_type type);
+
+/*! Release a reference to a tool list
+\param list Tool list */
+RESOURCE_API void
+resource_tool_release(resource_tool_list_t* list);
+
+/*! Select tools able to handle the given resource type, ordered with tools
+declaring the type in their manifest first followed by tools without a type
+declaration. A zero type selects all tools.
+\param list Tool list
+\param type Resource type hash
+\return Array of indices into tool list, must be deallocated with array_deallocate */
+RESOURCE_API size_t*
+resource_tool_select(const resource_tool_list_t* list, hash_t type);
+
+/*! Select import tools able to handle an asset file, ordered with tools declaring
+matching leading magic bytes in their manifest first, followed by tools declaring a
+matching file extension and last tools without any format declaration. Tools declaring
+other formats are not selected.
+\param list Tool list
+\param extension Hash of lower case file extension as given by resource_tool_extension_hash
+\param header Leading bytes of asset file
+\param size Number of leading bytes
+\return Array of indices into tool list, must be deallocated with array_deallocate */
+RESOURCE_API size_t*
+resource_tool_select_format(const resource_tool_list_t* list, hash_t extension,
+                            const void* header, size_t size);
+
+/*! Get tool list generation, incremented every time the tool list is rescanned
+\param type Tool type
+\return Generation */
+RESOURCE_API unsigned int
+resource_tool_generation(resource_tool_type type);
+
+/*! Invalidate the cached tool list, forcing a rescan on next acquire
+\param type Tool type */
+RESOURCE_API void
+resource_tool_refresh(resource_tool_type type);
+
+/*! Run an external tool job. The tool is given the job arguments followed by a
+"--" separator and the common arguments. If enabled in the module config and the
+tool declares worker in its manifest, the job is passed to a persistent worker process
+for the tool, falling back to a one-shot process if the worker fails to start. The
+number of concurrent jobs is limited by the tool process limit in the module config.
+The tool process is killed if the job exceeds the time limit of the tool or is cancelled.
+\param tool Tool
+\param job Job identifier used to cancel the job, 0 if not cancellable
+\param args Job arguments
+\param num_args Number of job arguments
+\param common Common arguments
+\param num_common Number of common arguments
+\return Tool exit code, -1 if tool could not be executed, RESOURCE_TOOL_EXIT_TIMEOUT if
+        time limit was exceeded or RESOURCE_TOOL_EXIT_CANCELLED if cancelled */
+RESOURCE_API int
+resource_tool_execute(const resource_tool_t* tool, hash_t job, const string_const_t* args,
+                      size_t num_args, const string_const_t* common, size_t num_common);
+
+/*! Cancel all running external tool jobs with the given job identifier by killing
+the tool processes
+\param job Job identifier
+\return true if any job was cancelled, false if not */
+RESOURCE_API bool
+resource_tool_cancel(hash_t job);
+
+/*! Handle foundation events from fs_event_stream event stream.
+No other event types should be passed to this function.
+\param event Foundation event */
+RESOURCE_API void
+resource_tool_event_handle(event_t* event);
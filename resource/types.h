@@ -37,9 +37,127 @@ typedef enum resource_event_id {
 	RESOURCEEVENT_DELETE,
 	/*! Resource was successfully compiled */
 	RESOURCEEVENT_COMPILE,
+	/*! Asynchronous open request completed */
+	RESOURCEEVENT_OPEN,
 	RESOURCEEVENT_LAST_RESERVED = 32
 } resource_event_id;
 
+typedef enum resource_schedule_state {
+	/*! Node has not been processed */
+	RESOURCESCHEDULE_PENDING = 0,
+	/*! Node was up to date */
+	RESOURCESCHEDULE_UPTODATE,
+	/*! Node was successfully compiled */
+	RESOURCESCHEDULE_COMPILED,
+	/*! Node failed to compile */
+	RESOURCESCHEDULE_FAILED,
+	/*! Node was skipped since a dependency failed */
+	RESOURCESCHEDULE_SKIPPED,
+	/*! Node is part of or depends on a dependency cycle */
+	RESOURCESCHEDULE_CYCLE
+} resource_schedule_state;
+
+typedef enum resource_tool_type {
+	/*! External import tools */
+	RESOURCETOOL_IMPORT = 0,
+	/*! External compile tools */
+	RESOURCETOOL_COMPILE,
+	RESOURCETOOL_COUNT
+} resource_tool_type;
+
+typedef enum resource_async_state {
+	/*! Request is queued */
+	RESOURCEASYNC_PENDING = 0,
+	/*! Request is being processed */
+	RESOURCEASYNC_RUNNING,
+	/*! Request completed with an open stream */
+	RESOURCEASYNC_COMPLETED,
+	/*! Request completed without being able to open a stream */
+	RESOURCEASYNC_FAILED,
+	/*! Request was cancelled */
+	RESOURCEASYNC_CANCELLED
+} resource_async_state;
+
+typedef enum resource_failure_type {
+	/*! Failed compile of resource and platform */
+	RESOURCEFAILURE_COMPILE = 0,
+	/*! Failed import of source file */
+	RESOURCEFAILURE_IMPORT,
+	RESOURCEFAILURE_COUNT
+} resource_failure_type;
+
+typedef enum resource_metric_phase {
+	/*! Checking if a resource needs update */
+	RESOURCEMETRIC_NEED_UPDATE = 0,
+	/*! Fetching compiled output from compile cache */
+	RESOURCEMETRIC_CACHE,
+	/*! Reading resource source */
+	RESOURCEMETRIC_SOURCE_READ,
+	/*! Collapsing resource source history */
+	RESOURCEMETRIC_COLLAPSE,
+	/*! Running in-process compilers */
+	RESOURCEMETRIC_INTERNAL,
+	/*! Running external compiler tools, including tool startup */
+	RESOURCEMETRIC_EXTERNAL,
+	RESOURCEMETRIC_PHASE_COUNT
+} resource_metric_phase;
+
+typedef enum resource_metric_counter {
+	/*! Compiled output fetched from compile cache */
+	RESOURCEMETRIC_CACHE_HIT = 0,
+	/*! Compiled output not found in compile cache */
+	RESOURCEMETRIC_CACHE_MISS,
+	/*! Resource compiled successfully */
+	RESOURCEMETRIC_COMPILED,
+	/*! Resource failed to compile */
+	RESOURCEMETRIC_FAILED,
+	/*! Compile skipped since it failed before with unchanged inputs */
+	RESOURCEMETRIC_FAILURE_SKIPPED,
+	/*! Resource was up to date */
+	RESOURCEMETRIC_UP_TO_DATE,
+	/*! Resource needed update */
+	RESOURCEMETRIC_OUT_OF_DATE,
+	RESOURCEMETRIC_COUNTER_COUNT
+} resource_metric_counter;
+
+typedef enum resource_compile_priority {
+	/*! Speculative background compile */
+	RESOURCECOMPILE_PRIORITY_SPECULATIVE = 0,
+	/*! Batch build compile */
+	RESOURCECOMPILE_PRIORITY_BATCH = 100,
+	/*! Compile needed by a stream open or a remote client request */
+	RESOURCECOMPILE_PRIORITY_REQUESTED = 200,
+	/*! Compile needed immediately */
+	RESOURCECOMPILE_PRIORITY_URGENT = 300
+} resource_compile_priority;
+
+typedef enum resource_hash_algorithm {
+	/*! SHA-256 */
+	RESOURCEHASH_SHA256 = 0,
+	/*! Fast non-cryptographic 256-bit hash, only suitable for change detection */
+	RESOURCEHASH_FAST
+} resource_hash_algorithm;
+
+//! Tool exit code for a job killed since it exceeded its time limit
+#define RESOURCE_TOOL_EXIT_TIMEOUT (-2)
+//! Tool exit code for a job killed since it was cancelled
+#define RESOURCE_TOOL_EXIT_CANCELLED (-3)
+
+//! Number of buckets in metric histograms
+#define RESOURCE_METRIC_BUCKETS 24
+
+//! Number of slowest compiles kept in build results
+#define RESOURCE_BUILD_SLOWEST 10
+
+//! Maximum number of leading magic bytes in an import format declaration
+#define RESOURCE_IMPORT_MAGIC_MAX 16
+
+//! Number of bytes buffered by an incremental content digest
+#define RESOURCE_DIGEST_BLOCK_SIZE 1024
+
+//! Maximum number of files hashed in one file hash cache batch
+#define RESOURCE_HASHCACHE_BATCH_MAX 8
+
 #define RESOURCE_SOURCEFLAG_UNSET 0
 #define RESOURCE_SOURCEFLAG_VALUE 1
 #define RESOURCE_SOURCEFLAG_BLOB 2
@@ -57,6 +175,23 @@ typedef struct resource_platform_t resource_platform_t;
 typedef struct resource_header_t resource_header_t;
 typedef struct resource_signature_t resource_signature_t;
 typedef struct resource_dependency_t resource_dependency_t;
+typedef struct resource_schedule_t resource_schedule_t;
+typedef struct resource_compile_session_t resource_compile_session_t;
+typedef struct resource_schedule_node_t resource_schedule_node_t;
+typedef struct resource_cache_statistics_t resource_cache_statistics_t;
+typedef struct resource_tool_t resource_tool_t;
+typedef struct resource_import_magic_t resource_import_magic_t;
+typedef struct resource_async_t resource_async_t;
+typedef struct resource_compile_queue_statistics_t resource_compile_queue_statistics_t;
+typedef struct resource_metric_histogram_t resource_metric_histogram_t;
+typedef struct resource_build_compile_t resource_build_compile_t;
+typedef struct resource_build_result_t resource_build_result_t;
+typedef struct resource_tool_list_t resource_tool_list_t;
+typedef struct resource_hashcache_statistics_t resource_hashcache_statistics_t;
+typedef struct resource_import_result_t resource_import_result_t;
+typedef struct resource_import_prune_result_t resource_import_prune_result_t;
+typedef struct resource_autoimport_statistics_t resource_autoimport_statistics_t;
+typedef struct resource_digest_t resource_digest_t;
 
 typedef int (*resource_import_fn)(stream_t*, const uuid_t);
 typedef int (*resource_compile_fn)(const uuid_t, uint64_t, resource_source_t*, const uint256_t,
@@ -64,6 +199,8 @@ typedef int (*resource_compile_fn)(const uuid_t, uint64_t, resource_source_t*, c
 typedef resource_change_t* (*resource_source_map_reduce_fn)(resource_change_t*, resource_change_t*,
                                                             void*);
 typedef int (*resource_source_map_iterate_fn)(resource_change_t*, void*);
+typedef int (*resource_worker_fn)(const string_const_t*, size_t);
+typedef void (*resource_async_fn)(resource_async_t*, void*);
 
 /*! Resource library configuration */
 struct resource_config_t {
@@ -77,6 +214,39 @@ struct resource_config_t {
 	bool enable_local_cache;
 	/*! Enable use of remote compile daemon for managing compiled resources and bundles */
 	bool enable_remote_compiled;
+	/*! Maximum number of concurrently running external tool processes,
+	0 for default (number of hardware threads) */
+	size_t tool_process_limit;
+	/*! Wall clock time limit in milliseconds for an external tool job, after which the
+	tool process is killed. Tools can override with a limit in the tool manifest.
+	0 for no limit */
+	unsigned int tool_time_limit;
+	/*! Enable use of persistent external tool worker processes for tools declaring
+	worker in their manifest, other tools run as one process per job */
+	bool enable_tool_workers;
+	/*! Number of threads processing asynchronous open requests,
+	0 for default (half the number of hardware threads) */
+	size_t async_thread_count;
+	/*! Number of threads processing the prioritized compile queue,
+	0 to disable the queue and compile on the requesting thread */
+	size_t compile_queue_thread_count;
+	/*! Time in milliseconds without new events for a modified resource before
+	it is speculatively recompiled, 0 for default (250ms) */
+	unsigned int speculative_compile_delay;
+	/*! Enable collection of compile pipeline metrics */
+	bool enable_metrics;
+	/*! Maximum size in bytes of the compile cache, 0 for default (4GiB) */
+	uint64_t compile_cache_limit;
+	/*! Time in milliseconds without new file system events for an asset file before
+	it is checked for autoimport, 0 for default (100ms) */
+	unsigned int autoimport_event_delay;
+	/*! Number of background threads checking modified asset files and reimporting
+	resources requested when opening streams, 0 to do this work on the calling thread */
+	size_t autoimport_thread_count;
+	/*! Hash algorithm for content change detection of imported asset files and resource
+	sources, RESOURCEHASH_SHA256 (default) or RESOURCEHASH_FAST. Changing the algorithm
+	causes all assets to be reimported and all resources to be recompiled once */
+	resource_hash_algorithm content_hash;
 };
 
 /*! Decomposed platform specification */
@@ -103,6 +273,198 @@ struct resource_dependency_t {
 	uint64_t platform;
 };
 
+/*! Compile schedule node for a resource */
+struct resource_schedule_node_t {
+	//! Resource UUID
+	uuid_t uuid;
+	//! Resource platform
+	uint64_t platform;
+	//! Resulting state
+	resource_schedule_state state;
+	//! Index of worker thread that processed the node
+	unsigned int worker;
+	//! Number of dependencies
+	size_t num_dependencies;
+	//! Timestamp when processing started
+	tick_t start;
+	//! Timestamp when the need update check ended
+	tick_t checked;
+	//! Timestamp when processing ended
+	tick_t end;
+};
+
+/*! Compile cache statistics */
+struct resource_cache_statistics_t {
+	//! Number of compiles satisfied from the cache
+	uint64_t hits;
+	//! Number of cache lookups not found in the cache
+	uint64_t misses;
+	//! Number of compiled resources stored in the cache
+	uint64_t stores;
+	//! Number of cached entries evicted
+	uint64_t evictions;
+	//! Current total size in bytes of cached entries
+	uint64_t size;
+};
+
+/*! Discovered external tool */
+/*! Leading magic bytes identifying an asset file format */
+struct resource_import_magic_t {
+	//! Magic bytes
+	uint8_t bytes[RESOURCE_IMPORT_MAGIC_MAX];
+	//! Number of magic bytes
+	size_t size;
+};
+
+struct resource_tool_t {
+	//! Full path of tool executable
+	string_t path;
+	//! Resource type hashes handled by tool as declared in tool manifest, null if any type
+	hash_t* types;
+	//! Hashes of lower case asset file extensions handled by import tool as declared in
+	//! tool manifest
+	hash_t* extensions;
+	//! Leading magic bytes of asset files handled by import tool as declared in tool manifest
+	resource_import_magic_t* magic;
+	//! Time limit in milliseconds as declared in tool manifest, 0 for module config limit
+	unsigned int time_limit;
+	//! Tool accepts multiple platform arguments in one invocation as declared in tool manifest
+	bool multiplatform;
+	//! Tool supports the persistent worker protocol as declared in tool manifest
+	bool worker;
+};
+
+/*! Snapshot of discovered external tools */
+struct resource_tool_list_t {
+	//! Reference count
+	atomic32_t ref;
+	//! Tools
+	resource_tool_t* tools;
+};
+
+/*! Compile queue statistics */
+struct resource_compile_queue_statistics_t {
+	//! Number of resources ready to compile
+	size_t queued;
+	//! Number of resources waiting for dependencies
+	size_t blocked;
+	//! Number of resources being compiled
+	size_t running;
+	//! Maximum number of queued, blocked and running resources seen
+	size_t max_depth;
+	//! Number of resources processed
+	uint64_t completed;
+	//! Average time from ready with all dependencies processed to processing started, in seconds
+	deltatime_t wait_average;
+	//! Maximum time from ready with all dependencies processed to processing started, in seconds
+	deltatime_t wait_max;
+};
+
+/*! Timing histogram of a compile pipeline phase */
+struct resource_metric_histogram_t {
+	//! Number of samples
+	uint64_t count;
+	//! Total time of all samples in seconds
+	deltatime_t total;
+	//! Shortest sample in seconds
+	deltatime_t min;
+	//! Longest sample in seconds
+	deltatime_t max;
+	//! Number of samples per bucket, bucket N holds samples shorter than 2^N microseconds
+	//! not in a lower bucket, the last bucket holds all longer samples
+	uint64_t buckets[RESOURCE_METRIC_BUCKETS];
+};
+
+/*! Compile of a single resource and platform in a batch build */
+struct resource_build_compile_t {
+	//! Resource UUID
+	uuid_t uuid;
+	//! Resource platform
+	uint64_t platform;
+	//! Time from compile started to done in seconds
+	deltatime_t time;
+	//! Compile result
+	bool success;
+};
+
+/*! Result of a batch build of all resources in the source path */
+struct resource_build_result_t {
+	//! Number of resources found in the source path
+	size_t resources;
+	//! Number of resource and platform combinations checked
+	size_t targets;
+	//! Number of targets up to date
+	size_t up_to_date;
+	//! Number of targets compiled successfully
+	size_t compiled;
+	//! Number of targets that failed to compile
+	size_t failed;
+	//! Time spent enumerating resources in seconds
+	deltatime_t enumerate_time;
+	//! Time spent checking if targets need update in seconds, summed over build threads
+	deltatime_t check_time;
+	//! Time spent compiling out of date targets in seconds, summed over build threads
+	deltatime_t compile_time;
+	//! Number of valid entries in slowest
+	size_t num_slowest;
+	//! Slowest compiles, slowest first
+	resource_build_compile_t slowest[RESOURCE_BUILD_SLOWEST];
+};
+
+/*! Result of importing a directory of asset files */
+struct resource_import_result_t {
+	//! Number of asset files found in the directory
+	size_t files;
+	//! Number of files already imported with unchanged content
+	size_t up_to_date;
+	//! Number of files imported successfully
+	size_t imported;
+	//! Number of files that failed to import
+	size_t failed;
+	//! Total size in bytes of imported files
+	uint64_t bytes;
+	//! Time spent enumerating files in seconds
+	deltatime_t enumerate_time;
+	//! Time spent checking and importing files in seconds
+	deltatime_t import_time;
+};
+
+/*! Result of pruning import maps */
+struct resource_import_prune_result_t {
+	//! Number of import maps found
+	size_t maps;
+	//! Number of entries checked in all import maps
+	size_t entries;
+	//! Number of entries removed for asset files that no longer exist
+	size_t pruned;
+	//! Number of import maps rewritten by compaction
+	size_t compacted;
+	//! Time spent in seconds
+	deltatime_t time;
+};
+
+/*! Autoimport file system event statistics */
+struct resource_autoimport_statistics_t {
+	//! Number of file modification events received for asset files in watched directories
+	uint64_t events;
+	//! Number of events dropped as duplicates of an event already pending for the file
+	uint64_t dropped;
+	//! Number of coalesced events processed after the quiet time
+	uint64_t processed;
+	//! Number of processed events where the asset file content had changed
+	uint64_t triggered;
+};
+
+/*! File content hash cache statistics */
+struct resource_hashcache_statistics_t {
+	//! Number of lookups where file metadata was unchanged and the hash was reused
+	uint64_t hits;
+	//! Number of lookups where the file content had to be hashed
+	uint64_t misses;
+	//! Number of cached entries
+	uint64_t entries;
+};
+
 /*! Representation of metadata for a binary data blob */
 struct resource_blob_t {
 	/*! Checksum */
@@ -190,6 +552,22 @@ struct resource_header_t {
 	uint256_t source_hash;
 };
 
+/*! Incremental content digest state */
+struct resource_digest_t {
+	//! Hash algorithm
+	resource_hash_algorithm algorithm;
+	//! SHA-256 state
+	sha256_t sha;
+	//! Fast hash lane accumulators
+	uint64_t acc[8];
+	//! Total number of bytes digested
+	uint64_t total;
+	//! Number of bytes in block buffer
+	size_t buffered;
+	//! Block buffer
+	uint8_t buffer[RESOURCE_DIGEST_BLOCK_SIZE];
+};
+
 /*! Signature for a resource source file */
 struct resource_signature_t {
 	/*! Resource UUID */
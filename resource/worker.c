@@ -0,0 +1,335 @@
+/* worker.c  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <resource/resource.h>
+#include <resource/internal.h>
+
+#include <foundation/foundation.h>
+
+#define RESOURCE_WORKER_READY "READY"
+#define RESOURCE_WORKER_DONE "DONE "
+
+typedef struct resource_worker_t resource_worker_t;
+typedef struct resource_worker_pool_t resource_worker_pool_t;
+
+struct resource_worker_t {
+	process_t process;
+	thread_t drain;
+	string_const_t name;
+};
+
+struct resource_worker_pool_t {
+	hash_t key;
+	string_t tool;
+	resource_worker_t** idle;
+	bool unsupported;
+};
+
+static mutex_t* _resource_worker_lock;
+static resource_worker_pool_t** _resource_worker_pools;
+
+int
+resource_worker_initialize(void) {
+	_resource_worker_lock = mutex_allocate(STRING_CONST("resource-worker"));
+	return 0;
+}
+
+void
+resource_worker_finalize(void) {
+	resource_worker_shutdown();
+	for (size_t ipool = 0, psize = array_size(_resource_worker_pools); ipool < psize; ++ipool) {
+		resource_worker_pool_t* pool = _resource_worker_pools[ipool];
+		array_deallocate(pool->idle);
+		string_deallocate(pool->tool.str);
+		memory_deallocate(pool);
+	}
+	array_deallocate(_resource_worker_pools);
+	mutex_deallocate(_resource_worker_lock);
+	_resource_worker_pools = nullptr;
+	_resource_worker_lock = nullptr;
+}
+
+bool
+resource_worker_requested(void) {
+	const string_const_t* cmdline = environment_command_line();
+	for (size_t iarg = 0, argsize = array_size(cmdline); iarg < argsize; ++iarg) {
+		if (string_equal(STRING_ARGS(cmdline[iarg]), STRING_CONST("--worker")))
+			return true;
+	}
+	return false;
+}
+
+int
+resource_worker_serve(resource_worker_fn job) {
+	char buffer[BUILD_MAX_PATHLEN * 2];
+	stream_t* in = stream_open_stdin();
+	stream_t* out = stream_open_stdout();
+
+	stream_write(out, STRING_CONST(RESOURCE_WORKER_READY));
+	stream_write_endl(out);
+	stream_flush(out);
+
+	while (!stream_eos(in)) {
+		string_t line = stream_read_line_buffer(in, buffer, sizeof(buffer), '\n');
+		if (line.length && (line.str[line.length - 1] == '\r'))
+			--line.length;
+		if (!line.length)
+			continue;
+
+		string_const_t args[64];
+		size_t numargs = string_explode(STRING_ARGS(line), STRING_CONST("\t"), args,
+		                                sizeof(args) / sizeof(args[0]), true);
+		int exit_code = job(args, numargs);
+
+		string_const_t reply = string_from_int_static(exit_code, 0, 0);
+		stream_write(out, STRING_CONST(RESOURCE_WORKER_DONE));
+		stream_write(out, STRING_ARGS(reply));
+		stream_write_endl(out);
+		stream_flush(out);
+	}
+
+	stream_deallocate(out);
+	stream_deallocate(in);
+
+	return 0;
+}
+
+static void*
+resource_worker_drain(void* arg) {
+	resource_worker_t* worker = arg;
+	char buffer[BUILD_MAX_PATHLEN];
+	stream_t* err = process_stderr(&worker->process);
+	while (!stream_eos(err)) {
+		string_t line = stream_read_line_buffer(err, buffer, sizeof(buffer), '\n');
+		if (line.length) {
+			if (line.str[line.length - 1] == '\r')
+				--line.length;
+			log_infof(HASH_RESOURCE, STRING_CONST("%.*s: %.*s"), STRING_FORMAT(worker->name),
+			          STRING_FORMAT(line));
+		}
+	}
+	return nullptr;
+}
+
+static void
+resource_worker_terminate(resource_worker_t* worker) {
+	// Closing stdin signals the worker to exit, kill it if it does not comply
+	stream_finalize(process_stdin(&worker->process));
+	int exit_code = process_wait(&worker->process);
+	for (int iwait = 0; (exit_code == PROCESS_STILL_ACTIVE) && (iwait < 100); ++iwait) {
+		thread_sleep(10);
+		exit_code = process_wait(&worker->process);
+	}
+	if (exit_code == PROCESS_STILL_ACTIVE) {
+		process_kill(&worker->process);
+		process_wait(&worker->process);
+	}
+	thread_join(&worker->drain);
+	thread_finalize(&worker->drain);
+	process_finalize(&worker->process);
+	memory_deallocate(worker);
+}
+
+static string_t
+resource_worker_read_reply(resource_worker_t* worker, char* buffer, size_t capacity,
+                           const char* prefix, size_t prefix_length) {
+	// Skip any regular output the tool writes to stdout until a protocol reply
+	stream_t* out = process_stdout(&worker->process);
+	while (!stream_eos(out)) {
+		string_t line = stream_read_line_buffer(out, buffer, capacity, '\n');
+		if (line.length && (line.str[line.length - 1] == '\r'))
+			--line.length;
+		if ((line.length >= prefix_length) &&
+		    string_equal(line.str, prefix_length, prefix, prefix_length))
+			return line;
+		if (line.length)
+			log_debugf(HASH_RESOURCE, STRING_CONST("%.*s: %.*s"), STRING_FORMAT(worker->name),
+			           STRING_FORMAT(line));
+	}
+	return string(buffer, 0);
+}
+
+static resource_worker_t*
+resource_worker_spawn(resource_worker_pool_t* pool, resource_tool_watch_t* watch,
+                      const string_const_t* common, size_t num_common) {
+	resource_worker_t* worker =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_worker_t), 0, MEMORY_PERSISTENT);
+	worker->name = path_file_name(STRING_ARGS(pool->tool));
+
+	process_initialize(&worker->process);
+
+	string_const_t wd = environment_current_working_directory();
+	process_set_working_directory(&worker->process, STRING_ARGS(wd));
+	process_set_executable_path(&worker->process, STRING_ARGS(pool->tool));
+
+	string_const_t* args = nullptr;
+	array_push(args, string_const(STRING_CONST("--worker")));
+	array_push(args, string_const(STRING_CONST("--")));
+	for (size_t iarg = 0; iarg < num_common; ++iarg)
+		array_push(args, common[iarg]);
+
+	process_set_arguments(&worker->process, args, array_size(args));
+	process_set_flags(&worker->process, PROCESS_STDSTREAMS | PROCESS_DETACHED);
+	int spawned = process_spawn(&worker->process);
+	array_deallocate(args);
+
+	if (spawned != 0) {
+		process_finalize(&worker->process);
+		memory_deallocate(worker);
+		return nullptr;
+	}
+
+	// Cancelled or timed out while spawning, the startup handshake then fails
+	if (!resource_tool_watch_attach(watch, &worker->process))
+		process_kill(&worker->process);
+
+	thread_initialize(&worker->drain, resource_worker_drain, worker,
+	                  STRING_CONST("resource-worker-drain"), THREAD_PRIORITY_NORMAL, 0);
+	thread_start(&worker->drain);
+
+	// Tools not supporting the protocol exit or reply with something else
+	char buffer[BUILD_MAX_PATHLEN];
+	string_t line = resource_worker_read_reply(worker, buffer, sizeof(buffer),
+	                                           STRING_CONST(RESOURCE_WORKER_READY));
+	if (!line.length) {
+		resource_tool_watch_detach(watch);
+		if (!resource_tool_watch_result(watch))
+			log_debugf(HASH_RESOURCE, STRING_CONST("Tool does not support worker protocol: %.*s"),
+			           STRING_FORMAT(pool->tool));
+		resource_worker_terminate(worker);
+		return nullptr;
+	}
+
+	log_debugf(HASH_RESOURCE, STRING_CONST("Started tool worker: %.*s"), STRING_FORMAT(pool->tool));
+	return worker;
+}
+
+static resource_worker_pool_t*
+resource_worker_pool(const string_t tool, const string_const_t* common, size_t num_common) {
+	// Workers are started with the common arguments, so they are part of the pool identity
+	hash_t key = hash(STRING_ARGS(tool));
+	for (size_t iarg = 0; iarg < num_common; ++iarg)
+		key ^= hash(STRING_ARGS(common[iarg])) + (hash_t)iarg;
+
+	for (size_t ipool = 0, psize = array_size(_resource_worker_pools); ipool < psize; ++ipool) {
+		resource_worker_pool_t* pool = _resource_worker_pools[ipool];
+		if ((pool->key == key) && string_equal(STRING_ARGS(pool->tool), STRING_ARGS(tool)))
+			return pool;
+	}
+
+	resource_worker_pool_t* pool =
+	    memory_allocate(HASH_RESOURCE, sizeof(resource_worker_pool_t), 0, MEMORY_PERSISTENT);
+	pool->key = key;
+	pool->tool = string_clone(STRING_ARGS(tool));
+	pool->idle = nullptr;
+	pool->unsupported = false;
+	array_push(_resource_worker_pools, pool);
+	return pool;
+}
+
+bool
+resource_worker_execute(const string_t tool, resource_tool_watch_t* watch,
+                        const string_const_t* args, size_t num_args,
+                        const string_const_t* common, size_t num_common, int* exit_code) {
+	char buffer[BUILD_MAX_PATHLEN * 2];
+	string_t line = string(buffer, 0);
+	for (size_t iarg = 0; iarg < num_args; ++iarg) {
+		// Arguments that cannot be framed on a single line must use a one-shot process
+		if ((string_find_first_of(STRING_ARGS(args[iarg]), STRING_CONST("\t\r\n"), 0) !=
+		     STRING_NPOS))
+			return false;
+		if (iarg)
+			line = string_append(STRING_ARGS(line), sizeof(buffer), STRING_CONST("\t"));
+		line = string_append(STRING_ARGS(line), sizeof(buffer), STRING_ARGS(args[iarg]));
+	}
+
+	mutex_lock(_resource_worker_lock);
+	resource_worker_pool_t* pool = resource_worker_pool(tool, common, num_common);
+	if (pool->unsupported) {
+		mutex_unlock(_resource_worker_lock);
+		return false;
+	}
+	resource_worker_t* worker = nullptr;
+	if (array_size(pool->idle)) {
+		worker = pool->idle[array_size(pool->idle) - 1];
+		array_pop(pool->idle);
+	}
+	mutex_unlock(_resource_worker_lock);
+
+	if (!worker) {
+		worker = resource_worker_spawn(pool, watch, common, num_common);
+		if (!worker) {
+			// A worker killed during startup says nothing about protocol support
+			if (!resource_tool_watch_result(watch)) {
+				mutex_lock(_resource_worker_lock);
+				pool->unsupported = true;
+				mutex_unlock(_resource_worker_lock);
+			}
+			return false;
+		}
+	} else if (!resource_tool_watch_attach(watch, &worker->process)) {
+		// Cancelled or timed out before the job was sent, the worker stays usable
+		mutex_lock(_resource_worker_lock);
+		array_push(pool->idle, worker);
+		mutex_unlock(_resource_worker_lock);
+		return false;
+	}
+
+	stream_t* in = process_stdin(&worker->process);
+	stream_write(in, STRING_ARGS(line));
+	stream_write_endl(in);
+	stream_flush(in);
+
+	string_t reply = resource_worker_read_reply(worker, buffer, sizeof(buffer),
+	                                            STRING_CONST(RESOURCE_WORKER_DONE));
+	resource_tool_watch_detach(watch);
+	if (!reply.length) {
+		if (!resource_tool_watch_result(watch))
+			log_warnf(HASH_RESOURCE, WARNING_RESOURCE, STRING_CONST("Tool worker failed: %.*s"),
+			          STRING_FORMAT(tool));
+		resource_worker_terminate(worker);
+		return false;
+	}
+
+	*exit_code = string_to_int(reply.str + (sizeof(RESOURCE_WORKER_DONE) - 1),
+	                           reply.length - (sizeof(RESOURCE_WORKER_DONE) - 1));
+
+	mutex_lock(_resource_worker_lock);
+	array_push(pool->idle, worker);
+	mutex_unlock(_resource_worker_lock);
+
+	return true;
+}
+
+void
+resource_worker_shutdown(void) {
+	resource_worker_t** workers = nullptr;
+	mutex_lock(_resource_worker_lock);
+	for (size_t ipool = 0, psize = array_size(_resource_worker_pools); ipool < psize; ++ipool) {
+		resource_worker_pool_t* pool = _resource_worker_pools[ipool];
+		for (size_t iworker = 0, wsize = array_size(pool->idle); iworker < wsize; ++iworker)
+			array_push(workers, pool->idle[iworker]);
+		array_clear(pool->idle);
+	}
+	mutex_unlock(_resource_worker_lock);
+
+	for (size_t iworker = 0, wsize = array_size(workers); iworker < wsize; ++iworker)
+		resource_worker_terminate(workers[iworker]);
+	array_deallocate(workers);
+}
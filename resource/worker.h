@@ -0,0 +1,43 @@
+/* worker.h  -  Resource library  -  Public Domain  -  2014 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform resource I/O library in C11 providing
+ * basic resource loading, saving and streaming functionality for projects based
+ * on our foundation library.
+ *
+ * The latest source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/resource_lib
+ *
+ * The foundation library source code maintained by Rampant Pixels is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#pragma once
+
+#include <foundation/platform.h>
+
+#include <resource/types.h>
+
+/*! Check if the process was started as a persistent tool worker, i.e. with
+the --worker command line flag
+\return true if started as worker, false if not */
+RESOURCE_API bool
+resource_worker_requested(void);
+
+/*! Serve jobs as a persistent tool worker. Signals readiness to the library on
+stdout, then reads one job per line from stdin with arguments separated by tabs,
+calls the job function and replies with the job exit code. Returns when stdin
+is closed. The library only starts tools as workers if they declare worker in the
+tool manifest.
+\param job Job function, receiving the job arguments and returning exit code
+\return 0 on clean shutdown */
+RESOURCE_API int
+resource_worker_serve(resource_worker_fn job);
+
+/*! Terminate all idle worker processes */
+RESOURCE_API void
+resource_worker_shutdown(void);
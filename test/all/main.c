@@ -197,6 +197,7 @@ main_initialize(void) {
 
 #if BUILD_MONOLITHIC
 extern int test_source_run(void);
+extern int test_import_run(void);
 typedef int (*test_run_fn)(void);
 
 static void*
@@ -280,6 +281,7 @@ main_run(void* main_arg) {
 
 	test_run_fn tests[] = {
 		test_source_run,
+		test_import_run,
 		0
 	};
 
@@ -0,0 +1,850 @@
+/* main.c  -  Resource import test  -  Public Domain  -  2013 Mattias Jansson / Rampant Pixels
+ *
+ * This library provides a cross-platform foundation library in C11 providing basic support
+ * data types and functions to write applications and games in a platform-independent fashion.
+ * The latest source code is always available at
+ *
+ * https://github.com/rampantpixels/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without
+ * any restrictions.
+ */
+
+#include <foundation/foundation.h>
+#include <resource/resource.h>
+#include <test/test.h>
+
+static application_t
+test_import_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Resource import tests"));
+	app.short_name = string_const(STRING_CONST("test_import"));
+	app.company = string_const(STRING_CONST("Rampant Pixels"));
+	app.flags = APPLICATION_UTILITY;
+	app.exception_handler = test_exception_handler;
+	return app;
+}
+
+static memory_system_t
+test_import_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_import_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_import_initialize(void) {
+	resource_config_t config;
+	memset(&config, 0, sizeof(config));
+	config.enable_local_source = true;
+	config.enable_local_cache = true;
+	config.enable_local_autoimport = true;
+	return resource_module_initialize(config);
+}
+
+static void
+test_import_finalize(void) {
+	resource_module_finalize();
+}
+
+static void
+test_import_event(event_t* event) {
+	resource_event_handle(event);
+}
+
+static string_t
+test_import_asset_path(char* buffer, size_t capacity, string_const_t dir, size_t index) {
+	return string_format(buffer, capacity, STRING_CONST("%.*s/asset%" PRIsize ".data"),
+	                     STRING_FORMAT(dir), index);
+}
+
+DECLARE_TEST(import, map) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	const size_t num_assets = 1000;
+	uuid_t uuids[1000];
+	size_t iasset;
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_map"));
+	fs_make_directory(STRING_ARGS(dir));
+
+	for (iasset = 0; iasset < num_assets; ++iasset) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		uuids[iasset] = uuid_generate_random();
+		uuid_t stored = resource_import_map_store(STRING_ARGS(path), uuids[iasset],
+		                                          uint256_make(iasset, 1, 2, 3));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+		EXPECT_TRUE(uuid_equal(stored, uuids[iasset]));
+#else
+		FOUNDATION_UNUSED(stored);
+#endif
+	}
+
+	//Storing an existing path keeps the uuid and updates the signature hash
+	string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir), 0);
+	uuid_t stored = resource_import_map_store(STRING_ARGS(path), uuid_generate_random(),
+	                                          uint256_make(42, 1, 2, 3));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	EXPECT_TRUE(uuid_equal(stored, uuids[0]));
+#else
+	FOUNDATION_UNUSED(stored);
+#endif
+
+	for (iasset = 0; iasset < num_assets; ++iasset) {
+		path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir), iasset);
+		resource_signature_t sig = resource_import_lookup(STRING_ARGS(path));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+		EXPECT_TRUE(uuid_equal(sig.uuid, uuids[iasset]));
+		EXPECT_TRUE(uint256_equal(sig.hash, uint256_make(iasset ? iasset : 42, 1, 2, 3)));
+#else
+		FOUNDATION_UNUSED(sig);
+#endif
+	}
+
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+#define TEST_IMPORT_MAP_THREADS 4
+#define TEST_IMPORT_MAP_ASSETS 250
+
+typedef struct test_import_map_job_t test_import_map_job_t;
+
+struct test_import_map_job_t {
+	string_const_t dir;
+	size_t first;
+	uuid_t uuids[TEST_IMPORT_MAP_ASSETS];
+};
+
+static void*
+test_import_map_thread(void* arg) {
+	char buffer[BUILD_MAX_PATHLEN];
+	test_import_map_job_t* job = arg;
+	for (size_t iasset = 0; iasset < TEST_IMPORT_MAP_ASSETS; ++iasset) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), job->dir,
+		                                       job->first + iasset);
+		job->uuids[iasset] = uuid_generate_random();
+		resource_import_map_store(STRING_ARGS(path), job->uuids[iasset],
+		                          uint256_make(job->first + iasset, 0, 0, 0));
+	}
+	//Every fourth entry is purged while other threads store into the same map
+	for (size_t iasset = 0; iasset < TEST_IMPORT_MAP_ASSETS; iasset += 4) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), job->dir,
+		                                       job->first + iasset);
+		resource_import_map_purge(STRING_ARGS(path));
+	}
+	return nullptr;
+}
+
+DECLARE_TEST(import, map_concurrent) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[2][BUILD_MAX_PATHLEN];
+	string_t dir[2];
+	thread_t threads[TEST_IMPORT_MAP_THREADS];
+	test_import_map_job_t* jobs;
+	size_t ithread, iasset;
+
+	//Two threads per map, two maps updated in parallel
+	string_const_t tmp = environment_temporary_directory();
+	dir[0] = path_concat(dirbuffer[0], sizeof(dirbuffer[0]), STRING_ARGS(tmp),
+	                     STRING_CONST("import_map_concurrent_a"));
+	dir[1] = path_concat(dirbuffer[1], sizeof(dirbuffer[1]), STRING_ARGS(tmp),
+	                     STRING_CONST("import_map_concurrent_b"));
+	fs_make_directory(STRING_ARGS(dir[0]));
+	fs_make_directory(STRING_ARGS(dir[1]));
+
+	jobs = memory_allocate(HASH_TEST, sizeof(test_import_map_job_t) * TEST_IMPORT_MAP_THREADS, 0,
+	                       MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	for (ithread = 0; ithread < TEST_IMPORT_MAP_THREADS; ++ithread) {
+		jobs[ithread].dir = string_to_const(dir[ithread % 2]);
+		jobs[ithread].first = ithread * TEST_IMPORT_MAP_ASSETS;
+		thread_initialize(threads + ithread, test_import_map_thread, jobs + ithread,
+		                  STRING_CONST("import-map"), THREAD_PRIORITY_NORMAL, 0);
+	}
+	for (ithread = 0; ithread < TEST_IMPORT_MAP_THREADS; ++ithread)
+		thread_start(threads + ithread);
+	for (ithread = 0; ithread < TEST_IMPORT_MAP_THREADS; ++ithread) {
+		thread_join(threads + ithread);
+		thread_finalize(threads + ithread);
+	}
+
+	for (ithread = 0; ithread < TEST_IMPORT_MAP_THREADS; ++ithread) {
+		for (iasset = 0; iasset < TEST_IMPORT_MAP_ASSETS; ++iasset) {
+			string_t path = test_import_asset_path(buffer, sizeof(buffer), jobs[ithread].dir,
+			                                       jobs[ithread].first + iasset);
+			resource_signature_t sig = resource_import_lookup(STRING_ARGS(path));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+			if (iasset % 4) {
+				EXPECT_TRUE(uuid_equal(sig.uuid, jobs[ithread].uuids[iasset]));
+				EXPECT_TRUE(uint256_equal(
+				    sig.hash, uint256_make(jobs[ithread].first + iasset, 0, 0, 0)));
+			} else {
+				EXPECT_TRUE(uuid_is_null(sig.uuid));
+			}
+#else
+			FOUNDATION_UNUSED(sig);
+#endif
+		}
+	}
+
+	memory_deallocate(jobs);
+	fs_remove_directory(STRING_ARGS(dir[0]));
+	fs_remove_directory(STRING_ARGS(dir[1]));
+
+	return 0;
+}
+
+DECLARE_TEST(import, convert) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	char mapbuffer[BUILD_MAX_PATHLEN];
+	char separator = ' ';
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_convert"));
+	fs_make_directory(STRING_ARGS(dir));
+
+	//Write import map in text format
+	uuid_t uuid = uuid_generate_random();
+	uint256_t sighash = uint256_make(1, 2, 3, 4);
+	string_t mappath = path_concat(mapbuffer, sizeof(mapbuffer), STRING_ARGS(dir),
+	                               STRING_CONST(RESOURCE_IMPORT_MAP));
+	stream_t* stream = stream_open(STRING_ARGS(mappath), STREAM_OUT | STREAM_CREATE);
+	EXPECT_PTRNE(stream, nullptr);
+	string_const_t token = string_from_uint_static(hash(STRING_CONST("asset.data")), true, 16, '0');
+	stream_write(stream, STRING_ARGS(token));
+	stream_write(stream, &separator, 1);
+	token = string_from_uuid_static(uuid);
+	stream_write(stream, STRING_ARGS(token));
+	stream_write(stream, &separator, 1);
+	token = string_from_uint256_static(sighash);
+	stream_write(stream, STRING_ARGS(token));
+	stream_write(stream, &separator, 1);
+	stream_write(stream, STRING_CONST("asset.data"));
+	stream_write_endl(stream);
+	stream_deallocate(stream);
+	size_t textsize = fs_size(STRING_ARGS(mappath));
+
+	string_t path = path_concat(buffer, sizeof(buffer), STRING_ARGS(dir),
+	                            STRING_CONST("asset.data"));
+	resource_signature_t sig = resource_import_lookup(STRING_ARGS(path));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	EXPECT_TRUE(uuid_equal(sig.uuid, uuid));
+	EXPECT_TRUE(uint256_equal(sig.hash, sighash));
+
+	//Lookups read the text map in place, only a store converts the file
+	EXPECT_SIZEEQ(fs_size(STRING_ARGS(mappath)), textsize);
+	char otherbuffer[BUILD_MAX_PATHLEN];
+	string_t otherpath = path_concat(otherbuffer, sizeof(otherbuffer), STRING_ARGS(dir),
+	                                 STRING_CONST("other.data"));
+	uuid_t otheruuid = uuid_generate_random();
+	EXPECT_TRUE(uuid_equal(resource_import_map_store(STRING_ARGS(otherpath), otheruuid,
+	                                                 uint256_make(5, 6, 7, 8)),
+	                       otheruuid));
+	EXPECT_TRUE(fs_size(STRING_ARGS(mappath)) != textsize);
+
+	//Lookup again from converted map
+	sig = resource_import_lookup(STRING_ARGS(path));
+	EXPECT_TRUE(uuid_equal(sig.uuid, uuid));
+	EXPECT_TRUE(uint256_equal(sig.hash, sighash));
+	sig = resource_import_lookup(STRING_ARGS(otherpath));
+	EXPECT_TRUE(uuid_equal(sig.uuid, otheruuid));
+#else
+	FOUNDATION_UNUSED(sig);
+	FOUNDATION_UNUSED(textsize);
+#endif
+
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+DECLARE_TEST(import, hashcache) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	char cachebuffer[BUILD_MAX_PATHLEN];
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_hashcache"));
+	fs_make_directory(STRING_ARGS(dir));
+	string_t cachepath = path_concat(cachebuffer, sizeof(cachebuffer), STRING_ARGS(dir),
+	                                 STRING_CONST("filehash.cache"));
+	resource_hashcache_set_path(STRING_ARGS(cachepath));
+
+	string_t path = path_concat(buffer, sizeof(buffer), STRING_ARGS(dir),
+	                            STRING_CONST("asset.data"));
+	stream_t* stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE);
+	EXPECT_PTRNE(stream, nullptr);
+	stream_write(stream, STRING_CONST("first asset content"));
+	stream_deallocate(stream);
+
+	stream = stream_open(STRING_ARGS(path), STREAM_IN);
+	uint256_t first = stream_sha256(stream);
+	stream_deallocate(stream);
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	//Entry hashed right after the file was written is racily clean and never trusted
+	resource_hashcache_statistics_t before = resource_hashcache_statistics();
+	EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(path)), first));
+	EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(path)), first));
+	resource_hashcache_statistics_t after = resource_hashcache_statistics();
+	EXPECT_UINTEQ(after.misses - before.misses, 2);
+	EXPECT_UINTEQ(after.hits - before.hits, 0);
+
+	//Rewrite with same size, metadata can be unchanged within the timestamp granularity
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_TRUNCATE);
+	stream_write(stream, STRING_CONST("other asset content"));
+	stream_deallocate(stream);
+	stream = stream_open(STRING_ARGS(path), STREAM_IN);
+	uint256_t same_size = stream_sha256(stream);
+	stream_deallocate(stream);
+	EXPECT_FALSE(uint256_equal(first, same_size));
+	EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(path)), same_size));
+
+	//Once the modification is older than the racy window the entry is trusted
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_TRUNCATE);
+	stream_write(stream, STRING_CONST("first asset content"));
+	stream_deallocate(stream);
+	thread_sleep(2100);
+	before = resource_hashcache_statistics();
+	EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(path)), first));
+	EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(path)), first));
+	after = resource_hashcache_statistics();
+	EXPECT_UINTEQ(after.misses - before.misses, 1);
+	EXPECT_UINTEQ(after.hits - before.hits, 1);
+
+	//Persist and reload, hash should be reused
+	resource_hashcache_flush();
+	EXPECT_TRUE(fs_is_file(STRING_ARGS(cachepath)));
+	resource_hashcache_set_path(STRING_ARGS(cachepath));
+	before = resource_hashcache_statistics();
+	EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(path)), first));
+	after = resource_hashcache_statistics();
+	EXPECT_UINTEQ(after.hits - before.hits, 1);
+
+	//Modified content must be hashed again
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_TRUNCATE);
+	stream_write(stream, STRING_CONST("second and longer asset content"));
+	stream_deallocate(stream);
+	stream = stream_open(STRING_ARGS(path), STREAM_IN);
+	uint256_t second = stream_sha256(stream);
+	stream_deallocate(stream);
+	EXPECT_FALSE(uint256_equal(first, second));
+	EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(path)), second));
+#else
+	FOUNDATION_UNUSED(first);
+#endif
+
+	resource_hashcache_set_path(STRING_CONST(""));
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+static int test_import_order[8];
+static size_t test_import_calls;
+
+static int
+test_import_magic(stream_t* stream, const uuid_t uuid) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(uuid);
+	if (test_import_calls < 8)
+		test_import_order[test_import_calls++] = 1;
+	return -1;
+}
+
+static int
+test_import_extension(stream_t* stream, const uuid_t uuid) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(uuid);
+	if (test_import_calls < 8)
+		test_import_order[test_import_calls++] = 2;
+	return -1;
+}
+
+static int
+test_import_probe(stream_t* stream, const uuid_t uuid) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(uuid);
+	if (test_import_calls < 8)
+		test_import_order[test_import_calls++] = 3;
+	return -1;
+}
+
+DECLARE_TEST(import, format) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	const uint8_t magic[] = {0x89, 'P', 'N', 'G'};
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_format"));
+	fs_make_directory(STRING_ARGS(dir));
+
+	resource_import_register(test_import_probe);
+	resource_import_register_format(test_import_extension, STRING_CONST("data,bin"), nullptr, 0);
+	resource_import_register_format(test_import_magic, STRING_CONST("png"), magic,
+	                                sizeof(magic));
+
+	//Magic match first, then extension match, then undeclared importers
+	string_t path = path_concat(buffer, sizeof(buffer), STRING_ARGS(dir),
+	                            STRING_CONST("image.DATA"));
+	stream_t* stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE);
+	EXPECT_PTRNE(stream, nullptr);
+	stream_write(stream, magic, sizeof(magic));
+	stream_write(stream, STRING_CONST("image data"));
+	stream_deallocate(stream);
+
+	test_import_calls = 0;
+	EXPECT_FALSE(resource_import(STRING_ARGS(path), uuid_generate_random()));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	EXPECT_SIZEEQ(test_import_calls, 3);
+	EXPECT_INTEQ(test_import_order[0], 1);
+	EXPECT_INTEQ(test_import_order[1], 2);
+	EXPECT_INTEQ(test_import_order[2], 3);
+#endif
+
+	//Unknown format only probes undeclared importers
+	path = path_concat(buffer, sizeof(buffer), STRING_ARGS(dir), STRING_CONST("notes.txt"));
+	stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE);
+	EXPECT_PTRNE(stream, nullptr);
+	stream_write(stream, STRING_CONST("plain text"));
+	stream_deallocate(stream);
+
+	test_import_calls = 0;
+	EXPECT_FALSE(resource_import(STRING_ARGS(path), uuid_generate_random()));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	EXPECT_SIZEEQ(test_import_calls, 1);
+	EXPECT_INTEQ(test_import_order[0], 3);
+#endif
+
+	resource_import_unregister(test_import_magic);
+	resource_import_unregister(test_import_extension);
+	resource_import_unregister(test_import_probe);
+	resource_failure_clear();
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+DECLARE_TEST(import, reverse_lookup) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	char lookupbuffer[BUILD_MAX_PATHLEN];
+	uuid_t uuids[256];
+	const size_t num_assets = sizeof(uuids) / sizeof(uuids[0]);
+	size_t iasset;
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_reverse"));
+	fs_make_directory(STRING_ARGS(dir));
+
+	for (iasset = 0; iasset < num_assets; ++iasset) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		uuids[iasset] = uuid_generate_random();
+		resource_import_map_store(STRING_ARGS(path), uuids[iasset], uint256_make(iasset, 0, 0, 0));
+	}
+
+	resource_autoimport_watch(STRING_ARGS(dir));
+
+	string_t found;
+	for (iasset = 0; iasset < num_assets; ++iasset) {
+		found = resource_autoimport_lookup(uuids[iasset], lookupbuffer, sizeof(lookupbuffer));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		EXPECT_STRINGEQ(found, path);
+#endif
+	}
+
+	//Unknown resource is not found
+	found = resource_autoimport_lookup(uuid_generate_random(), lookupbuffer, sizeof(lookupbuffer));
+	EXPECT_SIZEEQ(found.length, 0);
+
+	resource_autoimport_unwatch(STRING_ARGS(dir));
+
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+DECLARE_TEST(import, purge) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	const size_t num_assets = 1000;
+	uuid_t uuids[1000];
+	size_t iasset;
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_purge"));
+	fs_make_directory(STRING_ARGS(dir));
+
+	for (iasset = 0; iasset < num_assets; ++iasset) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		uuids[iasset] = uuid_generate_random();
+		resource_import_map_store(STRING_ARGS(path), uuids[iasset], uint256_make(iasset, 0, 0, 0));
+	}
+
+	//Purge every other entry, remaining entries must still be found through tombstones
+	for (iasset = 0; iasset < num_assets; iasset += 2) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		bool purged = resource_import_map_purge(STRING_ARGS(path));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+		EXPECT_TRUE(purged);
+		EXPECT_FALSE(resource_import_map_purge(STRING_ARGS(path)));
+#else
+		FOUNDATION_UNUSED(purged);
+#endif
+	}
+	for (iasset = 0; iasset < num_assets; ++iasset) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		resource_signature_t sig = resource_import_lookup(STRING_ARGS(path));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+		if (iasset % 2)
+			EXPECT_TRUE(uuid_equal(sig.uuid, uuids[iasset]));
+		else
+			EXPECT_TRUE(uuid_is_null(sig.uuid));
+#else
+		FOUNDATION_UNUSED(sig);
+#endif
+	}
+
+	//Prune entries for missing files, only the first ten assets exist on disk
+	for (iasset = 0; iasset < 10; ++iasset) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		stream_t* stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE);
+		stream_deallocate(stream);
+	}
+	resource_import_prune_result_t prune = resource_import_map_prune(STRING_ARGS(dir), 0);
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	EXPECT_SIZEEQ(prune.maps, 1);
+	EXPECT_SIZEEQ(prune.entries, num_assets / 2);
+	EXPECT_SIZEEQ(prune.pruned, (num_assets / 2) - 5);
+#else
+	FOUNDATION_UNUSED(prune);
+#endif
+	for (iasset = 0; iasset < num_assets; ++iasset) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       iasset);
+		resource_signature_t sig = resource_import_lookup(STRING_ARGS(path));
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+		if ((iasset < 10) && (iasset % 2))
+			EXPECT_TRUE(uuid_equal(sig.uuid, uuids[iasset]));
+		else
+			EXPECT_TRUE(uuid_is_null(sig.uuid));
+#else
+		FOUNDATION_UNUSED(sig);
+#endif
+	}
+
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+static int
+test_import_directory_importer(stream_t* stream, const uuid_t uuid) {
+	string_const_t path = stream_path(stream);
+	path = path_strip_protocol(STRING_ARGS(path));
+	uint256_t filehash = resource_hashcache_hash(STRING_ARGS(path));
+	uuid_t target = uuid_is_null(uuid) ? uuid_generate_random() : uuid;
+	target = resource_import_map_store(STRING_ARGS(path), target, filehash);
+	resource_source_set_import_hash(target, filehash);
+	return 0;
+}
+
+static int
+test_import_directory_failure(stream_t* stream, const uuid_t uuid) {
+	FOUNDATION_UNUSED(stream);
+	FOUNDATION_UNUSED(uuid);
+	return -1;
+}
+
+DECLARE_TEST(import, directory) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	char sourcebuffer[BUILD_MAX_PATHLEN];
+	const char* names[] = {"first.good", "second.good", "third.good", "broken.bad"};
+	size_t ifile;
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_directory"));
+	string_t sourcepath = path_concat(sourcebuffer, sizeof(sourcebuffer), STRING_ARGS(tmp),
+	                                  STRING_CONST("import_directory_source"));
+	fs_make_directory(STRING_ARGS(dir));
+	fs_make_directory(STRING_ARGS(sourcepath));
+	resource_source_set_path(STRING_ARGS(sourcepath));
+
+	for (ifile = 0; ifile < sizeof(names) / sizeof(names[0]); ++ifile) {
+		string_t path = path_concat(buffer, sizeof(buffer), STRING_ARGS(dir), names[ifile],
+		                            string_length(names[ifile]));
+		stream_t* stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE);
+		EXPECT_PTRNE(stream, nullptr);
+		stream_write_string(stream, names[ifile], string_length(names[ifile]));
+		stream_deallocate(stream);
+	}
+
+	resource_import_register_format(test_import_directory_importer, STRING_CONST("good"),
+	                                nullptr, 0);
+	resource_import_register_format(test_import_directory_failure, STRING_CONST("bad"), nullptr,
+	                                0);
+
+	//Good files are imported and the bad file fails
+	resource_import_result_t result = resource_import_directory(STRING_ARGS(dir), false, 2);
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	EXPECT_SIZEEQ(result.files, 4);
+	EXPECT_SIZEEQ(result.imported, 3);
+	EXPECT_SIZEEQ(result.failed, 1);
+	EXPECT_SIZEEQ(result.up_to_date, 0);
+#endif
+
+	//Import map written by the first pass is not a file to import, unchanged files are up
+	//to date and the unchanged bad file is skipped as a known failure
+	result = resource_import_directory(STRING_ARGS(dir), false, 2);
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	EXPECT_SIZEEQ(result.files, 4);
+	EXPECT_SIZEEQ(result.imported, 0);
+	EXPECT_SIZEEQ(result.failed, 1);
+	EXPECT_SIZEEQ(result.up_to_date, 3);
+#else
+	FOUNDATION_UNUSED(result);
+#endif
+
+	resource_import_unregister(test_import_directory_importer);
+	resource_import_unregister(test_import_directory_failure);
+	resource_failure_clear();
+	resource_source_set_path(STRING_CONST(""));
+
+	fs_remove_directory(STRING_ARGS(dir));
+	fs_remove_directory(STRING_ARGS(sourcepath));
+
+	return 0;
+}
+
+DECLARE_TEST(import, coalesce) {
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	char buffer[BUILD_MAX_PATHLEN];
+	const size_t num_events = 10;
+	size_t ievent;
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_coalesce"));
+	fs_make_directory(STRING_ARGS(dir));
+
+	string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir), 0);
+	stream_t* stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_CREATE);
+	EXPECT_PTRNE(stream, nullptr);
+	stream_write_string(stream, STRING_CONST("coalesced asset content"));
+	stream_deallocate(stream);
+
+	//Map hash differs from file content so the processed event triggers a reimport
+	resource_import_map_store(STRING_ARGS(path), uuid_generate_random(),
+	                          uint256_make(1, 0, 0, 0));
+	resource_autoimport_watch(STRING_ARGS(dir));
+
+	resource_autoimport_statistics_t before = resource_autoimport_statistics();
+
+	//Repeated modifications of the same file within the event delay
+	event_stream_t* events = event_stream_allocate(0);
+	for (ievent = 0; ievent < num_events; ++ievent)
+		event_post(events, FOUNDATIONEVENT_FILE_MODIFIED, 0, 0, path.str, path.length);
+	event_block_t* block = event_stream_process(events);
+	event_t* event = nullptr;
+	while ((event = event_next(block, event)))
+		resource_autoimport_event_handle(event);
+	event_stream_deallocate(events);
+
+	resource_autoimport_statistics_t after = resource_autoimport_statistics();
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+	tick_t start = time_current();
+	while ((after.triggered == before.triggered) && (time_elapsed(start) < 5.0f)) {
+		thread_sleep(10);
+		after = resource_autoimport_statistics();
+	}
+	//Give a spurious second trigger time to show up
+	thread_sleep(250);
+	after = resource_autoimport_statistics();
+
+	EXPECT_UINTEQ(after.events - before.events, num_events);
+	EXPECT_UINTEQ(after.dropped - before.dropped, num_events - 1);
+	EXPECT_UINTEQ(after.processed - before.processed, 1);
+	EXPECT_UINTEQ(after.triggered - before.triggered, 1);
+#else
+	FOUNDATION_UNUSED(before);
+	FOUNDATION_UNUSED(after);
+#endif
+
+	resource_autoimport_unwatch(STRING_ARGS(dir));
+
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+DECLARE_TEST(import, digest) {
+	const size_t size = 5000;
+	uint8_t* data = memory_allocate(HASH_TEST, size, 0, MEMORY_PERSISTENT);
+	for (size_t ibyte = 0; ibyte < size; ++ibyte)
+		data[ibyte] = (uint8_t)random32();
+
+	//Result must not depend on how data is split over updates
+	uint256_t whole = resource_digest_buffer(data, size, RESOURCEHASH_FAST);
+	const size_t chunks[] = {1, 7, 63, 64, 65, 1023, 1024, 1025, 4096};
+	for (size_t ichunk = 0; ichunk < sizeof(chunks) / sizeof(chunks[0]); ++ichunk) {
+		resource_digest_t digest;
+		resource_digest_initialize(&digest, RESOURCEHASH_FAST);
+		for (size_t offset = 0; offset < size; offset += chunks[ichunk]) {
+			size_t count = (size - offset < chunks[ichunk]) ? (size - offset) : chunks[ichunk];
+			resource_digest_update(&digest, data + offset, count);
+		}
+		EXPECT_TRUE(uint256_equal(resource_digest_finalize(&digest), whole));
+	}
+
+	//Any change in content or length must change the hash
+	EXPECT_FALSE(uint256_equal(resource_digest_buffer(data, size - 1, RESOURCEHASH_FAST), whole));
+	data[size / 2] ^= 1;
+	EXPECT_FALSE(uint256_equal(resource_digest_buffer(data, size, RESOURCEHASH_FAST), whole));
+	EXPECT_FALSE(uint256_equal(resource_digest_buffer(data, 0, RESOURCEHASH_FAST),
+	                           resource_digest_buffer(data, 1, RESOURCEHASH_FAST)));
+
+	//SHA-256 digest matches foundation implementation
+	sha256_t sha;
+	sha256_initialize(&sha);
+	sha256_digest(&sha, data, size);
+	sha256_digest_finalize(&sha);
+	EXPECT_TRUE(uint256_equal(resource_digest_buffer(data, size, RESOURCEHASH_SHA256),
+	                          sha256_get_digest_raw(&sha)));
+
+	//Multi-buffer SHA-256 matches single buffer digests for all padding cases
+	const size_t sizes[] = {0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000, 4900, 3, 200};
+	const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+	const void* buffers[sizeof(sizes) / sizeof(sizes[0])];
+	uint256_t hashes[sizeof(sizes) / sizeof(sizes[0])];
+	for (size_t ibuf = 0; ibuf < count; ++ibuf)
+		buffers[ibuf] = data + ibuf;
+	resource_digest_sha256_batch(buffers, sizes, count, hashes);
+	for (size_t ibuf = 0; ibuf < count; ++ibuf)
+		EXPECT_TRUE(uint256_equal(hashes[ibuf],
+		                          resource_digest_buffer(buffers[ibuf], sizes[ibuf],
+		                                                 RESOURCEHASH_SHA256)));
+
+	memory_deallocate(data);
+
+	return 0;
+}
+
+DECLARE_TEST(import, hashcache_batch) {
+	char buffer[BUILD_MAX_PATHLEN];
+	char dirbuffer[BUILD_MAX_PATHLEN];
+	//More files than fit in one batch to hash in several chunks
+	string_const_t paths[(RESOURCE_HASHCACHE_BATCH_MAX * 2) + 1];
+	string_t pathstr[(RESOURCE_HASHCACHE_BATCH_MAX * 2) + 1];
+	uint256_t hashes[(RESOURCE_HASHCACHE_BATCH_MAX * 2) + 1];
+	const size_t num_files = sizeof(paths) / sizeof(paths[0]);
+	size_t ifile;
+
+	string_const_t tmp = environment_temporary_directory();
+	string_t dir = path_concat(dirbuffer, sizeof(dirbuffer), STRING_ARGS(tmp),
+	                           STRING_CONST("import_hashcache_batch"));
+	fs_make_directory(STRING_ARGS(dir));
+
+	//Mixed line endings must hash like stream_sha256 on the file
+	for (ifile = 0; ifile < num_files; ++ifile) {
+		string_t path = test_import_asset_path(buffer, sizeof(buffer), string_to_const(dir),
+		                                       ifile);
+		pathstr[ifile] = string_clone(STRING_ARGS(path));
+		paths[ifile] = string_to_const(pathstr[ifile]);
+		stream_t* stream = stream_open(STRING_ARGS(path), STREAM_OUT | STREAM_BINARY |
+		                                                      STREAM_CREATE | STREAM_TRUNCATE);
+		for (size_t iline = 0; iline < ifile * 20; ++iline)
+			stream_write(stream, STRING_CONST("line\r\nother line\rlast line\n"));
+		stream_deallocate(stream);
+	}
+
+	resource_hashcache_hash_batch(paths, num_files, hashes);
+	for (ifile = 0; ifile < num_files; ++ifile) {
+		stream_t* stream = stream_open(STRING_ARGS(paths[ifile]), STREAM_IN);
+		uint256_t expected = stream_sha256(stream);
+		stream_deallocate(stream);
+#if RESOURCE_ENABLE_LOCAL_SOURCE
+		EXPECT_TRUE(uint256_equal(hashes[ifile], expected));
+		EXPECT_TRUE(uint256_equal(resource_hashcache_hash(STRING_ARGS(paths[ifile])), expected));
+#else
+		FOUNDATION_UNUSED(expected);
+#endif
+		string_deallocate(pathstr[ifile].str);
+	}
+
+	fs_remove_directory(STRING_ARGS(dir));
+
+	return 0;
+}
+
+static void
+test_import_declare(void) {
+	ADD_TEST(import, map);
+	ADD_TEST(import, map_concurrent);
+	ADD_TEST(import, convert);
+	ADD_TEST(import, hashcache);
+	ADD_TEST(import, format);
+	ADD_TEST(import, reverse_lookup);
+	ADD_TEST(import, purge);
+	ADD_TEST(import, directory);
+	ADD_TEST(import, coalesce);
+	ADD_TEST(import, digest);
+	ADD_TEST(import, hashcache_batch);
+}
+
+static test_suite_t test_import_suite = {
+	test_import_application,
+	test_import_memory_system,
+	test_import_config,
+	test_import_declare,
+	test_import_initialize,
+	test_import_finalize,
+	test_import_event
+};
+
+#if BUILD_MONOLITHIC
+
+int
+test_import_run(void);
+
+int
+test_import_run(void) {
+	test_suite = test_import_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_import_suite;
+}
+
+#endif
@@ -524,6 +524,450 @@ DECLARE_TEST(source, blob) {
 	return 0;
 }
 
+#if (RESOURCE_ENABLE_LOCAL_SOURCE || RESOURCE_ENABLE_REMOTE_SOURCED) && RESOURCE_ENABLE_LOCAL_CACHE
+
+static bool
+test_cache_write_local(const uuid_t uuid, uint64_t platform, const uint256_t source_hash,
+                       const void* data, size_t size) {
+	resource_header_t header;
+	header.type = HASH_TEST;
+	header.version = 1;
+	header.source_hash = source_hash;
+	stream_t* stream = resource_local_create_static(uuid, platform);
+	if (!stream)
+		return false;
+	resource_stream_write_header(stream, header);
+	stream_write(stream, data, size);
+	stream_deallocate(stream);
+	stream = resource_local_create_dynamic(uuid, platform);
+	if (!stream)
+		return false;
+	stream_write(stream, data, size);
+	stream_deallocate(stream);
+	return true;
+}
+
+#endif
+
+DECLARE_TEST(source, cache) {
+	char data[1024];
+	char readback[1024];
+	char localbuf[BUILD_MAX_PATHLEN];
+	char cachebuf[BUILD_MAX_PATHLEN];
+	uuid_t uuid;
+	uint64_t platform;
+	uint256_t source_hash;
+	hash_t fingerprint;
+	size_t iidx;
+
+	string_const_t path = environment_temporary_directory();
+	string_t localpath =
+	    path_concat(localbuf, sizeof(localbuf), STRING_ARGS(path), STRING_CONST("local"));
+	string_t cachepath =
+	    path_concat(cachebuf, sizeof(cachebuf), STRING_ARGS(path), STRING_CONST("cache"));
+	fs_remove_directory(STRING_ARGS(localpath));
+	fs_remove_directory(STRING_ARGS(cachepath));
+	fs_make_directory(STRING_ARGS(localpath));
+	resource_local_add_path(STRING_ARGS(localpath));
+	resource_cache_set_path(STRING_ARGS(cachepath));
+
+	uuid = uuid_generate_random();
+	platform = 0x1234;
+	source_hash = uint256_make(random64(), random64(), random64(), random64());
+	fingerprint = random64();
+	for (iidx = 0; iidx < sizeof(data); ++iidx)
+		data[iidx] = (char)(random32() & 0xFF);
+
+	resource_cache_statistics_t base = resource_cache_statistics();
+	resource_cache_statistics_t stats;
+
+#if (RESOURCE_ENABLE_LOCAL_SOURCE || RESOURCE_ENABLE_REMOTE_SOURCED) && RESOURCE_ENABLE_LOCAL_CACHE
+	EXPECT_TRUE(test_cache_write_local(uuid, platform, source_hash, data, sizeof(data)));
+
+	// Nothing stored yet
+	EXPECT_FALSE(resource_cache_fetch(fingerprint, uuid, platform, source_hash));
+	stats = resource_cache_statistics();
+	EXPECT_UINTEQ(stats.misses, base.misses + 1);
+
+	// Output not matching the source hash is never stored
+	uint256_t other_hash = uint256_make(random64(), random64(), random64(), random64());
+	EXPECT_FALSE(resource_cache_store(fingerprint, uuid, platform, other_hash));
+	EXPECT_TRUE(resource_cache_store(fingerprint, uuid, platform, source_hash));
+	stats = resource_cache_statistics();
+	EXPECT_UINTEQ(stats.stores, base.stores + 1);
+	EXPECT_TRUE(stats.size >= sizeof(data) * 2);
+
+	// Materialize static and dynamic parts into an empty local path
+	fs_remove_directory(STRING_ARGS(localpath));
+	EXPECT_PTREQ(resource_local_open_static(uuid, platform), nullptr);
+	EXPECT_TRUE(resource_cache_fetch(fingerprint, uuid, platform, source_hash));
+	stats = resource_cache_statistics();
+	EXPECT_UINTEQ(stats.hits, base.hits + 1);
+
+	stream_t* stream = resource_local_open_static(uuid, platform);
+	EXPECT_PTRNE(stream, nullptr);
+	resource_header_t header = resource_stream_read_header(stream);
+	EXPECT_TRUE(uint256_equal(header.source_hash, source_hash));
+	EXPECT_SIZEEQ(stream_read(stream, readback, sizeof(readback)), sizeof(data));
+	EXPECT_INTEQ(memcmp(readback, data, sizeof(data)), 0);
+	stream_deallocate(stream);
+
+	stream = resource_local_open_dynamic(uuid, platform);
+	EXPECT_PTRNE(stream, nullptr);
+	EXPECT_SIZEEQ(stream_read(stream, readback, sizeof(readback)), sizeof(data));
+	EXPECT_INTEQ(memcmp(readback, data, sizeof(data)), 0);
+	stream_deallocate(stream);
+
+	// Changed dependency sources give a different fingerprint and miss the entry,
+	// as does another platform or source hash
+	EXPECT_FALSE(resource_cache_fetch(fingerprint + 1, uuid, platform, source_hash));
+	EXPECT_FALSE(resource_cache_fetch(fingerprint, uuid, platform + 1, source_hash));
+	EXPECT_FALSE(resource_cache_fetch(fingerprint, uuid, platform, other_hash));
+	stats = resource_cache_statistics();
+	EXPECT_UINTEQ(stats.misses, base.misses + 4);
+
+	// Entry whose stored key differs, as on a collision of the key hash, is a miss
+	string_t* keyfiles =
+	    fs_matching_files(STRING_ARGS(cachepath), STRING_CONST("^.*\\.key$"), true);
+	EXPECT_SIZEEQ(array_size(keyfiles), 1);
+	char keybuf[BUILD_MAX_PATHLEN];
+	string_t keypath =
+	    path_concat(keybuf, sizeof(keybuf), STRING_ARGS(cachepath), STRING_ARGS(keyfiles[0]));
+	string_array_deallocate(keyfiles);
+	char key[64];
+	stream = stream_open(STRING_ARGS(keypath), STREAM_IN | STREAM_BINARY);
+	EXPECT_PTRNE(stream, nullptr);
+	size_t keysize = stream_read(stream, key, sizeof(key));
+	stream_deallocate(stream);
+	key[0] ^= 0x55;
+	stream = stream_open(STRING_ARGS(keypath), STREAM_OUT | STREAM_BINARY | STREAM_TRUNCATE);
+	stream_write(stream, key, keysize);
+	stream_deallocate(stream);
+	EXPECT_FALSE(resource_cache_fetch(fingerprint, uuid, platform, source_hash));
+	key[0] ^= 0x55;
+	stream = stream_open(STRING_ARGS(keypath), STREAM_OUT | STREAM_BINARY | STREAM_TRUNCATE);
+	stream_write(stream, key, keysize);
+	stream_deallocate(stream);
+	stats = resource_cache_statistics();
+	EXPECT_UINTEQ(stats.misses, base.misses + 5);
+
+	// Store a second entry with newer use time, eviction drops the least recently used
+	uuid_t second = uuid_generate_random();
+	thread_sleep(1100);
+	EXPECT_TRUE(test_cache_write_local(second, platform, other_hash, data, sizeof(data)));
+	EXPECT_TRUE(resource_cache_store(fingerprint, second, platform, other_hash));
+	resource_cache_evict(sizeof(data) * 3);
+	stats = resource_cache_statistics();
+	EXPECT_UINTEQ(stats.evictions, base.evictions + 1);
+	EXPECT_TRUE(stats.size <= sizeof(data) * 3);
+	EXPECT_FALSE(resource_cache_fetch(fingerprint, uuid, platform, source_hash));
+	EXPECT_TRUE(resource_cache_fetch(fingerprint, second, platform, other_hash));
+
+	// Evicting everything leaves an empty cache
+	resource_cache_evict(0);
+	stats = resource_cache_statistics();
+	EXPECT_UINTEQ(stats.evictions, base.evictions + 2);
+	EXPECT_UINTEQ(stats.size, 0);
+	EXPECT_FALSE(resource_cache_fetch(fingerprint, second, platform, other_hash));
+#else
+	FOUNDATION_UNUSED(readback);
+	FOUNDATION_UNUSED(base);
+	FOUNDATION_UNUSED(stats);
+	FOUNDATION_UNUSED(uuid);
+	FOUNDATION_UNUSED(source_hash);
+	FOUNDATION_UNUSED(fingerprint);
+#endif
+
+	resource_cache_set_path(STRING_CONST(""));
+	resource_local_remove_path(STRING_ARGS(localpath));
+	fs_remove_directory(STRING_ARGS(localpath));
+	fs_remove_directory(STRING_ARGS(cachepath));
+
+	return 0;
+}
+
+#define TEST_SCHEDULE_NODES 10
+
+static uuid_t _test_schedule_uuid[TEST_SCHEDULE_NODES];
+static uuid_t _test_schedule_order[TEST_SCHEDULE_NODES];
+static atomic32_t _test_schedule_compiled;
+
+static int
+test_schedule_compile(const uuid_t uuid, uint64_t platform, resource_source_t* source,
+                      const uint256_t source_hash, const char* type, size_t type_length) {
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(source);
+	FOUNDATION_UNUSED(source_hash);
+	if (!string_equal(type, type_length, STRING_CONST("schedule")))
+		return -1;
+	int32_t slot = atomic_incr32(&_test_schedule_compiled, memory_order_acq_rel) - 1;
+	if ((slot >= 0) && (slot < TEST_SCHEDULE_NODES))
+		_test_schedule_order[slot] = uuid;
+	// Node 5 always fails to compile
+	return uuid_equal(uuid, _test_schedule_uuid[5]) ? -1 : 0;
+}
+
+static size_t
+test_schedule_position(const uuid_t uuid) {
+	int32_t compiled = atomic_load32(&_test_schedule_compiled, memory_order_acquire);
+	for (int32_t islot = 0; (islot < compiled) && (islot < TEST_SCHEDULE_NODES); ++islot) {
+		if (uuid_equal(_test_schedule_order[islot], uuid))
+			return (size_t)islot;
+	}
+	return (size_t)-1;
+}
+
+static const resource_schedule_node_t*
+test_schedule_node(const resource_schedule_node_t* nodes, size_t count, const uuid_t uuid) {
+	for (size_t inode = 0; inode < count; ++inode) {
+		if (uuid_equal(nodes[inode].uuid, uuid))
+			return nodes + inode;
+	}
+	return nullptr;
+}
+
+DECLARE_TEST(source, schedule) {
+	resource_source_t source;
+	resource_dependency_t deps[2];
+	string_const_t path;
+	size_t inode;
+
+	path = environment_temporary_directory();
+	resource_source_set_path(STRING_ARGS(path));
+
+	for (inode = 0; inode < TEST_SCHEDULE_NODES; ++inode) {
+		_test_schedule_uuid[inode] = uuid_generate_random();
+		resource_source_initialize(&source);
+		resource_source_set(&source, time_system(), HASH_RESOURCE_TYPE, 0,
+		                    STRING_CONST("schedule"));
+		resource_source_write(&source, _test_schedule_uuid[inode], false);
+		resource_source_finalize(&source);
+	}
+
+	// Diamond 0 -> (1, 2) -> 3, chain 4 -> 5 where 5 fails and 6 -> 4 is skipped,
+	// cycle 7 <-> 8 with 9 depending on the cycle
+	memset(deps, 0, sizeof(deps));
+	deps[0].uuid = _test_schedule_uuid[1];
+	deps[1].uuid = _test_schedule_uuid[2];
+	resource_source_set_dependencies(_test_schedule_uuid[0], 0, deps, 2);
+	deps[0].uuid = _test_schedule_uuid[3];
+	resource_source_set_dependencies(_test_schedule_uuid[1], 0, deps, 1);
+	resource_source_set_dependencies(_test_schedule_uuid[2], 0, deps, 1);
+	deps[0].uuid = _test_schedule_uuid[5];
+	resource_source_set_dependencies(_test_schedule_uuid[4], 0, deps, 1);
+	deps[0].uuid = _test_schedule_uuid[4];
+	resource_source_set_dependencies(_test_schedule_uuid[6], 0, deps, 1);
+	deps[0].uuid = _test_schedule_uuid[8];
+	resource_source_set_dependencies(_test_schedule_uuid[7], 0, deps, 1);
+	deps[0].uuid = _test_schedule_uuid[7];
+	resource_source_set_dependencies(_test_schedule_uuid[8], 0, deps, 1);
+	resource_source_set_dependencies(_test_schedule_uuid[9], 0, deps, 1);
+
+	atomic_store32(&_test_schedule_compiled, 0, memory_order_release);
+	resource_compile_register(test_schedule_compile);
+
+	resource_schedule_t* schedule = resource_schedule_allocate(4);
+	resource_schedule_add(schedule, _test_schedule_uuid[0], 0);
+	resource_schedule_add(schedule, _test_schedule_uuid[6], 0);
+	resource_schedule_add(schedule, _test_schedule_uuid[9], 0);
+	bool success = resource_schedule_run(schedule);
+
+	size_t count = 0;
+	const resource_schedule_node_t* nodes = resource_schedule_nodes(schedule, &count);
+#if RESOURCE_ENABLE_LOCAL_SOURCE && RESOURCE_ENABLE_LOCAL_CACHE
+	const resource_schedule_node_t* node;
+	EXPECT_FALSE(success);
+	EXPECT_SIZEEQ(count, TEST_SCHEDULE_NODES);
+	EXPECT_INTEQ(atomic_load32(&_test_schedule_compiled, memory_order_acquire), 5);
+
+	// Topological order, every dependency compiled before its dependents
+	for (inode = 0; inode < 4; ++inode) {
+		node = test_schedule_node(nodes, count, _test_schedule_uuid[inode]);
+		EXPECT_PTRNE(node, nullptr);
+		EXPECT_INTEQ(node->state, RESOURCESCHEDULE_COMPILED);
+		EXPECT_TRUE(test_schedule_position(_test_schedule_uuid[inode]) != (size_t)-1);
+	}
+	EXPECT_TRUE(test_schedule_position(_test_schedule_uuid[3]) <
+	            test_schedule_position(_test_schedule_uuid[1]));
+	EXPECT_TRUE(test_schedule_position(_test_schedule_uuid[3]) <
+	            test_schedule_position(_test_schedule_uuid[2]));
+	EXPECT_TRUE(test_schedule_position(_test_schedule_uuid[1]) <
+	            test_schedule_position(_test_schedule_uuid[0]));
+	EXPECT_TRUE(test_schedule_position(_test_schedule_uuid[2]) <
+	            test_schedule_position(_test_schedule_uuid[0]));
+	node = test_schedule_node(nodes, count, _test_schedule_uuid[0]);
+	EXPECT_SIZEEQ(node->num_dependencies, 2);
+
+	// Failed node skips all dependents without invoking compilers on them
+	node = test_schedule_node(nodes, count, _test_schedule_uuid[5]);
+	EXPECT_PTRNE(node, nullptr);
+	EXPECT_INTEQ(node->state, RESOURCESCHEDULE_FAILED);
+	for (inode = 4; inode < 7; inode += 2) {
+		node = test_schedule_node(nodes, count, _test_schedule_uuid[inode]);
+		EXPECT_PTRNE(node, nullptr);
+		EXPECT_INTEQ(node->state, RESOURCESCHEDULE_SKIPPED);
+		EXPECT_SIZEEQ(test_schedule_position(_test_schedule_uuid[inode]), (size_t)-1);
+	}
+
+	// Cycle members and nodes depending on a cycle are reported and never compiled
+	for (inode = 7; inode < TEST_SCHEDULE_NODES; ++inode) {
+		node = test_schedule_node(nodes, count, _test_schedule_uuid[inode]);
+		EXPECT_PTRNE(node, nullptr);
+		EXPECT_INTEQ(node->state, RESOURCESCHEDULE_CYCLE);
+		EXPECT_SIZEEQ(test_schedule_position(_test_schedule_uuid[inode]), (size_t)-1);
+	}
+#else
+	FOUNDATION_UNUSED(success);
+	FOUNDATION_UNUSED(nodes);
+#endif
+
+	resource_schedule_deallocate(schedule);
+	resource_compile_unregister(test_schedule_compile);
+
+	fs_remove_directory(STRING_ARGS(path));
+
+	return 0;
+}
+
+static uuid_t _test_record_uuid[4];
+
+static int
+test_record_compile(const uuid_t uuid, uint64_t platform, resource_source_t* source,
+                    const uint256_t source_hash, const char* type, size_t type_length) {
+	FOUNDATION_UNUSED(platform);
+	FOUNDATION_UNUSED(source);
+	FOUNDATION_UNUSED(source_hash);
+	if (!string_equal(type, type_length, STRING_CONST("record")))
+		return -1;
+	if (uuid_equal(uuid, _test_record_uuid[0])) {
+		// Read 1 which depends back on 0, and 3 twice
+		const size_t reads[] = {1, 3, 3};
+		for (size_t iread = 0; iread < sizeof(reads) / sizeof(reads[0]); ++iread) {
+			resource_source_t other;
+			resource_source_initialize(&other);
+			resource_source_read(&other, _test_record_uuid[reads[iread]]);
+			resource_source_finalize(&other);
+		}
+	}
+	return 0;
+}
+
+DECLARE_TEST(source, record) {
+	resource_source_t source;
+	resource_dependency_t deps[4];
+	string_const_t path;
+	size_t inode;
+
+	path = environment_temporary_directory();
+	resource_source_set_path(STRING_ARGS(path));
+
+	for (inode = 0; inode < 4; ++inode) {
+		_test_record_uuid[inode] = uuid_generate_random();
+		resource_source_initialize(&source);
+		resource_source_set(&source, time_system(), HASH_RESOURCE_TYPE, 0,
+		                    STRING_CONST("record"));
+		resource_source_write(&source, _test_record_uuid[inode], false);
+		resource_source_finalize(&source);
+	}
+
+	// 0 declares 2, 1 declares 0
+	memset(deps, 0, sizeof(deps));
+	deps[0].uuid = _test_record_uuid[2];
+	resource_source_set_dependencies(_test_record_uuid[0], 0, deps, 1);
+	deps[0].uuid = _test_record_uuid[0];
+	resource_source_set_dependencies(_test_record_uuid[1], 0, deps, 1);
+
+	resource_compile_register(test_record_compile);
+	bool success = resource_compile(_test_record_uuid[0], 0);
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE && RESOURCE_ENABLE_LOCAL_CACHE
+	// Declared 2 is not read and dropped, read 3 is recorded once, read 1 would close a cycle
+	EXPECT_TRUE(success);
+	memset(deps, 0, sizeof(deps));
+	EXPECT_SIZEEQ(resource_source_dependencies(_test_record_uuid[0], 0, deps, 4), 1);
+	EXPECT_TRUE(uuid_equal(deps[0].uuid, _test_record_uuid[3]));
+	EXPECT_SIZEEQ(resource_source_dependencies(_test_record_uuid[1], 0, deps, 4), 1);
+	EXPECT_TRUE(uuid_equal(deps[0].uuid, _test_record_uuid[0]));
+#else
+	FOUNDATION_UNUSED(success);
+#endif
+
+	resource_compile_unregister(test_record_compile);
+
+	fs_remove_directory(STRING_ARGS(path));
+
+	return 0;
+}
+
+static uuid_t _test_nested_uuid[3];
+
+static int
+test_nested_compile(const uuid_t uuid, uint64_t platform, resource_source_t* source,
+                    const uint256_t source_hash, const char* type, size_t type_length) {
+	FOUNDATION_UNUSED(source);
+	FOUNDATION_UNUSED(source_hash);
+	if (!string_equal(type, type_length, STRING_CONST("nested")))
+		return -1;
+	if (uuid_equal(uuid, _test_nested_uuid[0])) {
+		// A opens B, compiling B and its dependency C on this thread
+		stream_t* stream = resource_stream_open_static(_test_nested_uuid[1], platform);
+		stream_deallocate(stream);
+	} else if (uuid_equal(uuid, _test_nested_uuid[1])) {
+		// B reads C
+		resource_source_t other;
+		resource_source_initialize(&other);
+		resource_source_read(&other, _test_nested_uuid[2]);
+		resource_source_finalize(&other);
+	}
+	return 0;
+}
+
+DECLARE_TEST(source, record_nested) {
+	resource_source_t source;
+	resource_dependency_t deps[4];
+	string_const_t path;
+	size_t inode;
+
+	path = environment_temporary_directory();
+	resource_source_set_path(STRING_ARGS(path));
+
+	for (inode = 0; inode < 3; ++inode) {
+		_test_nested_uuid[inode] = uuid_generate_random();
+		resource_source_initialize(&source);
+		resource_source_set(&source, time_system(), HASH_RESOURCE_TYPE, 0,
+		                    STRING_CONST("nested"));
+		resource_source_write(&source, _test_nested_uuid[inode], false);
+		resource_source_finalize(&source);
+	}
+
+	// B declares C, A declares nothing
+	memset(deps, 0, sizeof(deps));
+	deps[0].uuid = _test_nested_uuid[2];
+	resource_source_set_dependencies(_test_nested_uuid[1], 0, deps, 1);
+
+	resource_compile_register(test_nested_compile);
+	bool success = resource_compile(_test_nested_uuid[0], 0);
+
+#if RESOURCE_ENABLE_LOCAL_SOURCE && RESOURCE_ENABLE_LOCAL_CACHE
+	// Reads by the nested compiles of B and C are not dependencies of A
+	EXPECT_TRUE(success);
+	memset(deps, 0, sizeof(deps));
+	EXPECT_SIZEEQ(resource_source_dependencies(_test_nested_uuid[0], 0, deps, 4), 1);
+	EXPECT_TRUE(uuid_equal(deps[0].uuid, _test_nested_uuid[1]));
+	EXPECT_SIZEEQ(resource_source_dependencies(_test_nested_uuid[1], 0, deps, 4), 1);
+	EXPECT_TRUE(uuid_equal(deps[0].uuid, _test_nested_uuid[2]));
+	EXPECT_SIZEEQ(resource_source_dependencies(_test_nested_uuid[2], 0, deps, 4), 0);
+#else
+	FOUNDATION_UNUSED(success);
+#endif
+
+	resource_compile_unregister(test_nested_compile);
+
+	fs_remove_directory(STRING_ARGS(path));
+
+	return 0;
+}
+
 DECLARE_TEST(source, io) {
 	return 0;
 }
@@ -534,6 +978,10 @@ test_source_declare(void) {
 	ADD_TEST(source, unset);
 	ADD_TEST(source, collapse);
 	ADD_TEST(source, blob);
+	ADD_TEST(source, schedule);
+	ADD_TEST(source, cache);
+	ADD_TEST(source, record);
+	ADD_TEST(source, record_nested);
 	ADD_TEST(source, io);
 }
 
@@ -27,6 +27,8 @@ typedef struct {
 	string_const_t    source_path;
 	string_const_t*   config_files;
 	string_const_t    remote_sourced;
+	uint64_t*         speculate_platforms;
+	string_const_t    metrics_path;
 	unsigned int      port;
 } compiled_input_t;
 
@@ -81,6 +83,10 @@ main_initialize(void) {
 		resource_config.enable_local_source = true;
 	resource_config.enable_remote_sourced = true;
 	resource_config.enable_local_cache = true;
+	resource_config.enable_tool_workers = true;
+	// Kill hung tools rather than blocking all clients
+	resource_config.tool_time_limit = 5 * 60 * 1000;
+	resource_config.compile_queue_thread_count = system_hardware_threads();
 
 	if ((ret = resource_module_initialize(resource_config)) < 0)
 		return ret;
@@ -110,6 +116,12 @@ main_run(void* main_arg) {
 		goto exit;
 	}
 
+	for (size_t iplat = 0, psize = array_size(input.speculate_platforms); iplat < psize; ++iplat)
+		resource_speculate_add_platform(input.speculate_platforms[iplat]);
+
+	if (input.metrics_path.length)
+		resource_metrics_set_dump_path(STRING_ARGS(input.metrics_path));
+
 	//TODO: Run as daemon
 
 	server_run(input.port);
@@ -119,6 +131,7 @@ exit:
 	resource_remote_sourced_disconnect();
 
 	array_deallocate(input.config_files);
+	array_deallocate(input.speculate_platforms);
 
 	return 0;
 }
@@ -166,6 +179,20 @@ compiled_parse_command_line(const string_const_t* cmdline) {
 			if (arg < asize - 1)
 				in.remote_sourced = cmdline[++arg];
 		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--speculate"))) {
+			if (arg < asize - 1) {
+				string_const_t value = cmdline[++arg];
+				if ((value.length > 2) && string_equal(value.str, 2, STRING_CONST("0x"))) {
+					value.str += 2;
+					value.length -= 2;
+				}
+				array_push(in.speculate_platforms, string_to_uint64(STRING_ARGS(value), true));
+			}
+		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--metrics"))) {
+			if (arg < asize - 1)
+				in.metrics_path = cmdline[++arg];
+		}
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--debug"))) {
 			log_set_suppress(0, ERRORLEVEL_NONE);
 			log_set_suppress(HASH_NETWORK, ERRORLEVEL_NONE);
@@ -187,13 +214,18 @@ compiled_print_usage(void) {
 	log_info(0, STRING_CONST(
 	             "compiled usage:\n"
 	             "  compiled [--source <path>] [--config <path>] [--port <port>]\n"
-	             "           [--remote <url>] [--debug] [--help] ... [--]\n"
+	             "           [--remote <url>] [--speculate <platform>] [--metrics <path>]\n"
+	             "           [--debug] [--help] ... [--]\n"
 	             "    Optional arguments:\n"
 	             "      --source <path>              Operate on resource file source structure given by <path>\n"
 	             "      --config <path>              Read and parse config file given by <path>\n"
 	             "                                   Loads all .json/.sjson files in <path> if it is a directory\n"
 	             "      --port <port>                Network port to use\n"
 	             "      --remote <url>               Connect to remote sourced service specified by <url>\n"
+	             "      --speculate <platform>       Recompile modified resources for hex <platform> in background\n"
+	             "                                   Can be given multiple times\n"
+	             "      --metrics <path>             Write compile metrics as JSON to <path> on exit\n"
+	             "                                   and on a metrics request message\n"
 	             "      --debug                      Enable debug output\n"
 	             "      --help                       Display this help message\n"
 	             "      --                           Stop processing command line arguments"
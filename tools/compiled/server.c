@@ -51,6 +51,9 @@ server_handle_open_static(socket_t* sock, size_t msgsize);
 static int
 server_handle_open_dynamic(socket_t* sock, size_t msgsize);
 
+static int
+server_handle_metrics(socket_t* sock, size_t msgsize);
+
 static int
 server_write_stream_to_socket(stream_t* stream, socket_t* sock);
 
@@ -152,6 +155,7 @@ server_run(unsigned int port) {
 			event = nullptr;
 			block = event_stream_process(resource_event_stream());
 			while ((event = event_next(block, event))) {
+				resource_speculate_event_handle(event);
 				switch (event->id) {
 				case RESOURCEEVENT_CREATE:
 				case RESOURCEEVENT_MODIFY:
@@ -315,9 +319,12 @@ server_handle(socket_t* sock) {
 		return server_handle_open_static(sock, msg.size);
 	case COMPILED_OPEN_DYNAMIC:
 		return server_handle_open_dynamic(sock, msg.size);
+	case COMPILED_METRICS:
+		return server_handle_metrics(sock, msg.size);
 
 	case COMPILED_OPEN_STATIC_RESULT:
 	case COMPILED_OPEN_DYNAMIC_RESULT:
+	case COMPILED_METRICS_RESULT:
 	default:
 		break;
 	}
@@ -393,6 +400,16 @@ server_handle_open_dynamic(socket_t* sock, size_t msgsize) {
 	return 0;
 }
 
+static int
+server_handle_metrics(socket_t* sock, size_t msgsize) {
+	if (msgsize != 0)
+		return -1;
+
+	// Dump metrics on request, a long running daemon is rarely finalized
+	log_infof(HASH_RESOURCE, STRING_CONST("Perform metrics dump"));
+	return compiled_write_metrics_reply(sock, resource_metrics_write());
+}
+
 static int
 server_write_stream_to_socket(stream_t* stream, socket_t* sock) {
 	int ret = 0;
@@ -23,3 +23,5 @@
 #define RESOURCE_RESULT_INVALID_ARGUMENT            -1
 #define RESOURCE_RESULT_UNKNOWN_COMMAND             -2
 #define RESOURCE_RESULT_UNABLE_TO_OPEN_OUTPUT_FILE  -3
+#define RESOURCE_RESULT_BUILD_FAILED                -4
+#define RESOURCE_RESULT_IMPORT_FAILED               -5
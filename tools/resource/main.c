@@ -34,15 +34,22 @@ typedef struct {
 	string_const_t    source_path;
 	string_const_t*   config_files;
 	string_const_t    remote_sourced;
+	string_const_t    metrics_path;
 	uuid_t            uuid;
 	uint256_t         hash;
 	string_t          lookup_path;
 	uint64_t          platform;
+	uint64_t*         platforms;
 	resource_op_t*    op;
 	bool              collapse;
 	bool              clearblobs;
 	bool              cformat;
 	bool              dump;
+	bool              build;
+	unsigned int      jobs;
+	string_const_t    import_dir;
+	bool              recursive;
+	string_const_t    prune_dir;
 } resource_input_t;
 
 static resource_input_t
@@ -57,6 +64,15 @@ resource_run(void* arg);
 static void
 resource_dump(resource_source_t* source);
 
+static int
+resource_build_all(resource_input_t* input);
+
+static int
+resource_import_all(resource_input_t* input);
+
+static int
+resource_prune_all(resource_input_t* input);
+
 static void*
 resource_read_file(const char* path, size_t length, resource_blob_t* blob) {
 	stream_t* stream = stream_open(path, length, STREAM_IN | STREAM_BINARY);
@@ -89,6 +105,8 @@ main_initialize(void) {
 	resource_config.enable_local_source = true;
 	resource_config.enable_local_cache = true;
 	resource_config.enable_remote_compiled = true;
+	// Compile threads are only started when a compile is queued
+	resource_config.compile_queue_thread_count = system_hardware_threads();
 
 	memset(&application, 0, sizeof(application));
 	application.name = string_const(STRING_CONST("resource"));
@@ -128,6 +146,9 @@ main_run(void* main_arg) {
 	if (input.remote_sourced.length)
 		resource_remote_sourced_connect(STRING_ARGS(input.remote_sourced));
 
+	if (input.metrics_path.length)
+		resource_metrics_set_dump_path(STRING_ARGS(input.metrics_path));
+
 	beacon_t beacon;
 	beacon_initialize(&beacon);
 	event_stream_set_beacon(system_event_stream(), &beacon);
@@ -158,11 +179,13 @@ main_run(void* main_arg) {
 	resource_remote_sourced_disconnect();
 
 	thread_signal(&runner);
+	result = (int)(intptr_t)thread_join(&runner);
 	thread_finalize(&runner);
 
 	beacon_finalize(&beacon);
 
 	string_deallocate(input.lookup_path.str);
+	array_deallocate(input.platforms);
 
 	return result;
 }
@@ -184,6 +207,24 @@ resource_run(void* arg) {
 	tick_t tick;
 	void* blobdata;
 
+	if (input->build && !input->display_help) {
+		result = resource_build_all(input);
+		system_post_event(FOUNDATIONEVENT_TERMINATE);
+		return (void*)(intptr_t)result;
+	}
+
+	if (input->import_dir.length && !input->display_help) {
+		result = resource_import_all(input);
+		system_post_event(FOUNDATIONEVENT_TERMINATE);
+		return (void*)(intptr_t)result;
+	}
+
+	if (input->prune_dir.length && !input->display_help) {
+		result = resource_prune_all(input);
+		system_post_event(FOUNDATIONEVENT_TERMINATE);
+		return (void*)(intptr_t)result;
+	}
+
 	bool lookup_done = false;
 	if (uuid_is_null(input->uuid) && input->lookup_path.length) {
 		resource_signature_t sig = resource_import_lookup(STRING_ARGS(input->lookup_path));
@@ -315,6 +356,79 @@ exit:
 	return (void*)(intptr_t)result;
 }
 
+static int
+resource_build_all(resource_input_t* input) {
+	if (!resource_source_path().length) {
+		log_errorf(HASH_RESOURCE, ERROR_INVALID_VALUE, STRING_CONST("No source path given"));
+		resource_print_usage();
+		return RESOURCE_RESULT_INVALID_ARGUMENT;
+	}
+
+	resource_build_result_t build =
+	    resource_build(input->platforms, array_size(input->platforms), input->jobs);
+
+	const error_level_t saved_level = log_suppress(HASH_RESOURCE);
+	log_set_suppress(HASH_RESOURCE, ERRORLEVEL_DEBUG);
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Build: %" PRIsize " resources, %" PRIsize " targets: %" PRIsize
+	                       " up to date, %" PRIsize " compiled, %" PRIsize " failed"),
+	          build.resources, build.targets, build.up_to_date, build.compiled, build.failed);
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Build: enumerate %.3fs, check %.3fs, compile %.3fs"),
+	          (double)build.enumerate_time, (double)build.check_time, (double)build.compile_time);
+	for (size_t islow = 0; islow < build.num_slowest; ++islow) {
+		string_const_t uuidstr = string_from_uuid_static(build.slowest[islow].uuid);
+		log_infof(HASH_RESOURCE, STRING_CONST("  %.3fs %.*s (platform 0x%" PRIx64 ")%s"),
+		          (double)build.slowest[islow].time, STRING_FORMAT(uuidstr),
+		          build.slowest[islow].platform, build.slowest[islow].success ? "" : " FAILED");
+	}
+	log_set_suppress(HASH_RESOURCE, saved_level);
+
+	return build.failed ? RESOURCE_RESULT_BUILD_FAILED : RESOURCE_RESULT_OK;
+}
+
+static int
+resource_import_all(resource_input_t* input) {
+	if (!resource_source_path().length) {
+		log_errorf(HASH_RESOURCE, ERROR_INVALID_VALUE, STRING_CONST("No source path given"));
+		resource_print_usage();
+		return RESOURCE_RESULT_INVALID_ARGUMENT;
+	}
+
+	resource_import_result_t import = resource_import_directory(
+	    STRING_ARGS(input->import_dir), input->recursive, input->jobs);
+
+	const error_level_t saved_level = log_suppress(HASH_RESOURCE);
+	log_set_suppress(HASH_RESOURCE, ERRORLEVEL_DEBUG);
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Import: %" PRIsize " files: %" PRIsize " up to date, %" PRIsize
+	                       " imported, %" PRIsize " failed"),
+	          import.files, import.up_to_date, import.imported, import.failed);
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Import: enumerate %.3fs, import %.3fs, %.1f MiB imported"),
+	          (double)import.enumerate_time, (double)import.import_time,
+	          (double)import.bytes / (1024.0 * 1024.0));
+	log_set_suppress(HASH_RESOURCE, saved_level);
+
+	return import.failed ? RESOURCE_RESULT_IMPORT_FAILED : RESOURCE_RESULT_OK;
+}
+
+static int
+resource_prune_all(resource_input_t* input) {
+	resource_import_prune_result_t prune =
+	    resource_import_map_prune(STRING_ARGS(input->prune_dir), input->jobs);
+
+	const error_level_t saved_level = log_suppress(HASH_RESOURCE);
+	log_set_suppress(HASH_RESOURCE, ERRORLEVEL_DEBUG);
+	log_infof(HASH_RESOURCE,
+	          STRING_CONST("Prune: %" PRIsize " import maps, %" PRIsize " entries: %" PRIsize
+	                       " pruned, %" PRIsize " maps compacted (%.3fs)"),
+	          prune.maps, prune.entries, prune.pruned, prune.compacted, (double)prune.time);
+	log_set_suppress(HASH_RESOURCE, saved_level);
+
+	return RESOURCE_RESULT_OK;
+}
+
 static resource_change_t*
 resource_dump_fn(resource_change_t* change, resource_change_t* best, void* data) {
 	FOUNDATION_UNUSED(data);
@@ -369,6 +483,10 @@ resource_parse_command_line(const string_const_t* cmdline) {
 			if (arg < asize - 1)
 				input.remote_sourced = cmdline[++arg];
 		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--metrics"))) {
+			if (arg < asize - 1)
+				input.metrics_path = cmdline[++arg];
+		}
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--uuid"))) {
 			if (arg < asize - 1) {
 				++arg;
@@ -402,6 +520,7 @@ resource_parse_command_line(const string_const_t* cmdline) {
 					hex = true;
 				}
 				input.platform = string_to_uint64(STRING_ARGS(value), hex);
+				array_push(input.platforms, input.platform);
 			}
 		}
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--set"))) {
@@ -445,6 +564,26 @@ resource_parse_command_line(const string_const_t* cmdline) {
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--dump"))) {
 			input.dump = true;
 		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--build"))) {
+			input.build = true;
+		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--import-dir"))) {
+			if (arg < asize - 1)
+				input.import_dir = cmdline[++arg];
+		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--recursive"))) {
+			input.recursive = true;
+		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--prune-maps"))) {
+			if (arg < asize - 1)
+				input.prune_dir = cmdline[++arg];
+		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--jobs"))) {
+			if (arg < asize - 1) {
+				++arg;
+				input.jobs = string_to_uint(STRING_ARGS(cmdline[arg]), false);
+			}
+		}
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--cformat"))) {
 			input.cformat = true;
 		}
@@ -473,10 +612,11 @@ resource_print_usage(void) {
 	             "  resource [--source <path>] [--config <path>] [--remote <url>]\n"
 	             "           [--uuid <uuid>] [--lookup <path>]\n"
 	             "           [--set <key> <value>] [--blob <key> <file>] [--unset <key>]\n"
-	             "           [--platform <id>]\n"
+	             "           [--platform <id>] [--build] [--jobs <count>]\n"
+	             "           [--import-dir <path>] [--recursive] [--prune-maps <path>]\n"
 	             "           [--collapse] [--clearblobs]\n"
 	             "           [--binary] [--ascii] [--dump]\n"
-	             "           [--cformat] [--debug] [--help] [--]\n"
+	             "           [--cformat] [--metrics <path>] [--debug] [--help] [--]\n"
 	             "    Resource specification arguments:\n"
 	             "      --source <path>        Set resource file repository to <path>\n"
 	             "      --config <path> ...    Read and parse config file given by <path>\n"
@@ -489,14 +629,26 @@ resource_print_usage(void) {
 	             "      --set <key> <value>    Set <key> to <value> in resource\n"
 	             "      --blob <key> <value>   Set <key> to blob read from <file> in resource\n"
 	             "      --unset <key>          Unset <key> in resource\n"
+	             "    Build arguments:\n"
+	             "      --build                Compile all out of date resources in source path for all\n"
+	             "                             given platforms, exits with non-zero code on failures\n"
+	             "      --jobs <count>         Number of build threads (default hardware threads)\n"
+	             "    Import arguments:\n"
+	             "      --import-dir <path>    Import all changed asset files in directory <path>,\n"
+	             "                             exits with non-zero code on failures\n"
+	             "      --recursive            Include subdirectories with --import-dir\n"
+	             "                             (--jobs sets number of import threads)\n"
+	             "      --prune-maps <path>    Remove entries for asset files that no longer exist from\n"
+	             "                             all import maps in <path> and subdirectories\n"
 	             "    Optional arguments:\n"
-	             "      --platform <id>        Platform specifier\n"
+	             "      --platform <id>        Platform specifier, can be given multiple times with --build\n"
 	             "      --collapse             Collapse history after all commands\n"
 	             "      --clearblobs           Clear unreferenced blobs after all commands\n"
 	             "      --binary               Write binary file\n"
 	             "      --ascii                Write ASCII file (default)\n"
 	             "      --dump                 Dump file output resource to stdout\n"
 	             "      --cformat              Format UUIDs as C uuid_make() declarations\n"
+	             "      --metrics <path>       Write compile metrics as JSON to <path> on exit\n"
 	             "      --debug                Enable debug output\n"
 	             "      --help                 Display this help message\n"
 	             "      --                     Stop processing command line arguments"
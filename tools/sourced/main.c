@@ -26,6 +26,7 @@ typedef struct {
 	bool              display_help;
 	string_const_t    source_path;
 	string_const_t*   config_files;
+	string_const_t    metrics_path;
 	unsigned int      port;
 } sourced_input_t;
 
@@ -54,7 +55,12 @@ main_initialize(void) {
 
 	resource_config.enable_local_source = true;
 	resource_config.enable_local_cache = true;
+	resource_config.enable_tool_workers = true;
+	// Kill hung tools rather than blocking all clients
+	resource_config.tool_time_limit = 5 * 60 * 1000;
 	resource_config.enable_local_autoimport = true;
+	// Check modified asset files off the main event loop
+	resource_config.autoimport_thread_count = 2;
 
 	memset(&application, 0, sizeof(application));
 	application.name = string_const(STRING_CONST("sourced"));
@@ -102,6 +108,9 @@ main_run(void* main_arg) {
 		goto exit;
 	}
 
+	if (input.metrics_path.length)
+		resource_metrics_set_dump_path(STRING_ARGS(input.metrics_path));
+
 	//TODO: Find all import maps in autoimport paths and load into memory DB
 	//TODO:   if no import maps, create default maps
 
@@ -155,6 +164,10 @@ sourced_parse_command_line(const string_const_t* cmdline) {
 				input.port = string_to_uint(STRING_ARGS(portstr), false);
 			}
 		}
+		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--metrics"))) {
+			if (arg < asize - 1)
+				input.metrics_path = cmdline[++arg];
+		}
 		else if (string_equal(STRING_ARGS(cmdline[arg]), STRING_CONST("--debug"))) {
 			log_set_suppress(0, ERRORLEVEL_NONE);
 			log_set_suppress(HASH_NETWORK, ERRORLEVEL_NONE);
@@ -176,12 +189,14 @@ sourced_print_usage(void) {
 	log_info(0, STRING_CONST(
 	             "sourced usage:\n"
 	             "  sourced [--source <path>] [--config <path>] [--port <port>]\n"
-	             "          [--debug] [--help] ... [--]\n"
+	             "          [--metrics <path>] [--debug] [--help] ... [--]\n"
 	             "    Optional arguments:\n"
 	             "      --source <path>              Operate on resource file source structure given by <path>\n"
 	             "      --config <path>              Read and parse config file given by <path>\n"
 	             "                                   Loads all .json/.sjson files in <path> if it is a directory\n"
 	             "      --port <port>                Network port to use\n"
+	             "      --metrics <path>             Write compile metrics as JSON to <path> on exit\n"
+	             "                                   and on a metrics request message\n"
 	             "      --debug                      Enable debug output\n"
 	             "      --help                       Display this help message\n"
 	             "      --                           Stop processing command line arguments"
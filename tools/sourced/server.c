@@ -59,6 +59,9 @@ server_handle_dependencies(socket_t* sock, size_t msgsize);
 static int
 server_handle_read_blob(socket_t* sock, size_t msgsize);
 
+static int
+server_handle_metrics(socket_t* sock, size_t msgsize);
+
 static int
 server_broadcast_notify(socket_t** sockets, unsigned int msg, uuid_t uuid, uint64_t platform, hash_t token);
 
@@ -331,6 +334,9 @@ server_handle(socket_t* sock) {
 	case SOURCED_READ_BLOB:
 		return server_handle_read_blob(sock, msg.size);
 
+	case SOURCED_METRICS:
+		return server_handle_metrics(sock, msg.size);
+
 	case SOURCED_REVERSE_LOOKUP:
 
 	case SOURCED_IMPORT:
@@ -357,6 +363,7 @@ server_handle(socket_t* sock) {
 	case SOURCED_NOTIFY_MODIFY:
 	case SOURCED_NOTIFY_DEPENDS:
 	case SOURCED_NOTIFY_DELETE:
+	case SOURCED_METRICS_RESULT:
 	default:
 		break;
 	}
@@ -550,6 +557,16 @@ server_handle_read_blob(socket_t* sock, size_t msgsize) {
 	return 0;
 }
 
+static int
+server_handle_metrics(socket_t* sock, size_t msgsize) {
+	if (msgsize != 0)
+		return -1;
+
+	// Dump metrics on request, a long running daemon is rarely finalized
+	log_infof(HASH_RESOURCE, STRING_CONST("Perform metrics dump"));
+	return sourced_write_metrics_reply(sock, resource_metrics_write());
+}
+
 static int
 server_broadcast_notify(socket_t** sockets, unsigned int msg, uuid_t uuid, uint64_t platform, hash_t token) {
 	for (size_t isock = 0, send = array_size(sockets); isock < send; ++isock)